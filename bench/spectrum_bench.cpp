@@ -0,0 +1,648 @@
+/**
+ * SpectrumBench - microbenchmarks and accuracy checks for the SpectrumCore kernels
+ *
+ * Covers the FFT (fft::transformInPlace, fft::Plan forward and forwardReal)
+ * at 256..65536 points, window application, the EQ cascade
+ * (eq::EQProcessor::processStereo) at 32..4096 frames with 0..5 active
+ * bands, and band mapping (audio::FrameAnalyzer) at 64..2048 bands.
+ *
+ * Every kernel is first checked against a straightforward reference: a
+ * long double DFT, closed-form window definitions, a per-sample biquad
+ * cascade and a pure tone's expected band level. A failed check makes the
+ * run fail whatever the timings say.
+ *
+ * Timings are the best of several runs of a calibrated number of calls,
+ * reported as ns per call, ns per sample and million samples per second.
+ * "Sample" is the kernel's natural unit: points for FFTs and windows,
+ * stereo frames for the EQ, bands for banding. --json writes the results
+ * one per line; --baseline compares against such a file and fails when a
+ * kernel got slower than the tolerance allows.
+ */
+
+#include "eq_processor.hpp"
+#include "fft.hpp"
+#include "frame_analyzer.hpp"
+#include "perf_stats.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+namespace {
+
+constexpr long double kTwoPi = 6.283185307179586476925286766559L;
+
+// Reference DFT bins evaluated per size (all of them up to this size)
+constexpr size_t kMaxReferenceBins = 64;
+
+struct Options {
+    bool quick = false;             // Short timings (ctest)
+    std::string filter;             // Only cases whose name contains this
+    std::string jsonPath;
+    std::string baselinePath;
+    double tolerance = 0.15;        // Allowed slowdown against the baseline
+};
+
+struct Result {
+    std::string name;               // kernel/size, unique per case
+    std::string kernel;
+    std::string unit;               // What one "sample" is
+    size_t size = 0;                // Samples per call
+    int activeBands = -1;           // EQ only
+    double nsPerCall = 0.0;
+    double nsPerSample = 0.0;
+    double msamplesPerSecond = 0.0;
+};
+
+struct Check {
+    std::string name;
+    double error = 0.0;
+    double limit = 0.0;
+    bool passed = false;
+};
+
+// Keeps results alive so the optimizer cannot drop the timed work
+volatile double sink = 0.0;
+
+uint64_t nowNs() {
+    using namespace std::chrono;
+    return static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * Best time of one call over several runs
+ * @param fn Kernel invocation
+ * @param runSeconds Target length of one run
+ * @param runs Number of runs (the fastest counts)
+ * @return Nanoseconds per call
+ */
+template <typename Fn>
+double timeCall(Fn&& fn, double runSeconds, int runs) {
+    // Calibrate the calls per run on a doubling schedule
+    uint64_t targetNs = static_cast<uint64_t>(runSeconds * 1e9);
+    size_t calls = 1;
+    for (;;) {
+        uint64_t start = nowNs();
+        for (size_t i = 0; i < calls; ++i) fn();
+        uint64_t elapsed = nowNs() - start;
+        if (elapsed >= targetNs || calls >= (size_t(1) << 30)) break;
+        calls *= 2;
+    }
+
+    double best = 0.0;
+    for (int run = 0; run < runs; ++run) {
+        uint64_t start = nowNs();
+        for (size_t i = 0; i < calls; ++i) fn();
+        double perCall = static_cast<double>(nowNs() - start) / static_cast<double>(calls);
+        best = run == 0 ? perCall : (std::min)(best, perCall);
+    }
+    return best;
+}
+
+class Suite {
+public:
+    explicit Suite(const Options& options) : options_(options), rng_(1234) {}
+
+    bool selected(const std::string& name) const {
+        return options_.filter.empty() || name.find(options_.filter) != std::string::npos;
+    }
+
+    template <typename Fn>
+    void time(const std::string& kernel, size_t size, int activeBands, const char* unit, Fn&& fn) {
+        std::string name = kernel + "/" + std::to_string(size);
+        if (activeBands >= 0) name += "/" + std::to_string(activeBands);
+        if (!selected(name)) return;
+
+        Result result;
+        result.name = name;
+        result.kernel = kernel;
+        result.unit = unit;
+        result.size = size;
+        result.activeBands = activeBands;
+        result.nsPerCall = timeCall(fn, runSeconds(), runs());
+        finish(result);
+    }
+
+    // For kernels timed elsewhere (banding reads the perf::Stage::Banding mean)
+    void add(const std::string& kernel, size_t size, const char* unit, double nsPerCall) {
+        Result result;
+        result.name = kernel + "/" + std::to_string(size);
+        result.kernel = kernel;
+        result.unit = unit;
+        result.size = size;
+        result.nsPerCall = nsPerCall;
+        finish(result);
+    }
+
+    void check(const std::string& name, double error, double limit) {
+        Check check{name, error, limit, error <= limit};
+        checks_.push_back(check);
+        if (!check.passed) {
+            std::cerr << "FAILED " << name << ": error " << error << " > " << limit << "\n";
+        }
+    }
+
+    std::vector<double> noise(size_t count, double amplitude) {
+        std::uniform_real_distribution<double> dist(-amplitude, amplitude);
+        std::vector<double> samples(count);
+        for (double& s : samples) s = dist(rng_);
+        return samples;
+    }
+
+    // Length and number of timed runs per case
+    double runSeconds() const { return options_.quick ? 0.002 : 0.02; }
+    int runs() const { return options_.quick ? 3 : 5; }
+
+    const Options& options() const { return options_; }
+    const std::vector<Result>& results() const { return results_; }
+    const std::vector<Check>& checks() const { return checks_; }
+
+    bool passed() const {
+        return std::all_of(checks_.begin(), checks_.end(), [](const Check& c) { return c.passed; });
+    }
+
+private:
+    void finish(Result& result) {
+        result.nsPerSample = result.nsPerCall / static_cast<double>(result.size);
+        result.msamplesPerSecond = result.nsPerSample > 0.0 ? 1000.0 / result.nsPerSample : 0.0;
+        std::printf("  %-28s %12.1f ns/call %9.3f ns/%-6s %9.1f M/s\n", result.name.c_str(),
+                    result.nsPerCall, result.nsPerSample, result.unit.c_str(), result.msamplesPerSecond);
+        results_.push_back(result);
+    }
+
+    Options options_;
+    std::mt19937 rng_;
+    std::vector<Result> results_;
+    std::vector<Check> checks_;
+};
+
+// ============================================================================
+// Reference implementations
+// ============================================================================
+
+/**
+ * Direct DFT of selected bins in long double
+ * @param input size points
+ * @param bins Bins to evaluate
+ * @return One value per entry of bins
+ */
+std::vector<std::complex<long double>> referenceDft(const fft::Complex* input, size_t size,
+                                                    const std::vector<size_t>& bins) {
+    // exp(-2 pi i m / size) for every m; k*n is reduced modulo size, so the
+    // angles stay exact however large the product gets
+    std::vector<std::complex<long double>> roots(size);
+    for (size_t m = 0; m < size; ++m) {
+        long double angle = -kTwoPi * static_cast<long double>(m) / static_cast<long double>(size);
+        roots[m] = std::complex<long double>(std::cos(angle), std::sin(angle));
+    }
+
+    std::vector<std::complex<long double>> result;
+    result.reserve(bins.size());
+    for (size_t k : bins) {
+        std::complex<long double> sum = 0.0L;
+        for (size_t n = 0; n < size; ++n) {
+            sum += std::complex<long double>(input[n].real(), input[n].imag()) * roots[(k * n) % size];
+        }
+        result.push_back(sum);
+    }
+    return result;
+}
+
+// Every bin up to kMaxReferenceBins, otherwise a spread that includes DC and Nyquist
+std::vector<size_t> referenceBins(size_t size) {
+    std::vector<size_t> bins;
+    if (size <= kMaxReferenceBins) {
+        for (size_t k = 0; k < size; ++k) bins.push_back(k);
+        return bins;
+    }
+    for (size_t i = 0; i < kMaxReferenceBins - 2; ++i) {
+        bins.push_back(1 + i * (size - 2) / (kMaxReferenceBins - 2));
+    }
+    bins.push_back(0);
+    bins.push_back(size / 2);
+    return bins;
+}
+
+/**
+ * Largest bin error relative to the expected bin magnitude of the input
+ * (sqrt(size) times its RMS), so the limit does not depend on the size
+ */
+double dftError(const fft::Complex* output, const fft::Complex* input, size_t size,
+                const std::vector<size_t>& bins) {
+    std::vector<std::complex<long double>> reference = referenceDft(input, size, bins);
+
+    long double energy = 0.0L;
+    for (size_t n = 0; n < size; ++n) energy += std::norm(std::complex<long double>(input[n].real(), input[n].imag()));
+    long double scale = std::sqrt(energy);
+
+    long double worst = 0.0L;
+    for (size_t i = 0; i < bins.size(); ++i) {
+        std::complex<long double> value(output[bins[i]].real(), output[bins[i]].imag());
+        worst = (std::max)(worst, std::abs(value - reference[i]));
+    }
+    return scale > 0.0L ? static_cast<double>(worst / scale) : 0.0;
+}
+
+// Textbook cosine-sum definitions, evaluated in long double
+long double referenceWindow(fft::WindowType type, size_t i, size_t size) {
+    if (size < 2) return 1.0L;
+    long double x = kTwoPi * static_cast<long double>(i) / static_cast<long double>(size - 1);
+    switch (type) {
+        case fft::WindowType::Hamming:
+            return 0.54L - 0.46L * std::cos(x);
+        case fft::WindowType::Blackman:
+            return 0.42L - 0.5L * std::cos(x) + 0.08L * std::cos(2 * x);
+        case fft::WindowType::BlackmanHarris:
+            return 0.35875L - 0.48829L * std::cos(x) + 0.14128L * std::cos(2 * x) - 0.01168L * std::cos(3 * x);
+        case fft::WindowType::FlatTop:
+            return 0.21557895L - 0.41663158L * std::cos(x) + 0.277263158L * std::cos(2 * x) -
+                   0.083578947L * std::cos(3 * x) + 0.006947368L * std::cos(4 * x);
+        case fft::WindowType::Hann:
+        default:
+            return 0.5L - 0.5L * std::cos(x);
+    }
+}
+
+/**
+ * Direct Form II transposed cascade, one sample at a time in long double
+ * @param coeffs Active band coefficients
+ * @param samples One channel, filtered in place
+ */
+void referenceCascade(const std::vector<eq::BiquadCoefficients>& coeffs, std::vector<long double>& samples) {
+    for (const eq::BiquadCoefficients& c : coeffs) {
+        long double z1 = 0.0L;
+        long double z2 = 0.0L;
+        for (long double& s : samples) {
+            long double out = c.b0 * s + z1;
+            z1 = c.b1 * s - c.a1 * out + z2;
+            z2 = c.b2 * s - c.a2 * out;
+            s = out;
+        }
+    }
+}
+
+// ============================================================================
+// Suites
+// ============================================================================
+
+const size_t kFftSizes[] = {256, 512, 1024, 2048, 4096, 8192, 16384, 32768, 65536};
+const int kEqBlockSizes[] = {32, 64, 128, 256, 512, 1024, 2048, 4096};
+const size_t kBandCounts[] = {64, 128, 256, 512, 1024, 2048};
+
+void runFft(Suite& suite) {
+    std::printf("FFT\n");
+    for (size_t size : kFftSizes) {
+        std::string suffix = "/" + std::to_string(size);
+        std::vector<double> re = suite.noise(size, 1.0);
+        std::vector<double> im = suite.noise(size, 1.0);
+        fft::ComplexVector input(size);
+        for (size_t n = 0; n < size; ++n) input[n] = fft::Complex(re[n], im[n]);
+        fft::ComplexVector realInput(size);
+        for (size_t n = 0; n < size; ++n) realInput[n] = fft::Complex(re[n], 0.0);
+
+        fft::Plan plan(size);
+        std::vector<size_t> bins = referenceBins(size);
+        std::vector<size_t> realBins;
+        for (size_t k : bins) {
+            if (k < plan.numBins()) realBins.push_back(k);
+        }
+
+        // Accuracy: double precision should stay near 1e-15 per log2(size)
+        if (suite.selected("fft.transformInPlace" + suffix)) {
+            fft::ComplexVector out = input;
+            fft::transformInPlace(out);
+            suite.check("fft.transformInPlace" + suffix, dftError(out.data(), input.data(), size, bins), 1e-12);
+        }
+        if (suite.selected("fft.forward" + suffix)) {
+            fft::ComplexVector out = input;
+            plan.forward(out.data());
+            suite.check("fft.forward" + suffix, dftError(out.data(), input.data(), size, bins), 1e-12);
+        }
+        if (suite.selected("fft.forwardReal" + suffix)) {
+            fft::ComplexVector out(plan.numBins());
+            plan.forwardReal(re.data(), out.data());
+            suite.check("fft.forwardReal" + suffix, dftError(out.data(), realInput.data(), size, realBins), 1e-12);
+        }
+
+        // transformInPlace looks up a cached plan per call; the difference to
+        // forward is that lookup
+        fft::ComplexVector work = input;
+        suite.time("fft.transformInPlace", size, -1, "point", [&] {
+            std::copy(input.begin(), input.end(), work.begin());
+            fft::transformInPlace(work);
+            sink = sink + work[1].real();
+        });
+        suite.time("fft.forward", size, -1, "point", [&] {
+            std::copy(input.begin(), input.end(), work.begin());
+            plan.forward(work.data());
+            sink = sink + work[1].real();
+        });
+        fft::ComplexVector realOut(plan.numBins());
+        suite.time("fft.forwardReal", size, -1, "point", [&] {
+            plan.forwardReal(re.data(), realOut.data());
+            sink = sink + realOut[1].real();
+        });
+    }
+}
+
+void runWindows(Suite& suite) {
+    std::printf("Windows\n");
+    const fft::WindowType types[] = {fft::WindowType::Hann, fft::WindowType::Hamming, fft::WindowType::Blackman,
+                                     fft::WindowType::BlackmanHarris, fft::WindowType::FlatTop};
+    for (size_t size : kFftSizes) {
+        std::string suffix = "/" + std::to_string(size);
+        for (fft::WindowType type : types) {
+            std::string checkName = std::string("window.") + fft::windowName(type) + suffix;
+            if (suite.selected(checkName)) {
+                auto table = fft::cachedWindow(type, size);
+                long double worst = 0.0L;
+                for (size_t i = 0; i < size; ++i) {
+                    worst = (std::max)(worst, std::abs(table->coefficients[i] - referenceWindow(type, i, size)));
+                }
+                suite.check(checkName, static_cast<double>(worst), 1e-12);
+            }
+        }
+
+        // Every type is the same multiply; time the analyzers' default
+        auto hann = fft::cachedWindow(fft::WindowType::Hann, size);
+        std::vector<double> noise = suite.noise(size, 1.0);
+        std::vector<float> input(noise.begin(), noise.end());
+        std::vector<double> output(size);
+        suite.time("window.apply", size, -1, "point", [&] {
+            fft::applyWindow(*hann, input.data(), output.data());
+            sink = sink + output[size / 2];
+        });
+    }
+}
+
+// Bands 0..activeBands-1 boosted or cut, the rest at 0 dB (off)
+void configureEq(eq::EQProcessor& processor, int activeBands, double sampleRate) {
+    const double gains[eq::NUM_BANDS] = {6.0, -4.5, 3.0, -9.0, 12.0};
+    const double qs[eq::NUM_BANDS] = {0.7, 1.4, 2.0, 4.0, 0.5};
+    for (int band = 0; band < eq::NUM_BANDS; ++band) {
+        double gain = band < activeBands ? gains[band] : 0.0;
+        processor.setBand(band, gain, eq::DEFAULT_FREQUENCIES[band], qs[band]);
+    }
+    // Starts at the designed coefficients instead of ramping towards them
+    processor.setSampleRate(sampleRate);
+    processor.reset();
+}
+
+void runEq(Suite& suite) {
+    std::printf("EQ\n");
+    const double sampleRate = 48000.0;
+
+    for (int activeBands = 0; activeBands <= eq::NUM_BANDS; ++activeBands) {
+        // Accuracy: the block cascade against per-sample long double filters
+        std::string checkName = "eq.processStereo/" + std::to_string(activeBands);
+        if (suite.selected(checkName)) {
+            eq::EQProcessor processor;
+            configureEq(processor, activeBands, sampleRate);
+
+            std::vector<eq::BiquadCoefficients> coeffs;
+            for (int band = 0; band < activeBands; ++band) {
+                eq::BiquadFilter filter;
+                filter.setPeakingEQ(sampleRate, eq::DEFAULT_FREQUENCIES[band], processor.getBandGain(band),
+                                    processor.getBandQ(band));
+                coeffs.push_back(filter.getCoefficients());
+            }
+
+            const size_t frames = 4096;
+            std::vector<double> left = suite.noise(frames, 0.5);
+            std::vector<double> right = suite.noise(frames, 0.5);
+            std::vector<long double> refLeft(left.begin(), left.end());
+            std::vector<long double> refRight(right.begin(), right.end());
+            referenceCascade(coeffs, refLeft);
+            referenceCascade(coeffs, refRight);
+
+            // Odd block sizes cross the internal chunk boundaries
+            size_t done = 0;
+            for (size_t block = 1; done < frames; block = block * 3 + 1) {
+                int count = static_cast<int>((std::min)(block, frames - done));
+                processor.processStereo(left.data() + done, right.data() + done,
+                                        left.data() + done, right.data() + done, count);
+                done += count;
+            }
+
+            long double worst = 0.0L;
+            for (size_t i = 0; i < frames; ++i) {
+                worst = (std::max)(worst, std::abs(left[i] - refLeft[i]));
+                worst = (std::max)(worst, std::abs(right[i] - refRight[i]));
+            }
+            suite.check(checkName, static_cast<double>(worst), 1e-9);
+        }
+
+        for (int frames : kEqBlockSizes) {
+            eq::EQProcessor processor;
+            configureEq(processor, activeBands, sampleRate);
+
+            std::vector<double> noise = suite.noise(static_cast<size_t>(frames), 0.5);
+            std::vector<float> inL(noise.begin(), noise.end());
+            std::vector<float> inR(noise.rbegin(), noise.rend());
+            std::vector<float> outL(frames);
+            std::vector<float> outR(frames);
+            suite.time("eq.processStereo", static_cast<size_t>(frames), activeBands, "frame", [&] {
+                processor.processStereo(inL.data(), inR.data(), outL.data(), outR.data(), frames);
+                sink = sink + outL[0];
+            });
+        }
+    }
+}
+
+void runBanding(Suite& suite) {
+    std::printf("Banding\n");
+    const uint32_t sampleRate = 48000;
+
+    for (size_t numBands : kBandCounts) {
+        std::string name = "banding/" + std::to_string(numBands);
+        if (!suite.selected(name)) continue;
+
+        audio::AnalyzerConfig config;
+        config.fftSize = 16384;
+        config.numBands = numBands;
+
+        audio::FrameAnalyzer analyzer;
+        analyzer.configure(config, sampleRate);
+        std::vector<double> bands(analyzer.numBands());
+        audio::FrameStats stats;
+
+        // Accuracy: a 0 dBFS tone on a bin reads at the Hann-calibrated
+        // level (half its amplitude, a quarter of its power) in the band around it
+        const double binWidth = static_cast<double>(sampleRate) / config.fftSize;
+        const double frequency = std::round(1000.0 / binWidth) * binWidth;
+        std::vector<float> tone(config.fftSize);
+        for (size_t n = 0; n < tone.size(); ++n) {
+            tone[n] = static_cast<float>(std::sin(2.0 * M_PI * frequency * n / sampleRate));
+        }
+        analyzer.analyze(tone.data(), bands.data(), stats);
+
+        size_t loudest = static_cast<size_t>(std::max_element(bands.begin(), bands.end()) - bands.begin());
+        double levelError = std::abs(10.0 * std::log10((std::max)(bands[loudest], 1e-24) / 0.25));
+        double bandError = std::abs(std::log2(analyzer.bandFrequencies()[loudest] / frequency));
+        suite.check(name + " level_db", levelError, 0.5);
+        suite.check(name + " frequency_octaves", bandError, 0.1);
+
+        // Banding alone is timed by FrameAnalyzer itself; use the mean of
+        // perf::Stage::Banding over the calls made here
+        std::vector<double> noise = suite.noise(config.fftSize, 0.5);
+        std::vector<float> input(noise.begin(), noise.end());
+        analyzer.setTimed(true);
+        perf::update(0.0);
+        perf::update(0.0);
+        double frameNs = timeCall([&] {
+            analyzer.analyze(input.data(), bands.data(), stats);
+            sink = sink + bands[0];
+        }, suite.runSeconds(), suite.runs());
+        perf::update(0.0);
+        analyzer.setTimed(false);
+
+        suite.add("analysis.frame", numBands, "band", frameNs);
+        suite.add("banding", numBands, "band", perf::snapshot().stage(perf::Stage::Banding).meanUs * 1000.0);
+    }
+}
+
+// ============================================================================
+// Output and baseline
+// ============================================================================
+
+bool writeJson(const Suite& suite, const std::string& path) {
+    std::ofstream file(path);
+    if (!file) return false;
+
+    // One result per line, so baselines can be read back line by line
+    file << "{\"benchmark\":\"SpectrumBench\",\"version\":1,\"results\":[\n";
+    const std::vector<Result>& results = suite.results();
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        file << "{\"name\":\"" << r.name << "\",\"kernel\":\"" << r.kernel << "\",\"unit\":\"" << r.unit
+             << "\",\"size\":" << r.size;
+        if (r.activeBands >= 0) file << ",\"active_bands\":" << r.activeBands;
+        file << ",\"ns_per_call\":" << r.nsPerCall << ",\"ns_per_sample\":" << r.nsPerSample
+             << ",\"msamples_per_s\":" << r.msamplesPerSecond << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    file << "],\"accuracy\":[\n";
+    const std::vector<Check>& checks = suite.checks();
+    for (size_t i = 0; i < checks.size(); ++i) {
+        const Check& c = checks[i];
+        file << "{\"check\":\"" << c.name << "\",\"error\":" << c.error << ",\"limit\":" << c.limit
+             << ",\"passed\":" << (c.passed ? "true" : "false") << "}" << (i + 1 < checks.size() ? "," : "") << "\n";
+    }
+    file << "]}\n";
+    return static_cast<bool>(file);
+}
+
+// Read ns_per_sample by name from a file written by writeJson
+bool readBaseline(const std::string& path, std::map<std::string, double>& baseline) {
+    std::ifstream file(path);
+    if (!file) return false;
+
+    const std::string nameKey = "\"name\":\"";
+    const std::string valueKey = "\"ns_per_sample\":";
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t name = line.find(nameKey);
+        size_t value = line.find(valueKey);
+        if (name == std::string::npos || value == std::string::npos) continue;
+
+        name += nameKey.size();
+        size_t nameEnd = line.find('"', name);
+        if (nameEnd == std::string::npos) continue;
+        baseline[line.substr(name, nameEnd - name)] = std::atof(line.c_str() + value + valueKey.size());
+    }
+    return true;
+}
+
+/**
+ * Print every kernel against the baseline
+ * @return Number of kernels slower than the tolerance allows
+ */
+size_t compareBaseline(const Suite& suite, const std::map<std::string, double>& baseline) {
+    std::printf("\nAgainst baseline (tolerance %.0f%%)\n", suite.options().tolerance * 100.0);
+    size_t regressions = 0;
+    for (const Result& r : suite.results()) {
+        auto it = baseline.find(r.name);
+        if (it == baseline.end() || it->second <= 0.0) {
+            std::printf("  %-28s %9.3f ns/%-6s (new)\n", r.name.c_str(), r.nsPerSample, r.unit.c_str());
+            continue;
+        }
+        double ratio = r.nsPerSample / it->second;
+        bool regressed = ratio > 1.0 + suite.options().tolerance;
+        regressions += regressed ? 1 : 0;
+        std::printf("  %-28s %9.3f vs %9.3f ns/%-6s %+6.1f%%%s\n", r.name.c_str(), r.nsPerSample, it->second,
+                    r.unit.c_str(), (ratio - 1.0) * 100.0, regressed ? "  REGRESSION" : "");
+    }
+    return regressions;
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --quick              Short timings (what ctest runs)\n"
+              << "  --filter <text>      Only cases whose name contains text (e.g. fft.forward, eq, banding/256)\n"
+              << "  --json <file>        Write results and accuracy checks as JSON\n"
+              << "  --baseline <file>    Compare against a previous --json file\n"
+              << "  --tolerance <frac>   Allowed slowdown against the baseline (default 0.15)\n";
+}
+
+} // namespace
+
+} // namespace bench
+
+int main(int argc, char* argv[]) {
+    bench::Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--quick") {
+            options.quick = true;
+        } else if (arg == "--filter" && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else if (arg == "--json" && i + 1 < argc) {
+            options.jsonPath = argv[++i];
+        } else if (arg == "--baseline" && i + 1 < argc) {
+            options.baselinePath = argv[++i];
+        } else if (arg == "--tolerance" && i + 1 < argc) {
+            options.tolerance = (std::max)(0.0, std::atof(argv[++i]));
+        } else {
+            bench::printUsage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+
+    // Read the baseline first so a bad path fails before the long part
+    std::map<std::string, double> baseline;
+    if (!options.baselinePath.empty() && !bench::readBaseline(options.baselinePath, baseline)) {
+        std::cerr << "Failed to read baseline: " << options.baselinePath << "\n";
+        return 1;
+    }
+
+    bench::Suite suite(options);
+    bench::runFft(suite);
+    bench::runWindows(suite);
+    bench::runEq(suite);
+    bench::runBanding(suite);
+
+    size_t failed = static_cast<size_t>(std::count_if(suite.checks().begin(), suite.checks().end(),
+                                                      [](const bench::Check& c) { return !c.passed; }));
+    std::printf("\nAccuracy: %zu of %zu checks passed\n", suite.checks().size() - failed, suite.checks().size());
+
+    if (!options.jsonPath.empty() && !bench::writeJson(suite, options.jsonPath)) {
+        std::cerr << "Failed to write results: " << options.jsonPath << "\n";
+        return 1;
+    }
+
+    size_t regressions = 0;
+    if (!options.baselinePath.empty()) {
+        regressions = bench::compareBaseline(suite, baseline);
+        std::printf("%zu regression(s)\n", regressions);
+    }
+
+    return suite.passed() && regressions == 0 ? 0 : 1;
+}
@@ -0,0 +1,54 @@
+#include "analysis_worker.hpp"
+#include "perf_stats.hpp"
+
+namespace rt {
+
+AnalysisWorker::~AnalysisWorker() {
+    stop();
+}
+
+void AnalysisWorker::start(std::function<void()> task, std::chrono::milliseconds interval) {
+    stop();
+
+    task_ = std::move(task);
+    interval_ = interval;
+    wakeRequested_ = false;
+    running_.store(true);
+    thread_ = std::thread(&AnalysisWorker::run, this);
+}
+
+void AnalysisWorker::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_.store(false);
+    }
+    cv_.notify_one();
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void AnalysisWorker::wake() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        wakeRequested_ = true;
+    }
+    cv_.notify_one();
+}
+
+void AnalysisWorker::run() {
+    perf::registerThread();
+
+    while (running_.load()) {
+        task_();
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait_for(lock, interval_, [this] { return wakeRequested_ || !running_.load(); });
+        wakeRequested_ = false;
+    }
+
+    perf::releaseThread();
+}
+
+} // namespace rt
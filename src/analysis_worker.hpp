@@ -0,0 +1,62 @@
+#pragma once
+
+/**
+ * Background analysis thread
+ *
+ * Runs a task repeatedly off the audio thread. The task is expected to drain
+ * whatever the audio thread pushed (e.g. through an SpscRing) and return.
+ * The audio thread never signals the worker - it polls at a fixed interval
+ * so the realtime side stays free of locks and syscalls.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace rt {
+
+class AnalysisWorker {
+public:
+    AnalysisWorker() = default;
+    ~AnalysisWorker();
+
+    AnalysisWorker(const AnalysisWorker&) = delete;
+    AnalysisWorker& operator=(const AnalysisWorker&) = delete;
+
+    /**
+     * Start the thread (stops a previously running one first)
+     * @param task Work to run on each wake-up
+     * @param interval Maximum time between runs
+     */
+    void start(std::function<void()> task,
+               std::chrono::milliseconds interval = std::chrono::milliseconds(5));
+
+    /**
+     * Stop and join the thread. Safe to call when not running.
+     */
+    void stop();
+
+    /**
+     * Run the task as soon as possible (non-realtime callers only)
+     */
+    void wake();
+
+    bool isRunning() const { return running_.load(); }
+
+private:
+    void run();
+
+    std::thread thread_;
+    std::function<void()> task_;
+    std::chrono::milliseconds interval_{5};
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool wakeRequested_ = false;
+    std::atomic<bool> running_{false};
+};
+
+} // namespace rt
@@ -13,9 +13,17 @@
 
 #include "audio_analyzer.hpp"
 #include "fft.hpp"
+#include "frame_analyzer.hpp"
+#include "spectrogram_cache.hpp"
+#include "spsc_ring.hpp"
+#include "history_ring.hpp"
+#include "analysis_worker.hpp"
+#include "triple_buffer.hpp"
+#include "perf_stats.hpp"
 #include <cmath>
 #include <algorithm>
 #include <stdexcept>
+#include <chrono>
 
 // Use std:: versions explicitly to avoid Windows macro conflicts
 using std::min;
@@ -23,71 +31,29 @@ using std::max;
 
 namespace audio {
 
-// Forward declaration
-class AudioAnalyzer;
+// Decoded PCM handed from the decoder thread to the device callback
+struct PcmBlock {
+    static constexpr size_t kFrames = 512;
+    static constexpr size_t kMaxChannels = 2;   // Decoder is configured for stereo
+    
+    uint64_t generation = 0;    // Seek generation the block was decoded in
+    uint64_t startFrame = 0;    // Stream position of the first frame
+    uint32_t frames = 0;
+    bool endOfStream = false;
+    float samples[kFrames * kMaxChannels];
+};
 
-constexpr double PI = 3.14159265358979323846;
+// One left/right sample pair queued for analysis
+struct StereoFrame {
+    float left;
+    float right;
+};
 
-// Biquad filter for EQ
-struct BiquadFilter {
-    double b0, b1, b2;  // Feedforward coefficients
-    double a1, a2;      // Feedback coefficients
-    
-    // Filter state (per channel)
-    double x1[2] = {0, 0};
-    double x2[2] = {0, 0};
-    double y1[2] = {0, 0};
-    double y2[2] = {0, 0};
-    
-    void reset() {
-        for (int i = 0; i < 2; ++i) {
-            x1[i] = x2[i] = y1[i] = y2[i] = 0.0;
-        }
-    }
-    
-    // Calculate peaking EQ coefficients (peakingEQ from Audio EQ Cookbook)
-    void setPeakingEQ(double sampleRate, double freq, double gainDb, double q) {
-        // Clamp frequency to valid range
-        freq = (std::max)(20.0, (std::min)(freq, sampleRate * 0.45));
-        q = (std::max)(0.1, (std::min)(q, 10.0));
-        
-        double A = std::pow(10.0, gainDb / 40.0);  // Square root of linear gain
-        double w0 = 2.0 * PI * freq / sampleRate;
-        double cosw0 = std::cos(w0);
-        double sinw0 = std::sin(w0);
-        double alpha = sinw0 / (2.0 * q);
-        
-        double a0;
-        // Standard peaking EQ formula
-        b0 = 1.0 + alpha * A;
-        b1 = -2.0 * cosw0;
-        b2 = 1.0 - alpha * A;
-        a0 = 1.0 + alpha / A;
-        a1 = -2.0 * cosw0;
-        a2 = 1.0 - alpha / A;
-        
-        // Normalize by a0
-        b0 /= a0;
-        b1 /= a0;
-        b2 /= a0;
-        a1 /= a0;
-        a2 /= a0;
-    }
-    
-    // Process a single sample
-    float process(float input, int channel) {
-        double x0 = static_cast<double>(input);
-        double y0 = b0 * x0 + b1 * x1[channel] + b2 * x2[channel]
-                  - a1 * y1[channel] - a2 * y2[channel];
-        
-        // Shift state
-        x2[channel] = x1[channel];
-        x1[channel] = x0;
-        y2[channel] = y1[channel];
-        y1[channel] = y0;
-        
-        return static_cast<float>(y0);
-    }
+// Queued frames from analysis clock position `clock` on were played from
+// stream position `streamFrame` on (until the next marker)
+struct StreamMarker {
+    uint64_t clock = 0;
+    uint64_t streamFrame = 0;
 };
 
 // Implementation structure (defined before callback)
@@ -106,40 +72,277 @@ struct AudioAnalyzerImpl {
     uint64_t totalFrames = 0;
     std::atomic<uint64_t> currentFrame{0};
     
+    // Decoder thread -> device callback. Only the decoder thread touches
+    // the ma_decoder while a file is loaded; seeks are posted to it.
+    static constexpr size_t kPrefetchBlocks = 128;   // ~1.5 s at 44.1 kHz
+    rt::SpscRing<PcmBlock> pcmQueue;
+    rt::AnalysisWorker decodeWorker;
+    std::atomic<int64_t> pendingSeek{-1};
+    std::atomic<uint64_t> decodeGeneration{0};
+    uint64_t decodeFrame = 0;         // Decoder thread only
+    bool decoderAtEnd = false;        // Decoder thread only
+    PcmBlock decodeScratch;           // Decoder thread only
+    PcmBlock playBlock;               // Device callback only
+    uint32_t playBlockPos = 0;        // Device callback only
+    
     float volume = 1.0f;
     
     AnalyzerConfig config;
     SpectrumData currentSpectrum;
     
-    // Circular buffer for audio samples
-    std::vector<float> sampleBuffer;
-    size_t bufferWritePos = 0;
-    std::mutex bufferMutex;
-    
-    // Smoothed spectrum
-    std::vector<double> smoothedMagnitudes;
-    
-    // Band frequencies
-    std::vector<double> bandFrequencies;
-    std::vector<std::pair<size_t, size_t>> bandBins;
+    // Audio thread -> analysis worker (left/right frames, fixed capacity so
+    // the producer side never needs to be paused for a resize)
+    static constexpr size_t kSampleQueueSize = 1 << 16;
+    rt::SpscRing<StereoFrame> sampleQueue{kSampleQueueSize};
+    rt::AnalysisWorker worker;
+    std::atomic<bool> resetRequested{false};
+    
+    // Analysis clock: frames queued so far (audio thread) and frames taken
+    // off the queue so far (worker). Monotonic, unlike currentFrame, which
+    // jumps on seeks; published spectra are stamped with it.
+    std::atomic<uint64_t> analysisClock{0};
+    uint64_t analyzedFrames = 0;
+    
+    // Audio thread -> worker: where queued frames sit in the stream, one
+    // marker per callback plus one per discontinuity (seek, rewind), so the
+    // cached analysis is read at the drained samples, not at the playhead
+    static constexpr size_t kMarkerQueueSize = 1024;
+    rt::SpscRing<StreamMarker> streamMarkers{kMarkerQueueSize};
+    StreamMarker drainMarker;           // Worker: applies to the newest drained frame
+    StreamMarker nextMarker;            // Worker: read ahead, not reached yet
+    bool hasNextMarker = false;
+    uint64_t drainedStreamFrame = 0;    // Worker: stream position just past the newest drained frame
+    
+    // Catch up with the markers after draining (worker); consumes them even
+    // while the cache is unused, so the queue never fills
+    void advanceStreamPosition() {
+        for (;;) {
+            if (!hasNextMarker) {
+                hasNextMarker = streamMarkers.read(&nextMarker, 1) == 1;
+                if (!hasNextMarker) break;
+            }
+            if (nextMarker.clock >= analyzedFrames) break;
+            drainMarker = nextMarker;
+            hasNextMarker = false;
+        }
+        drainedStreamFrame = drainMarker.streamFrame +
+                             (analyzedFrames - (std::min)(drainMarker.clock, analyzedFrames));
+    }
     
-    // Equalizer
+    // Sample history, one ring per channel (owned by the analysis worker)
+    rt::HistoryRing<float> historyLeft;
+    rt::HistoryRing<float> historyRight;
+    std::vector<StereoFrame> drainBuffer;
+    std::vector<float> drainLeft;
+    std::vector<float> drainRight;
+    
+    // Samples written since the last FFT; analysis runs once per hop
+    size_t samplesSinceAnalysis = 0;
+    
+    // Latest result handed to the render thread (wait-free, single producer:
+    // the analysis worker, or the UI thread while the worker is stopped)
+    rt::TripleBuffer<SpectrumData> publishedSpectra;
+    uint64_t publishSequence = 0;
+    
+    // Render thread: the two latest frames and their blend
+    SpectrumData previousFrame;
+    SpectrumData latestFrame;
+    SpectrumData displaySpectrum;
+    uint64_t displayClock = 0;
+    std::chrono::steady_clock::time_point displayClockTime;
+    
+    // Smoothed band power
+    std::vector<double> smoothedPower;
+    std::array<std::vector<double>, kNumChannels> smoothedChannels;
+    
+    // Window, FFT and band mapping (owned by the analysis worker)
+    FrameAnalyzer frameAnalyzer;
+    std::vector<float> frameLeft;
+    std::vector<float> frameRight;
+    std::vector<float> frameSamples;    // Mono mix
+    std::vector<double> frameBands;     // Band power
+    std::array<std::vector<double>, kNumChannels> channelBands;
+    
+    // Precomputed analysis of the loaded file (owned by the analysis worker).
+    // Used instead of live FFTs while the EQ is flat, since cached frames
+    // analyze the file before EQ.
+    SpectrogramCache spectrogramCache;
+    SpectrogramReader cachedAnalysis;
+    SourceInfo source;
+    std::atomic<bool> eqFlat{true};
+    
+    // Equalizer: parameters and coefficient design live on the UI thread,
+    // the audio thread only picks up finished coefficient sets
     EqualizerConfig eqConfig;
-    BiquadFilter eqFilters[EqualizerConfig::NUM_BANDS];
-    std::atomic<bool> eqNeedsUpdate{false};
+    eq::EQProcessor eqDesign;
+    eq::EQProcessor eqEngine;
+    rt::TripleBuffer<eq::CoefficientSet> eqCoefficients;
     
     AudioAnalyzer* parent = nullptr;
     
-    void updateEQFilters() {
-        for (int i = 0; i < EqualizerConfig::NUM_BANDS; ++i) {
-            eqFilters[i].setPeakingEQ(
-                sampleRate,
-                eqConfig.bands[i].frequency,
-                eqConfig.bands[i].gain,
-                eqConfig.bands[i].q
-            );
+    // Post a seek to the decoder thread (any thread)
+    void requestSeek(uint64_t frame) {
+        pendingSeek.store(static_cast<int64_t>(frame));
+        currentFrame = frame;
+    }
+    
+    // Decoder thread: apply a posted seek, then read ahead until the ring is
+    // full. A seek posted meanwhile stops the read-ahead and is applied at
+    // once, so seek latency is one block of decoding rather than a ring.
+    void decodeAhead() {
+        do {
+            applyPendingSeek();
+            
+            uint64_t generation = decodeGeneration.load();
+            
+            while (!decoderAtEnd && pcmQueue.writeAvailable() > 0 && pendingSeek.load() < 0) {
+                perf::ScopedTimer timer(perf::Stage::Decode);
+                ma_uint64 framesRead = 0;
+                ma_decoder_read_pcm_frames(&decoder, decodeScratch.samples, PcmBlock::kFrames, &framesRead);
+                
+                decodeScratch.generation = generation;
+                decodeScratch.startFrame = decodeFrame;
+                decodeScratch.frames = static_cast<uint32_t>(framesRead);
+                decodeScratch.endOfStream = framesRead < PcmBlock::kFrames;
+                decodeFrame += framesRead;
+                decoderAtEnd = decodeScratch.endOfStream;
+                
+                pcmQueue.write(&decodeScratch, 1);
+            }
+        } while (pendingSeek.load() >= 0);
+    }
+    
+    // Decoder thread: move the decoder to a posted seek target, if any
+    void applyPendingSeek() {
+        int64_t seekTo = pendingSeek.load();
+        if (seekTo < 0) return;
+        
+        ma_decoder_seek_to_pcm_frame(&decoder, static_cast<ma_uint64>(seekTo));
+        decodeFrame = static_cast<uint64_t>(seekTo);
+        decoderAtEnd = false;
+        
+        // Blocks already queued are from before the seek; the callback
+        // drops anything tagged with an older generation
+        decodeGeneration.fetch_add(1);
+        
+        // Clear the request unless a newer seek arrived meanwhile
+        pendingSeek.compare_exchange_strong(seekTo, -1);
+    }
+    
+    // Blend fresh band power into a smoothed spectrum, then convert each band
+    // once: to dB (10*log10) for the renderers and to the linear amplitude
+    // the bar views scale (analysis worker)
+    void smoothBands(const std::vector<double>& bandPower, std::vector<double>& smoothed,
+                     std::vector<double>& magnitudes, std::vector<float>& magnitudesDb) {
+        double smoothing = config.smoothingFactor;
+        for (size_t band = 0; band < config.numBands; ++band) {
+            smoothed[band] = smoothing * smoothed[band] + (1.0 - smoothing) * bandPower[band];
+            magnitudes[band] = std::sqrt(smoothed[band]);
+        }
+        fft::powerToDb(smoothed.data(), config.numBands, SpectrumData::kFloorDb, magnitudesDb.data());
+    }
+    
+    void smoothFrameBands() {
+        smoothBands(frameBands, smoothedPower, currentSpectrum.magnitudes, currentSpectrum.magnitudesDb);
+    }
+    
+    // Size history and results for the current config (worker stopped)
+    void allocateAnalysis() {
+        historyLeft.reset(config.fftSize);
+        historyRight.reset(config.fftSize);
+        drainBuffer.resize(config.fftSize, StereoFrame{0.0f, 0.0f});
+        drainLeft.resize(config.fftSize, 0.0f);
+        drainRight.resize(config.fftSize, 0.0f);
+        smoothedPower.resize(config.numBands, 0.0);
+        currentSpectrum.magnitudes.resize(config.numBands, 0.0);
+        currentSpectrum.magnitudesDb.resize(config.numBands, SpectrumData::kFloorDb);
+        currentSpectrum.frequencies.resize(config.numBands, 0.0);
+        
+        // Channel results exist only while stereo analysis is on
+        size_t channelBandCount = config.stereo ? config.numBands : 0;
+        for (size_t c = 0; c < kNumChannels; ++c) {
+            SpectrumData::ChannelSpectrum& channel = currentSpectrum.channels[c];
+            smoothedChannels[c].resize(channelBandCount, 0.0);
+            channel.magnitudes.resize(channelBandCount, 0.0);
+            channel.magnitudesDb.resize(channelBandCount, SpectrumData::kFloorDb);
+        }
+    }
+    
+    // Drop all analysis history (analysis worker)
+    void clearSpectrum() {
+        historyLeft.clear();
+        historyRight.clear();
+        std::fill(smoothedPower.begin(), smoothedPower.end(), 0.0);
+        clearMagnitudes(currentSpectrum);
+        for (std::vector<double>& smoothed : smoothedChannels) {
+            std::fill(smoothed.begin(), smoothed.end(), 0.0);
+        }
+    }
+    
+    static void clearMagnitudes(SpectrumData& spectrum) {
+        std::fill(spectrum.magnitudes.begin(), spectrum.magnitudes.end(), 0.0);
+        std::fill(spectrum.magnitudesDb.begin(), spectrum.magnitudesDb.end(), SpectrumData::kFloorDb);
+        for (SpectrumData::ChannelSpectrum& channel : spectrum.channels) {
+            std::fill(channel.magnitudes.begin(), channel.magnitudes.end(), 0.0);
+            std::fill(channel.magnitudesDb.begin(), channel.magnitudesDb.end(), SpectrumData::kFloorDb);
+        }
+    }
+
+    // Per-frame fields of a spectrum; vectors keep their capacity, so once
+    // sizes settle this does not allocate. Frequencies move only on layout
+    // changes.
+    static void copyFrame(const SpectrumData& from, SpectrumData& to) {
+        to.magnitudes = from.magnitudes;
+        to.magnitudesDb = from.magnitudesDb;
+        if (to.layoutVersion != from.layoutVersion) {
+            to.frequencies = from.frequencies;
+            to.layoutVersion = from.layoutVersion;
+        }
+        to.peakFrequency = from.peakFrequency;
+        to.rmsLevel = from.rmsLevel;
+        to.peakLevel = from.peakLevel;
+        to.channels = from.channels;
+        to.timestamp = from.timestamp;
+        to.sequence = from.sequence;
+    }
+    
+    // Copy into the free slot and hand it to the render thread
+    void publishSpectrum() {
+        SpectrumData& slot = publishedSpectra.writeBuffer();
+        copyFrame(currentSpectrum, slot);
+        slot.sequence = ++publishSequence;
+        publishedSpectra.publish();
+    }
+    
+    // Redesign one band from eqConfig (UI thread); one setBand call designs
+    // the biquad once for all three parameters
+    void designEQBand(int band) {
+        const EQBand& b = eqConfig.bands[band];
+        eqDesign.setBand(band, b.enabled ? b.gain : 0.0, b.frequency, b.q);
+    }
+    
+    // Hand the designed coefficients to the audio thread (UI thread)
+    void publishEQ() {
+        eqDesign.setBypass(!eqConfig.enabled);
+        eqCoefficients.writeBuffer() = eqDesign.getCoefficientSet();
+        eqCoefficients.publish();
+        
+        bool flat = true;
+        for (const EQBand& band : eqConfig.bands) {
+            flat = flat && (!band.enabled || band.gain == 0.0);
+        }
+        eqFlat = flat || !eqConfig.enabled;
+    }
+    
+    // Look up a cached analysis for the loaded file and current settings
+    // (worker stopped)
+    void openCachedAnalysis() {
+        cachedAnalysis.close();
+        if (fileLoaded) {
+            source.sampleRate = sampleRate;
+            source.channels = channels;
+            spectrogramCache.open(source, config, cachedAnalysis);
         }
-        eqNeedsUpdate = false;
     }
 };
 
@@ -148,10 +351,13 @@ static void audioCallback(ma_device* pDevice, void* pOutput, const void* pInput,
 
 AudioAnalyzer::AudioAnalyzer() : pImpl(std::make_unique<AudioAnalyzerImpl>()) {
     pImpl->parent = this;
+    pImpl->frameAnalyzer.setTimed(true);
 }
 
 AudioAnalyzer::~AudioAnalyzer() {
     stop();
+    pImpl->worker.stop();
+    pImpl->decodeWorker.stop();
     
     if (pImpl->fileLoaded) {
         ma_device_uninit(&pImpl->device);
@@ -162,21 +368,21 @@ AudioAnalyzer::~AudioAnalyzer() {
 bool AudioAnalyzer::initialize() {
     pImpl->initialized = true;
     
-    // Initialize sample buffer
-    pImpl->sampleBuffer.resize(pImpl->config.fftSize * 2, 0.0f);
-    pImpl->smoothedMagnitudes.resize(pImpl->config.numBands, 0.0);
-    
-    // Initialize spectrum data
-    pImpl->currentSpectrum.magnitudes.resize(pImpl->config.numBands, 0.0);
-    pImpl->currentSpectrum.frequencies.resize(pImpl->config.numBands, 0.0);
+    // Initialize sample history and spectrum data
+    pImpl->allocateAnalysis();
     
     updateBands();
+    pImpl->publishSpectrum();
+    
+    startAnalysis();
     
     return true;
 }
 
 static void audioCallback(ma_device* pDevice, void* pOutput, const void* pInput, ma_uint32 frameCount) {
     AudioAnalyzerImpl* impl = static_cast<AudioAnalyzerImpl*>(pDevice->pUserData);
+    perf::ScopedTimer timer(perf::Stage::AudioCallback);
+    perf::setAudioPeriod(frameCount, pDevice->sampleRate);
     
     if (!impl || !impl->playing) {
         // Output silence
@@ -184,48 +390,96 @@ static void audioCallback(ma_device* pDevice, void* pOutput, const void* pInput,
         return;
     }
     
-    ma_uint64 framesRead;
-    ma_decoder_read_pcm_frames(&impl->decoder, pOutput, frameCount, &framesRead);
+    float* output = static_cast<float*>(pOutput);
+    uint32_t channels = pDevice->playback.channels;
     
-    if (framesRead < frameCount) {
-        // End of file reached
-        impl->playing = false;
-        ma_decoder_seek_to_pcm_frame(&impl->decoder, 0);
-        impl->currentFrame = 0;
+    // Copy prefetched PCM; decoding and file I/O happen on the decoder thread
+    size_t framesRead = 0;
+    bool endOfStream = false;
+    
+    // Everything decoded so far predates a seek the decoder hasn't applied
+    // yet, so play silence until its blocks arrive. Read before the
+    // generation: the decoder bumps that before clearing the request.
+    bool seekPending = impl->pendingSeek.load() >= 0;
+    uint64_t generation = impl->decodeGeneration.load();
+    
+    // Where this callback's frames come from in the stream; a new marker
+    // wherever the next frame isn't the continuation of the previous one
+    constexpr size_t kMaxMarkers = 4;
+    StreamMarker markers[kMaxMarkers];
+    size_t numMarkers = 0;
+    uint64_t nextStreamFrame = 0;
+    
+    while (framesRead < frameCount && !seekPending) {
+        PcmBlock& block = impl->playBlock;
+        
+        // The rest of a partly played block is stale once a seek was applied
+        if (block.generation < generation) {
+            block.frames = 0;
+            block.endOfStream = false;
+        }
+        
+        if (impl->playBlockPos >= block.frames) {
+            if (block.endOfStream && block.generation == generation) {
+                endOfStream = true;
+                break;
+            }
+            if (impl->pcmQueue.read(&block, 1) == 0) {
+                break;  // Underrun: decoder hasn't caught up
+            }
+            impl->playBlockPos = 0;
+            if (block.generation > generation) {
+                // A seek landed during this callback; its blocks are current
+                generation = impl->decodeGeneration.load();
+            }
+            if (block.generation < generation) {
+                block.frames = 0;   // Decoded before a seek, drop it
+                block.endOfStream = false;
+                continue;
+            }
+        }
         
-        // Fill remaining with silence
-        float* output = static_cast<float*>(pOutput);
-        for (size_t i = framesRead * pDevice->playback.channels; 
-             i < frameCount * pDevice->playback.channels; ++i) {
-            output[i] = 0.0f;
+        size_t count = (std::min)(static_cast<size_t>(block.frames - impl->playBlockPos),
+                                  static_cast<size_t>(frameCount) - framesRead);
+        uint64_t streamFrame = block.startFrame + impl->playBlockPos;
+        if ((numMarkers == 0 || streamFrame != nextStreamFrame) && numMarkers < kMaxMarkers) {
+            markers[numMarkers++] = StreamMarker{framesRead, streamFrame};   // Clock offset for now
         }
+        nextStreamFrame = streamFrame + count;
+        std::copy(block.samples + impl->playBlockPos * channels,
+                  block.samples + (impl->playBlockPos + count) * channels,
+                  output + framesRead * channels);
+        impl->playBlockPos += static_cast<uint32_t>(count);
+        framesRead += count;
     }
     
-    float* output = static_cast<float*>(pOutput);
-    uint32_t channels = pDevice->playback.channels;
+    // Report the position of what was just played, unless a seek is still
+    // on its way to the decoder (the UI already shows the seek target)
+    if (impl->playBlock.generation == generation && impl->pendingSeek.load() < 0) {
+        impl->currentFrame = impl->playBlock.startFrame + impl->playBlockPos;
+    }
+    
+    // Fill remaining with silence
+    std::fill(output + framesRead * channels, output + static_cast<size_t>(frameCount) * channels, 0.0f);
     
-    // Update EQ filters if needed
-    if (impl->eqNeedsUpdate) {
-        impl->updateEQFilters();
+    if (endOfStream) {
+        // End of file reached: rewind for the next play
+        impl->playing = false;
+        impl->playBlock.frames = 0;
+        impl->playBlock.endOfStream = false;
+        impl->requestSeek(0);
+    }
+    
+    // Pick up new EQ coefficients (designed on the UI thread); the engine
+    // ramps to them over the first kRampFrames frames
+    if (impl->eqCoefficients.update()) {
+        impl->eqEngine.setTargetCoefficients(impl->eqCoefficients.readBuffer());
     }
     
     // Apply EQ processing
-    if (impl->eqConfig.enabled) {
-        for (size_t frame = 0; frame < framesRead; ++frame) {
-            for (uint32_t ch = 0; ch < channels && ch < 2; ++ch) {
-                float sample = output[frame * channels + ch];
-                
-                // Apply each EQ band in series
-                for (int band = 0; band < EqualizerConfig::NUM_BANDS; ++band) {
-                    if (impl->eqConfig.bands[band].enabled && 
-                        std::abs(impl->eqConfig.bands[band].gain) > 0.01) {
-                        sample = impl->eqFilters[band].process(sample, ch);
-                    }
-                }
-                
-                output[frame * channels + ch] = sample;
-            }
-        }
+    {
+        perf::ScopedTimer eqTimer(perf::Stage::Equalizer);
+        impl->eqEngine.processBlock(output, static_cast<int>(framesRead), static_cast<int>(channels));
     }
     
     // Apply volume
@@ -233,11 +487,23 @@ static void audioCallback(ma_device* pDevice, void* pOutput, const void* pInput,
         output[i] *= impl->volume;
     }
     
-    // Update current frame position
-    impl->currentFrame += framesRead;
-    
     // Copy samples to analysis buffer
+    uint64_t clockBefore = impl->analysisClock.load(std::memory_order_relaxed);
     impl->parent->processAudioData(output, framesRead, channels);
+    uint64_t queued = impl->analysisClock.load(std::memory_order_relaxed) - clockBefore;
+    
+    // Then place them on the analysis clock. Markers for frames the queue
+    // dropped are skipped. A worker that drained ahead of a marker applies it
+    // retroactively; until then it extrapolates from the previous one.
+    size_t numQueuedMarkers = 0;
+    for (size_t m = 0; m < numMarkers; ++m) {
+        if (markers[m].clock < queued) {
+            markers[numQueuedMarkers] = markers[m];
+            markers[numQueuedMarkers].clock += clockBefore;
+            ++numQueuedMarkers;
+        }
+    }
+    impl->streamMarkers.write(markers, numQueuedMarkers);
     
     (void)pInput; // Unused
 }
@@ -246,18 +512,24 @@ bool AudioAnalyzer::loadFile(const std::string& filepath) {
     // Stop any current playback
     stop();
     
+    // Band layout and sample rate are read by the worker
+    pImpl->worker.stop();
+    pImpl->decodeWorker.stop();
+    
     // Uninitialize previous decoder/device if loaded
     if (pImpl->fileLoaded) {
         ma_device_uninit(&pImpl->device);
         ma_decoder_uninit(&pImpl->decoder);
         pImpl->fileLoaded = false;
     }
+    pImpl->cachedAnalysis.close();
     
     // Initialize decoder
     ma_decoder_config decoderConfig = ma_decoder_config_init(ma_format_f32, 2, 44100);
     
     ma_result result = ma_decoder_init_file(filepath.c_str(), &decoderConfig, &pImpl->decoder);
     if (result != MA_SUCCESS) {
+        startAnalysis();
         return false;
     }
     
@@ -278,6 +550,7 @@ bool AudioAnalyzer::loadFile(const std::string& filepath) {
     result = ma_device_init(nullptr, &pImpl->deviceConfig, &pImpl->device);
     if (result != MA_SUCCESS) {
         ma_decoder_uninit(&pImpl->decoder);
+        startAnalysis();
         return false;
     }
     
@@ -289,16 +562,37 @@ bool AudioAnalyzer::loadFile(const std::string& filepath) {
     pImpl->fileLoaded = true;
     pImpl->currentFrame = 0;
     
+    // Reuse an offline analysis of this file if one was cached (the
+    // fingerprint reads only sampled blocks, so this does not stall the UI)
+    pImpl->source = SpectrogramCache::hashFile(filepath);
+    pImpl->openCachedAnalysis();
+    
+    // Fresh prefetch ring; neither the device nor the decoder thread runs yet
+    pImpl->pcmQueue.reset(AudioAnalyzerImpl::kPrefetchBlocks);
+    pImpl->playBlock.frames = 0;
+    pImpl->playBlock.endOfStream = false;
+    pImpl->playBlockPos = 0;
+    pImpl->pendingSeek = -1;
+    pImpl->decodeFrame = 0;
+    pImpl->decoderAtEnd = false;
+    AudioAnalyzerImpl* impl = pImpl.get();
+    pImpl->decodeWorker.start([impl] { impl->decodeAhead(); }, std::chrono::milliseconds(2));
+    
     // Update bands for new sample rate
     updateBands();
     
-    // Initialize EQ filters for this sample rate
-    pImpl->updateEQFilters();
-    
-    // Reset filter states
+    // Redesign EQ for this sample rate. The device is not running yet, so
+    // the engine can be snapped to the new coefficients directly.
+    pImpl->eqDesign.setSampleRate(pImpl->sampleRate);
     for (int i = 0; i < EqualizerConfig::NUM_BANDS; ++i) {
-        pImpl->eqFilters[i].reset();
+        pImpl->designEQBand(i);
     }
+    pImpl->publishEQ();
+    pImpl->eqEngine.setSampleRate(pImpl->sampleRate);
+    pImpl->eqEngine.setTargetCoefficients(pImpl->eqDesign.getCoefficientSet());
+    pImpl->eqEngine.reset();
+    
+    startAnalysis();
     
     return true;
 }
@@ -323,15 +617,13 @@ void AudioAnalyzer::stop() {
     
     if (pImpl->fileLoaded) {
         ma_device_stop(&pImpl->device);
-        ma_decoder_seek_to_pcm_frame(&pImpl->decoder, 0);
-        pImpl->currentFrame = 0;
+        pImpl->requestSeek(0);
+        pImpl->decodeWorker.wake();
     }
     
-    // Clear spectrum
-    std::lock_guard<std::mutex> lock(pImpl->bufferMutex);
-    std::fill(pImpl->smoothedMagnitudes.begin(), pImpl->smoothedMagnitudes.end(), 0.0);
-    std::fill(pImpl->currentSpectrum.magnitudes.begin(), 
-              pImpl->currentSpectrum.magnitudes.end(), 0.0);
+    // Clear spectrum: the worker drops its history and publishes silence
+    pImpl->resetRequested = true;
+    pImpl->worker.wake();
 }
 
 void AudioAnalyzer::togglePlayPause() {
@@ -348,8 +640,9 @@ void AudioAnalyzer::seek(double positionSeconds) {
     uint64_t frame = static_cast<uint64_t>(positionSeconds * pImpl->sampleRate);
     frame = (std::min)(frame, pImpl->totalFrames);
     
-    ma_decoder_seek_to_pcm_frame(&pImpl->decoder, frame);
-    pImpl->currentFrame = frame;
+    // The decoder thread performs the seek; the callback drops stale blocks
+    pImpl->requestSeek(frame);
+    pImpl->decodeWorker.wake();
 }
 
 void AudioAnalyzer::setVolume(float volume) {
@@ -383,15 +676,25 @@ const std::string& AudioAnalyzer::getFilename() const {
 }
 
 void AudioAnalyzer::setConfig(const AnalyzerConfig& config) {
+    // Analysis state is owned by the worker; reconfigure while it is parked
+    bool restart = pImpl->worker.isRunning();
+    pImpl->worker.stop();
+    
     pImpl->config = config;
     
     // Resize buffers
-    pImpl->sampleBuffer.resize(config.fftSize * 2, 0.0f);
-    pImpl->smoothedMagnitudes.resize(config.numBands, 0.0);
-    pImpl->currentSpectrum.magnitudes.resize(config.numBands, 0.0);
-    pImpl->currentSpectrum.frequencies.resize(config.numBands, 0.0);
+    pImpl->allocateAnalysis();
+    
+    // Force a fresh analysis with the new settings
+    pImpl->samplesSinceAnalysis = config.hopSize;
     
     updateBands();
+    pImpl->openCachedAnalysis();
+    pImpl->publishSpectrum();
+    
+    if (restart) {
+        startAnalysis();
+    }
 }
 
 const AnalyzerConfig& AudioAnalyzer::getConfig() const {
@@ -399,171 +702,257 @@ const AnalyzerConfig& AudioAnalyzer::getConfig() const {
 }
 
 void AudioAnalyzer::processAudioData(const float* samples, size_t frameCount, uint32_t channels) {
-    std::lock_guard<std::mutex> lock(pImpl->bufferMutex);
-    
-    // Mix to mono and copy to circular buffer
-    for (size_t i = 0; i < frameCount; ++i) {
-        float sample = 0.0f;
-        for (uint32_t c = 0; c < channels; ++c) {
-            sample += samples[i * channels + c];
+    if (channels == 0) return;
+    
+    // Queue left/right pairs in small stack chunks; the worker splits the
+    // channels. Mono feeds both sides, channels past the second are ignored.
+    // Runs on the audio thread: no locks, no allocation; drops on overflow.
+    constexpr size_t kChunk = 256;
+    StereoFrame frames[kChunk];
+    size_t rightChannel = channels > 1 ? 1 : 0;
+    size_t queued = 0;
+    
+    for (size_t offset = 0; offset < frameCount; offset += kChunk) {
+        size_t count = (std::min)(kChunk, frameCount - offset);
+        for (size_t i = 0; i < count; ++i) {
+            const float* frame = samples + (offset + i) * channels;
+            frames[i] = StereoFrame{frame[0], frame[rightChannel]};
         }
-        sample /= static_cast<float>(channels);
-        
-        pImpl->sampleBuffer[pImpl->bufferWritePos] = sample;
-        pImpl->bufferWritePos = (pImpl->bufferWritePos + 1) % pImpl->sampleBuffer.size();
+        queued += pImpl->sampleQueue.write(frames, count);
     }
+    
+    // Dropped frames never reach the worker, so they don't advance the clock
+    uint64_t clock = pImpl->analysisClock.load(std::memory_order_relaxed);
+    pImpl->analysisClock.store(clock + queued, std::memory_order_release);
 }
 
-void AudioAnalyzer::computeSpectrum() {
-    std::lock_guard<std::mutex> lock(pImpl->bufferMutex);
-    
-    size_t fftSize = pImpl->config.fftSize;
-    
-    // Extract samples from circular buffer
-    std::vector<double> samples(fftSize);
-    size_t readPos = (pImpl->bufferWritePos + pImpl->sampleBuffer.size() - fftSize) 
-                     % pImpl->sampleBuffer.size();
-    
-    for (size_t i = 0; i < fftSize; ++i) {
-        samples[i] = static_cast<double>(pImpl->sampleBuffer[(readPos + i) % pImpl->sampleBuffer.size()]);
-    }
-    
-    // Compute RMS
-    double rms = 0.0;
-    double peak = 0.0;
-    for (const auto& s : samples) {
-        rms += s * s;
-        peak = (std::max)(peak, std::abs(s));
-    }
-    rms = std::sqrt(rms / samples.size());
-    pImpl->currentSpectrum.rmsLevel = rms;
-    pImpl->currentSpectrum.peakLevel = peak;
-    
-    // Apply window
-    samples = fft::applyHannWindow(samples);
-    
-    // Compute FFT
-    auto spectrum = fft::transform(samples);
-    auto magnitudes = fft::magnitude(spectrum);
-    
-    // Normalize magnitudes by FFT size (proper scaling for amplitude)
-    double normFactor = 2.0 / fftSize;  // Factor of 2 because we only use half the spectrum
-    for (auto& m : magnitudes) {
-        m *= normFactor;
+void AudioAnalyzer::startAnalysis() {
+    pImpl->worker.start([this] { analyzeQueuedSamples(); });
+}
+
+void AudioAnalyzer::analyzeQueuedSamples() {
+    AudioAnalyzerImpl& impl = *pImpl;
+    
+    if (impl.resetRequested.exchange(false)) {
+        impl.analyzedFrames += impl.sampleQueue.discard();
+        impl.advanceStreamPosition();
+        impl.clearSpectrum();
+        impl.currentSpectrum.timestamp = impl.analyzedFrames;
+        impl.samplesSinceAnalysis = 0;
+        impl.publishSpectrum();
+        return;
     }
     
-    // Only use first half (positive frequencies)
-    size_t halfSize = fftSize / 2;
+    size_t hopSize = (std::max<size_t>)(impl.config.hopSize, 1);
+    bool analyzed = false;
     
-    // Map to frequency bands
-    double maxMag = 0.0;
-    size_t peakBin = 0;
-    
-    for (size_t band = 0; band < pImpl->config.numBands; ++band) {
-        auto [startBin, endBin] = pImpl->bandBins[band];
+    // Drain at most one hop at a time so every hop gets its own frame
+    for (;;) {
+        size_t wanted = hopSize - (std::min)(impl.samplesSinceAnalysis, hopSize - 1);
+        wanted = (std::min)(wanted, impl.drainBuffer.size());
+        size_t count = impl.sampleQueue.read(impl.drainBuffer.data(), wanted);
+        if (count == 0) break;
         
-        if (startBin >= halfSize) {
-            pImpl->currentSpectrum.magnitudes[band] = 0.0;
-            continue;
+        // Deinterleave into the per-channel history
+        for (size_t i = 0; i < count; ++i) {
+            impl.drainLeft[i] = impl.drainBuffer[i].left;
+            impl.drainRight[i] = impl.drainBuffer[i].right;
         }
+        impl.historyLeft.write(impl.drainLeft.data(), count);
+        impl.historyRight.write(impl.drainRight.data(), count);
+        impl.samplesSinceAnalysis += count;
+        impl.analyzedFrames += count;
+        impl.advanceStreamPosition();
         
-        endBin = (std::min)(endBin, halfSize - 1);
-        
-        // Use max magnitude in band (better for peaks) or average
-        double bandMax = 0.0;
-        double sum = 0.0;
-        size_t count = 0;
-        
-        for (size_t bin = startBin; bin <= endBin; ++bin) {
-            double mag = magnitudes[bin];
-            sum += mag;
-            count++;
-            
-            if (mag > bandMax) {
-                bandMax = mag;
-            }
-            
-            if (mag > maxMag) {
-                maxMag = mag;
-                peakBin = bin;
+        if (impl.samplesSinceAnalysis >= hopSize) {
+            impl.samplesSinceAnalysis = 0;
+            impl.currentSpectrum.timestamp = impl.analyzedFrames;
+            // The cache holds the mono mix only
+            if (impl.cachedAnalysis.isOpen() && impl.eqFlat.load() && !impl.config.stereo) {
+                computeCachedSpectrum();
+            } else {
+                computeSpectrum();
             }
+            analyzed = true;
+        }
+    }
+    
+    if (analyzed) {
+        impl.publishSpectrum();
+    }
+}
+
+void AudioAnalyzer::computeSpectrum() {
+    AudioAnalyzerImpl& impl = *pImpl;
+    perf::ScopedTimer timer(perf::Stage::Analysis);
+    size_t fftSize = impl.config.fftSize;
+    
+    // Extract the latest fftSize samples of each channel from the history
+    impl.historyLeft.readLatest(impl.frameLeft.data(), fftSize);
+    impl.historyRight.readLatest(impl.frameRight.data(), fftSize);
+    
+    if (!impl.config.stereo) {
+        for (size_t i = 0; i < fftSize; ++i) {
+            impl.frameSamples[i] = 0.5f * (impl.frameLeft[i] + impl.frameRight[i]);
         }
         
-        // Use max for better peak representation (like professional analyzers)
-        double bandMag = bandMax;
+        FrameStats stats;
+        impl.frameAnalyzer.analyze(impl.frameSamples.data(), impl.frameBands.data(), stats);
         
-        // Apply smoothing
-        pImpl->smoothedMagnitudes[band] = 
-            pImpl->config.smoothingFactor * pImpl->smoothedMagnitudes[band] +
-            (1.0 - pImpl->config.smoothingFactor) * bandMag;
+        impl.currentSpectrum.rmsLevel = stats.rmsLevel;
+        impl.currentSpectrum.peakLevel = stats.peakLevel;
+        impl.currentSpectrum.peakFrequency = stats.peakFrequency;
         
-        pImpl->currentSpectrum.magnitudes[band] = pImpl->smoothedMagnitudes[band];
+        impl.smoothFrameBands();
+        return;
+    }
+    
+    // Left, right, mid and side from one packed FFT per tier
+    std::array<double*, kNumChannels> bands;
+    for (size_t c = 0; c < kNumChannels; ++c) {
+        bands[c] = impl.channelBands[c].data();
+    }
+    std::array<FrameStats, kNumChannels> stats;
+    impl.frameAnalyzer.analyzeStereo(impl.frameLeft.data(), impl.frameRight.data(), bands, stats);
+    
+    for (size_t c = 0; c < kNumChannels; ++c) {
+        SpectrumData::ChannelSpectrum& channel = impl.currentSpectrum.channels[c];
+        channel.rmsLevel = stats[c].rmsLevel;
+        channel.peakLevel = stats[c].peakLevel;
+        channel.peakFrequency = stats[c].peakFrequency;
+        impl.smoothBands(impl.channelBands[c], impl.smoothedChannels[c],
+                         channel.magnitudes, channel.magnitudesDb);
     }
     
-    // Calculate peak frequency
-    double binWidth = static_cast<double>(pImpl->sampleRate) / fftSize;
-    pImpl->currentSpectrum.peakFrequency = peakBin * binWidth;
+    // The mono fields show the mid channel
+    const SpectrumData::ChannelSpectrum& mid = impl.currentSpectrum.channel(Channel::Mid);
+    impl.currentSpectrum.rmsLevel = mid.rmsLevel;
+    impl.currentSpectrum.peakLevel = mid.peakLevel;
+    impl.currentSpectrum.peakFrequency = mid.peakFrequency;
+    std::copy(mid.magnitudes.begin(), mid.magnitudes.end(), impl.currentSpectrum.magnitudes.begin());
+    std::copy(mid.magnitudesDb.begin(), mid.magnitudesDb.end(), impl.currentSpectrum.magnitudesDb.begin());
+}
+
+void AudioAnalyzer::computeCachedSpectrum() {
+    AudioAnalyzerImpl& impl = *pImpl;
+    perf::ScopedTimer timer(perf::Stage::Analysis);
+    const SpectrogramReader& cache = impl.cachedAnalysis;
+    
+    // Frame ending at the newest drained sample, like the live path (and
+    // the frame's timestamp); the analyzed signal is post-volume
+    uint64_t index = cache.frameAt(impl.drainedStreamFrame);
+    double gain = impl.volume;
+    cache.readPower(index, impl.frameBands.data(), gain);
+    
+    const FrameLevels& levels = cache.levels(index);
+    impl.currentSpectrum.rmsLevel = levels.rmsLevel * gain;
+    impl.currentSpectrum.peakLevel = levels.peakLevel * gain;
+    impl.currentSpectrum.peakFrequency = levels.peakFrequency;
+    
+    impl.smoothFrameBands();
 }
 
 void AudioAnalyzer::updateBands() {
-    double minFreq = pImpl->config.minFrequency;
-    double maxFreq = (std::min)(pImpl->config.maxFrequency, 
-                               static_cast<double>(pImpl->sampleRate) / 2.0);
-    size_t numBands = pImpl->config.numBands;
-    size_t fftSize = pImpl->config.fftSize;
-    
-    pImpl->bandFrequencies.resize(numBands);
-    pImpl->bandBins.resize(numBands);
-    
-    double binWidth = static_cast<double>(pImpl->sampleRate) / fftSize;
-    
-    if (pImpl->config.useLogScale) {
-        // Logarithmic frequency scale
-        double logMin = std::log10(minFreq);
-        double logMax = std::log10(maxFreq);
-        double logStep = (logMax - logMin) / numBands;
-        
-        for (size_t i = 0; i < numBands; ++i) {
-            double freqLow = std::pow(10.0, logMin + i * logStep);
-            double freqHigh = std::pow(10.0, logMin + (i + 1) * logStep);
-            double freqCenter = std::sqrt(freqLow * freqHigh); // Geometric mean
-            
-            pImpl->bandFrequencies[i] = freqCenter;
-            pImpl->currentSpectrum.frequencies[i] = freqCenter;
-            
-            size_t binLow = static_cast<size_t>(freqLow / binWidth);
-            size_t binHigh = static_cast<size_t>(freqHigh / binWidth);
-            
-            // Ensure at least one bin per band
-            if (binHigh <= binLow) binHigh = binLow + 1;
-            
-            pImpl->bandBins[i] = {binLow, binHigh};
-        }
-    } else {
-        // Linear frequency scale
-        double freqStep = (maxFreq - minFreq) / numBands;
-        
-        for (size_t i = 0; i < numBands; ++i) {
-            double freqLow = minFreq + i * freqStep;
-            double freqHigh = freqLow + freqStep;
-            double freqCenter = (freqLow + freqHigh) / 2.0;
-            
-            pImpl->bandFrequencies[i] = freqCenter;
-            pImpl->currentSpectrum.frequencies[i] = freqCenter;
-            
-            size_t binLow = static_cast<size_t>(freqLow / binWidth);
-            size_t binHigh = static_cast<size_t>(freqHigh / binWidth);
-            
-            if (binHigh <= binLow) binHigh = binLow + 1;
-            
-            pImpl->bandBins[i] = {binLow, binHigh};
-        }
+    AudioAnalyzerImpl& impl = *pImpl;
+    
+    impl.frameAnalyzer.configure(impl.config, impl.sampleRate);
+    impl.frameLeft.assign(impl.config.fftSize, 0.0f);
+    impl.frameRight.assign(impl.config.fftSize, 0.0f);
+    impl.frameSamples.assign(impl.config.fftSize, 0.0f);
+    impl.frameBands.assign(impl.config.numBands, 0.0);
+    for (std::vector<double>& bands : impl.channelBands) {
+        bands.assign(impl.config.stereo ? impl.config.numBands : 0, 0.0);
+    }
+    
+    const std::vector<double>& frequencies = impl.frameAnalyzer.bandFrequencies();
+    std::copy(frequencies.begin(), frequencies.end(), impl.currentSpectrum.frequencies.begin());
+    ++impl.currentSpectrum.layoutVersion;
+}
+
+const SpectrumData& AudioAnalyzer::acquireSpectrum() {
+    pImpl->publishedSpectra.update();
+    return pImpl->publishedSpectra.readBuffer();
+}
+
+namespace {
+
+// a + (b - a) * t over equally sized ranges
+template <typename T>
+void blendValues(const std::vector<T>& a, const std::vector<T>& b, double t, std::vector<T>& out) {
+    out.resize(b.size());
+    for (size_t i = 0; i < b.size(); ++i) {
+        out[i] = static_cast<T>(a[i] + (b[i] - a[i]) * t);
+    }
+}
+
+} // namespace
+
+const SpectrumData& AudioAnalyzer::acquireDisplaySpectrum() {
+    AudioAnalyzerImpl& impl = *pImpl;
+    const SpectrumData& latest = acquireSpectrum();
+    
+    // Keep the previous frame when a new one arrives (per-frame fields only,
+    // no allocation once sizes settle)
+    if (latest.sequence != impl.latestFrame.sequence) {
+        std::swap(impl.previousFrame, impl.latestFrame);
+        AudioAnalyzerImpl::copyFrame(latest, impl.latestFrame);
+    }
+    const SpectrumData& a = impl.previousFrame;
+    const SpectrumData& b = impl.latestFrame;
+    SpectrumData& out = impl.displaySpectrum;
+    
+    // The clock moves once per audio callback; advance it with wall time in
+    // between, by at most one hop so it stops soon after playback does
+    auto now = std::chrono::steady_clock::now();
+    uint64_t clock = impl.analysisClock.load(std::memory_order_acquire);
+    if (clock != impl.displayClock) {
+        impl.displayClock = clock;
+        impl.displayClockTime = now;
+    }
+    double hop = static_cast<double>((std::max<size_t>)(impl.config.hopSize, 1));
+    double elapsed = std::chrono::duration<double>(now - impl.displayClockTime).count() * impl.sampleRate;
+    double displayTime = static_cast<double>(clock) + (std::min)(elapsed, hop) - hop;
+    
+    // Position of the display time between the two frames
+    double t = 1.0;
+    bool blend = a.sequence != 0 && a.layoutVersion == b.layoutVersion &&
+                 a.magnitudes.size() == b.magnitudes.size() && b.timestamp > a.timestamp;
+    if (blend) {
+        t = (displayTime - static_cast<double>(a.timestamp)) / static_cast<double>(b.timestamp - a.timestamp);
+        t = (std::max)(0.0, (std::min)(1.0, t));
+    }
+    
+    blendValues(blend ? a.magnitudes : b.magnitudes, b.magnitudes, t, out.magnitudes);
+    blendValues(blend ? a.magnitudesDb : b.magnitudesDb, b.magnitudesDb, t, out.magnitudesDb);
+    for (size_t c = 0; c < kNumChannels; ++c) {
+        const SpectrumData::ChannelSpectrum& from = blend ? a.channels[c] : b.channels[c];
+        const SpectrumData::ChannelSpectrum& to = b.channels[c];
+        SpectrumData::ChannelSpectrum& channel = out.channels[c];
+        bool sameSize = from.magnitudes.size() == to.magnitudes.size();
+        blendValues(sameSize ? from.magnitudes : to.magnitudes, to.magnitudes, t, channel.magnitudes);
+        blendValues(sameSize ? from.magnitudesDb : to.magnitudesDb, to.magnitudesDb, t, channel.magnitudesDb);
+        channel.rmsLevel = from.rmsLevel + (to.rmsLevel - from.rmsLevel) * t;
+        channel.peakLevel = from.peakLevel + (to.peakLevel - from.peakLevel) * t;
+        channel.peakFrequency = t < 0.5 ? from.peakFrequency : to.peakFrequency;
+    }
+    
+    // Levels blend; the dominant frequency switches halfway
+    const SpectrumData& from = blend ? a : b;
+    out.rmsLevel = from.rmsLevel + (b.rmsLevel - from.rmsLevel) * t;
+    out.peakLevel = from.peakLevel + (b.peakLevel - from.peakLevel) * t;
+    out.peakFrequency = t < 0.5 ? from.peakFrequency : b.peakFrequency;
+    
+    if (out.layoutVersion != b.layoutVersion) {
+        out.frequencies = b.frequencies;
+        out.layoutVersion = b.layoutVersion;
     }
+    out.sequence = b.sequence;
+    out.timestamp = static_cast<uint64_t>((std::max)(0.0, displayTime));
+    return out;
 }
 
-SpectrumData AudioAnalyzer::getSpectrum() {
-    computeSpectrum();
-    return pImpl->currentSpectrum;
+const SpectrumData& AudioAnalyzer::getLatestFrame() const {
+    return pImpl->latestFrame;
 }
 
 EqualizerConfig& AudioAnalyzer::getEqualizer() {
@@ -579,7 +968,8 @@ void AudioAnalyzer::setEQBandGain(int bandIndex, double gainDb) {
         // Clamp gain to -12 to +12 dB
         gainDb = (std::max)(-12.0, (std::min)(12.0, gainDb));
         pImpl->eqConfig.bands[bandIndex].gain = gainDb;
-        pImpl->eqNeedsUpdate = true;
+        pImpl->designEQBand(bandIndex);
+        pImpl->publishEQ();
     }
 }
 
@@ -595,7 +985,8 @@ void AudioAnalyzer::setEQBandFrequency(int bandIndex, double frequency) {
         // Clamp frequency to audible range
         frequency = (std::max)(20.0, (std::min)(20000.0, frequency));
         pImpl->eqConfig.bands[bandIndex].frequency = frequency;
-        pImpl->eqNeedsUpdate = true;
+        pImpl->designEQBand(bandIndex);
+        pImpl->publishEQ();
     }
 }
 
@@ -611,7 +1002,8 @@ void AudioAnalyzer::setEQBandQ(int bandIndex, double q) {
         // Clamp Q to reasonable range
         q = (std::max)(0.1, (std::min)(10.0, q));
         pImpl->eqConfig.bands[bandIndex].q = q;
-        pImpl->eqNeedsUpdate = true;
+        pImpl->designEQBand(bandIndex);
+        pImpl->publishEQ();
     }
 }
 
@@ -624,6 +1016,7 @@ double AudioAnalyzer::getEQBandQ(int bandIndex) const {
 
 void AudioAnalyzer::setEQEnabled(bool enabled) {
     pImpl->eqConfig.enabled = enabled;
+    pImpl->publishEQ();
 }
 
 bool AudioAnalyzer::isEQEnabled() const {
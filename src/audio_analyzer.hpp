@@ -1,6 +1,8 @@
 #pragma once
 
 #include "eq_processor.hpp"  // For shared EQ constants
+#include "fft.hpp"
+#include <array>
 #include <vector>
 #include <string>
 #include <memory>
@@ -43,28 +45,77 @@ struct EqualizerConfig {
     bool enabled = true;
 };
 
+/**
+ * How the FFT bins of one band combine into its magnitude
+ */
+enum class BandReduction {
+    Max,            // Loudest bin, with edge bins faded in (peak-style display)
+    WeightedMean    // Triangular weights around the band center (smoother)
+};
+
 /**
  * Configuration for the audio analyzer
  */
 struct AnalyzerConfig {
     size_t fftSize = 4096;           // FFT window size (power of 2)
     size_t hopSize = 1024;           // Hop size for overlapping windows
+    fft::WindowType window = fft::WindowType::Hann;  // Analysis window (levels stay Hann-calibrated)
     double smoothingFactor = 0.7;     // Temporal smoothing (0-1)
     double minFrequency = 20.0;       // Minimum frequency to display
     double maxFrequency = 20000.0;    // Maximum frequency to display
     size_t numBands = 128;            // Number of frequency bands for visualization
     bool useLogScale = true;          // Use logarithmic frequency scale
+    BandReduction bandReduction = BandReduction::Max;  // Bin-to-band combination
+    bool multiResolution = false;     // Shorter FFTs for higher bands (less latency), see FrameAnalyzer
+    bool stereo = false;              // Also analyze left/right/mid/side (SpectrumData::channels)
+};
+
+/**
+ * Channels of a stereo analysis
+ * Mid is the mono mix (L + R) / 2, side is (L - R) / 2.
+ */
+enum class Channel {
+    Left,
+    Right,
+    Mid,
+    Side
 };
 
+constexpr size_t kNumChannels = 4;
+
 /**
  * Represents the current spectrum analysis result
  */
 struct SpectrumData {
+    static constexpr float kFloorDb = -120.0f;  // magnitudesDb value for silence
+
+    /**
+     * Analysis of one channel (same layout as the mono fields below)
+     */
+    struct ChannelSpectrum {
+        std::vector<double> magnitudes;
+        std::vector<float> magnitudesDb;
+        double peakFrequency = 0.0;
+        double rmsLevel = 0.0;
+        double peakLevel = 0.0;
+    };
+
     std::vector<double> magnitudes;   // Magnitude values per band
-    std::vector<double> frequencies;  // Center frequency of each band
+    std::vector<float> magnitudesDb;  // Same values in dB (20*log10), floored at kFloorDb
+    std::vector<double> frequencies;  // Center frequency of each band (changes with layoutVersion only)
     double peakFrequency = 0.0;       // Dominant frequency
     double rmsLevel = 0.0;            // RMS level of current frame
     double peakLevel = 0.0;           // Peak level of current frame
+
+    // Per-channel results, indexed by Channel, when AnalyzerConfig::stereo
+    // is set (the mono fields then repeat the mid channel); empty otherwise
+    std::array<ChannelSpectrum, kNumChannels> channels;
+
+    const ChannelSpectrum& channel(Channel c) const { return channels[static_cast<size_t>(c)]; }
+
+    uint64_t sequence = 0;            // Increments with every published spectrum
+    uint64_t layoutVersion = 0;       // Increments when the band layout (count, frequencies) changes
+    uint64_t timestamp = 0;           // Analysis clock (frames fed to the analyzer) at the end of the window
 };
 
 /**
@@ -156,10 +207,38 @@ public:
     uint32_t getSampleRate() const;
 
     /**
-     * Get current spectrum data
-     * @return SpectrumData struct with current analysis
+     * Get the latest published spectrum without copying
+     * The analysis worker hands spectra over through a triple buffer, so
+     * this never blocks or allocates. Single consumer: call from the render
+     * thread only. The returned data stays valid and unchanged until the
+     * next call.
+     *
+     * @return Latest spectrum; compare sequence to detect a new frame
+     */
+    const SpectrumData& acquireSpectrum();
+
+    /**
+     * Get the spectrum to display now, interpolated between the two latest
+     * published frames
+     * Frames arrive once per hop while the display runs at its own rate, so
+     * this blends the frames around a display time one hop behind the
+     * analysis clock (extrapolated between audio callbacks). The result
+     * changes smoothly every call at any frame rate; the added latency is
+     * one hop. Same threading rules as acquireSpectrum(), which it calls:
+     * use one or the other.
+     *
+     * @return Blended spectrum; sequence is that of the latest frame
+     */
+    const SpectrumData& acquireDisplaySpectrum();
+
+    /**
+     * Newest frame as of the last acquireDisplaySpectrum() call, unblended
+     * Consumers that keep one entry per analysis frame (the spectrogram)
+     * read this rather than the display spectrum. Render thread only.
+     *
+     * @return Latest published frame; compare sequence to detect a new one
      */
-    SpectrumData getSpectrum();
+    const SpectrumData& getLatestFrame() const;
 
     /**
      * Update analyzer configuration
@@ -181,6 +260,8 @@ public:
 
     /**
      * Process audio data (called internally during playback)
+     * Realtime-safe: queues left/right frames for the analysis worker
+     * (mono input feeds both sides, channels past the second are ignored)
      */
     void processAudioData(const float* samples, size_t frameCount, uint32_t channels);
 
@@ -248,7 +329,10 @@ public:
 private:
     std::unique_ptr<AudioAnalyzerImpl> pImpl;
 
+    void startAnalysis();
+    void analyzeQueuedSamples();
     void computeSpectrum();
+    void computeCachedSpectrum();
     void updateBands();
     double frequencyToBand(double freq) const;
 };
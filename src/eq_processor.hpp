@@ -9,6 +9,20 @@
 #include <array>
 #include <algorithm>
 
+// Stereo lane pair: SSE2 on x86-64 (FMA when built for AVX2), NEON on
+// AArch64, scalar otherwise
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define EQ_SIMD_SSE2 1
+#include <emmintrin.h>
+#if defined(__FMA__) || defined(__AVX2__)
+#define EQ_SIMD_FMA 1
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define EQ_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -26,18 +40,127 @@ constexpr double MAX_Q = 10.0;
 constexpr double DEFAULT_Q = 0.707;
 
 /**
- * Biquad filter for parametric EQ
+ * Normalized biquad coefficients (a0 == 1), identity by default
  */
-class BiquadFilter {
-public:
-    BiquadFilter() { reset(); }
+struct BiquadCoefficients {
+    double b0 = 1.0, b1 = 0.0, b2 = 0.0;
+    double a1 = 0.0, a2 = 0.0;
+};
+
+/**
+ * Complete coefficient state of the band cascade. Plain data, so it can be
+ * designed on one thread and handed to the audio thread by value.
+ * Inactive bands hold identity coefficients.
+ */
+struct CoefficientSet {
+    std::array<BiquadCoefficients, NUM_BANDS> bands{};
+    std::array<bool, NUM_BANDS> active{};
+    bool bypass = false;
+};
+
+namespace detail {
+
+/**
+ * Two doubles processed together - (left, right) of one stereo frame
+ */
+#if defined(EQ_SIMD_SSE2)
+struct LanePair {
+    __m128d v;
+    static LanePair broadcast(double x) { return {_mm_set1_pd(x)}; }
+    static LanePair load(const double* p) { return {_mm_loadu_pd(p)}; }
+    void store(double* p) const { _mm_storeu_pd(p, v); }
+};
+inline LanePair operator+(LanePair a, LanePair b) { return {_mm_add_pd(a.v, b.v)}; }
+inline LanePair operator-(LanePair a, LanePair b) { return {_mm_sub_pd(a.v, b.v)}; }
+inline LanePair operator*(LanePair a, LanePair b) { return {_mm_mul_pd(a.v, b.v)}; }
+#if defined(EQ_SIMD_FMA)
+inline LanePair mulAdd(LanePair a, LanePair b, LanePair c) { return {_mm_fmadd_pd(a.v, b.v, c.v)}; }
+inline LanePair negMulAdd(LanePair a, LanePair b, LanePair c) { return {_mm_fnmadd_pd(a.v, b.v, c.v)}; }
+#else
+inline LanePair mulAdd(LanePair a, LanePair b, LanePair c) { return a * b + c; }
+inline LanePair negMulAdd(LanePair a, LanePair b, LanePair c) { return c - a * b; }
+#endif
+#elif defined(EQ_SIMD_NEON)
+struct LanePair {
+    float64x2_t v;
+    static LanePair broadcast(double x) { return {vdupq_n_f64(x)}; }
+    static LanePair load(const double* p) { return {vld1q_f64(p)}; }
+    void store(double* p) const { vst1q_f64(p, v); }
+};
+inline LanePair operator+(LanePair a, LanePair b) { return {vaddq_f64(a.v, b.v)}; }
+inline LanePair operator-(LanePair a, LanePair b) { return {vsubq_f64(a.v, b.v)}; }
+inline LanePair operator*(LanePair a, LanePair b) { return {vmulq_f64(a.v, b.v)}; }
+inline LanePair mulAdd(LanePair a, LanePair b, LanePair c) { return {vfmaq_f64(c.v, a.v, b.v)}; }
+inline LanePair negMulAdd(LanePair a, LanePair b, LanePair c) { return {vfmsq_f64(c.v, a.v, b.v)}; }
+#else
+struct LanePair {
+    double l, r;
+    static LanePair broadcast(double x) { return {x, x}; }
+    static LanePair load(const double* p) { return {p[0], p[1]}; }
+    void store(double* p) const { p[0] = l; p[1] = r; }
+};
+inline LanePair operator+(LanePair a, LanePair b) { return {a.l + b.l, a.r + b.r}; }
+inline LanePair operator-(LanePair a, LanePair b) { return {a.l - b.l, a.r - b.r}; }
+inline LanePair operator*(LanePair a, LanePair b) { return {a.l * b.l, a.r * b.r}; }
+inline LanePair mulAdd(LanePair a, LanePair b, LanePair c) { return a * b + c; }
+inline LanePair negMulAdd(LanePair a, LanePair b, LanePair c) { return c - a * b; }
+#endif
+
+/**
+ * Run a cascade of N biquads (transposed direct form II) over interleaved
+ * L/R frames. Sample-major, so the bands' recursions overlap in the
+ * pipeline instead of each band waiting on its own feedback latency.
+ * @param c Coefficients, one per band (advanced by step per frame if Ramp)
+ * @param step Per-frame coefficient increments (only read if Ramp)
+ * @param state Per band {s1L, s1R, s2L, s2R}, updated in place
+ * @param frames Interleaved stereo doubles, filtered in place
+ * @param numFrames Number of frames
+ */
+template <int N, bool Ramp>
+inline void cascadeStereoTDF2(BiquadCoefficients* c, const BiquadCoefficients* step,
+                              double* const* state, double* frames, int numFrames) {
+    LanePair s1[N], s2[N];
+    for (int k = 0; k < N; ++k) {
+        s1[k] = LanePair::load(state[k]);
+        s2[k] = LanePair::load(state[k] + 2);
+    }
     
-    void reset() {
-        for (int i = 0; i < 2; ++i) {
-            x1_[i] = x2_[i] = y1_[i] = y2_[i] = 0.0;
+    for (int i = 0; i < numFrames; ++i) {
+        LanePair x = LanePair::load(frames + 2 * i);
+        for (int k = 0; k < N; ++k) {
+            if (Ramp) {
+                c[k].b0 += step[k].b0;
+                c[k].b1 += step[k].b1;
+                c[k].b2 += step[k].b2;
+                c[k].a1 += step[k].a1;
+                c[k].a2 += step[k].a2;
+            }
+            
+            // Feed-forward terms first so only y -> s1 sits on the feedback path
+            LanePair y = mulAdd(LanePair::broadcast(c[k].b0), x, s1[k]);
+            LanePair t1 = mulAdd(LanePair::broadcast(c[k].b1), x, s2[k]);
+            LanePair t2 = LanePair::broadcast(c[k].b2) * x;
+            s1[k] = negMulAdd(LanePair::broadcast(c[k].a1), y, t1);
+            s2[k] = negMulAdd(LanePair::broadcast(c[k].a2), y, t2);
+            x = y;
         }
+        x.store(frames + 2 * i);
     }
     
+    for (int k = 0; k < N; ++k) {
+        s1[k].store(state[k]);
+        s2[k].store(state[k] + 2);
+    }
+}
+
+} // namespace detail
+
+/**
+ * Peaking biquad design for parametric EQ (coefficients and response only;
+ * EQProcessor runs the filters)
+ */
+class BiquadFilter {
+public:
     void setPeakingEQ(double sampleRate, double freq, double gainDb, double q) {
         // Clamp parameters
         freq = std::max(20.0, std::min(freq, sampleRate * 0.45));
@@ -65,17 +188,8 @@ public:
         a2_ /= a0;
     }
     
-    float process(float input, int channel) {
-        double x0 = static_cast<double>(input);
-        double y0 = b0_ * x0 + b1_ * x1_[channel] + b2_ * x2_[channel]
-                  - a1_ * y1_[channel] - a2_ * y2_[channel];
-        
-        x2_[channel] = x1_[channel];
-        x1_[channel] = x0;
-        y2_[channel] = y1_[channel];
-        y1_[channel] = y0;
-        
-        return static_cast<float>(y0);
+    BiquadCoefficients getCoefficients() const {
+        return {b0_, b1_, b2_, a1_, a2_};
     }
     
     // Get frequency response magnitude at a given frequency
@@ -100,10 +214,6 @@ public:
 private:
     double b0_ = 1.0, b1_ = 0.0, b2_ = 0.0;
     double a1_ = 0.0, a2_ = 0.0;
-    double x1_[2] = {0, 0};
-    double x2_[2] = {0, 0};
-    double y1_[2] = {0, 0};
-    double y2_[2] = {0, 0};
 };
 
 /**
@@ -122,12 +232,46 @@ public:
     void setSampleRate(double sampleRate) {
         sampleRate_ = sampleRate;
         updateAllFilters();
+        
+        // A rate change is a discontinuity anyway; don't ramp across it
+        current_ = target_;
+        rampPending_ = false;
+        rampRemaining_ = 0;
     }
     
     void reset() {
-        for (auto& filter : filters_) {
-            filter.reset();
+        for (auto& state : state_) {
+            state.fill(0.0);
         }
+        current_ = target_;
+        rampPending_ = false;
+        rampRemaining_ = 0;
+    }
+    
+    // Frames over which a coefficient change is interpolated
+    static constexpr int kRampFrames = 64;
+    
+    /**
+     * Coefficients designed from the current band parameters
+     * @return Snapshot suitable for setTargetCoefficients on another instance
+     */
+    CoefficientSet getCoefficientSet() const {
+        CoefficientSet set = target_;
+        set.bypass = bypass_;
+        return set;
+    }
+    
+    /**
+     * Replace the cascade coefficients without touching band parameters.
+     * Lets the audio thread take coefficients designed elsewhere; no trig
+     * runs here. The next kRampFrames processed frames ramp towards them.
+     * @param set Target coefficients (bypass switches immediately)
+     */
+    void setTargetCoefficients(const CoefficientSet& set) {
+        target_.bands = set.bands;
+        target_.active = set.active;
+        bypass_ = set.bypass;
+        rampPending_ = true;
     }
     
     // Band setters
@@ -152,6 +296,22 @@ public:
         }
     }
     
+    /**
+     * Set all three parameters of a band with a single coefficient design
+     * @param band Band index
+     * @param gainDb Gain in dB
+     * @param freq Center frequency in Hz
+     * @param q Q factor
+     */
+    void setBand(int band, double gainDb, double freq, double q) {
+        if (band >= 0 && band < NUM_BANDS) {
+            gains_[band] = std::max(MIN_GAIN, std::min(MAX_GAIN, gainDb));
+            frequencies_[band] = std::max(MIN_FREQ, std::min(MAX_FREQ, freq));
+            qFactors_[band] = std::max(MIN_Q, std::min(MAX_Q, q));
+            updateFilter(band);
+        }
+    }
+    
     void setBypass(bool bypass) { bypass_ = bypass; }
     
     // Band getters
@@ -168,44 +328,40 @@ public:
     
     // Process stereo sample
     void process(float& left, float& right) {
-        if (bypass_) return;
-        
-        for (int i = 0; i < NUM_BANDS; ++i) {
-            if (std::abs(gains_[i]) > 0.01) {
-                left = filters_[i].process(left, 0);
-                right = filters_[i].process(right, 1);
-            }
-        }
+        processStrided(&left, &right, &left, &right, 1, 1, 1);
     }
     
     // Process mono sample
     float processMono(float input) {
-        if (bypass_) return input;
-        
-        for (int i = 0; i < NUM_BANDS; ++i) {
-            if (std::abs(gains_[i]) > 0.01) {
-                input = filters_[i].process(input, 0);
-            }
-        }
+        processStrided(&input, &input, &input, static_cast<float*>(nullptr), 1, 1, 1);
         return input;
     }
     
-    // Process buffer (interleaved stereo)
+    // Process buffer (interleaved, first two channels are filtered)
     void processBlock(float* buffer, int numFrames, int numChannels) {
-        if (bypass_) return;
-        
-        for (int frame = 0; frame < numFrames; ++frame) {
-            for (int ch = 0; ch < numChannels && ch < 2; ++ch) {
-                float& sample = buffer[frame * numChannels + ch];
-                for (int band = 0; band < NUM_BANDS; ++band) {
-                    if (std::abs(gains_[band]) > 0.01) {
-                        sample = filters_[band].process(sample, ch);
-                    }
-                }
-            }
+        if (numChannels >= 2) {
+            processStrided(buffer, buffer + 1, buffer, buffer + 1, numFrames, numChannels, numChannels);
+        } else if (numChannels == 1) {
+            processStrided(buffer, buffer, buffer, static_cast<float*>(nullptr), numFrames, 1, 1);
         }
     }
     
+    // Process planar stereo buffers (in and out may alias)
+    void processStereo(const float* inL, const float* inR, float* outL, float* outR, int numFrames) {
+        processStrided(inL, inR, outL, outR, numFrames, 1, 1);
+    }
+    void processStereo(const double* inL, const double* inR, double* outL, double* outR, int numFrames) {
+        processStrided(inL, inR, outL, outR, numFrames, 1, 1);
+    }
+    
+    // Process planar mono buffer (in and out may alias)
+    void processMono(const float* in, float* out, int numFrames) {
+        processStrided(in, in, out, static_cast<float*>(nullptr), numFrames, 1, 1);
+    }
+    void processMono(const double* in, double* out, int numFrames) {
+        processStrided(in, in, out, static_cast<double*>(nullptr), numFrames, 1, 1);
+    }
+    
     // Get combined frequency response magnitude at a frequency (in dB)
     double getResponseAt(double freq) const {
         double totalMag = 1.0;
@@ -218,8 +374,162 @@ public:
     }
     
 private:
+    // Frames per pass through the band cascade (fits comfortably in L1)
+    static constexpr int kChunkFrames = 64;
+    
+    /**
+     * Block cascade shared by all process variants. After a coefficient
+     * change the first kRampFrames frames ramp linearly from the old to the
+     * new coefficients, however the caller splits its blocks, so a change
+     * starts on the frame it is processed at and never zippers.
+     * Mono passes the same input for both lanes and outR == nullptr.
+     * Sample is float or double; the cascade always runs in double.
+     */
+    template <typename Sample>
+    void processStrided(const Sample* inL, const Sample* inR, Sample* outL, Sample* outR,
+                        int numFrames, int inStride, int outStride) {
+        if (bypass_) {
+            current_ = target_;
+            rampPending_ = false;
+            rampRemaining_ = 0;
+            
+            if (inL != outL) {
+                for (int i = 0; i < numFrames; ++i) outL[i * outStride] = inL[i * inStride];
+            }
+            if (outR && inR != outR) {
+                for (int i = 0; i < numFrames; ++i) outR[i * outStride] = inR[i * inStride];
+            }
+            return;
+        }
+        
+        if (rampPending_) {
+            startRamp();
+        }
+        
+        int done = 0;
+        if (rampRemaining_ > 0) {
+            done = std::min(rampRemaining_, numFrames);
+            filterFrames<true>(inL, inR, outL, outR, done, inStride, outStride);
+            rampRemaining_ -= done;
+            if (rampRemaining_ == 0) {
+                finishRamp();
+            }
+        }
+        if (done < numFrames) {
+            filterFrames<false>(inL + done * inStride, inR + done * inStride, outL + done * outStride,
+                                outR ? outR + done * outStride : outR, numFrames - done, inStride, outStride);
+        }
+    }
+    
+    /**
+     * Run the cascade over frames with the current coefficients. Frames
+     * are converted to interleaved doubles once per chunk, then the active
+     * bands run over the chunk with their state held in registers. With
+     * Ramp the coefficients advance by rampSteps_ per frame and are stored
+     * back, so a ramp continues in the next call.
+     */
+    template <bool Ramp, typename Sample>
+    void filterFrames(const Sample* inL, const Sample* inR, Sample* outL, Sample* outR,
+                      int numFrames, int inStride, int outStride) {
+        // Active bands and their coefficients, gathered once per call
+        BiquadCoefficients coeffs[NUM_BANDS];
+        BiquadCoefficients steps[NUM_BANDS];
+        double* states[NUM_BANDS];
+        int bands[NUM_BANDS];
+        int numActive = 0;
+        for (int band = 0; band < NUM_BANDS; ++band) {
+            if (current_.active[band]) {
+                coeffs[numActive] = current_.bands[band];
+                steps[numActive] = rampSteps_[band];
+                states[numActive] = state_[band].data();
+                bands[numActive] = band;
+                ++numActive;
+            }
+        }
+        
+        alignas(16) double work[2 * kChunkFrames];
+        
+        for (int start = 0; start < numFrames; start += kChunkFrames) {
+            int count = std::min(kChunkFrames, numFrames - start);
+            const Sample* srcL = inL + start * inStride;
+            const Sample* srcR = inR + start * inStride;
+            
+            for (int i = 0; i < count; ++i) {
+                work[2 * i] = srcL[i * inStride];
+                work[2 * i + 1] = srcR[i * inStride];
+            }
+            
+            runCascade<Ramp>(coeffs, steps, states, numActive, work, count);
+            
+            Sample* dstL = outL + start * outStride;
+            for (int i = 0; i < count; ++i) {
+                dstL[i * outStride] = static_cast<Sample>(work[2 * i]);
+            }
+            if (outR) {
+                Sample* dstR = outR + start * outStride;
+                for (int i = 0; i < count; ++i) {
+                    dstR[i * outStride] = static_cast<Sample>(work[2 * i + 1]);
+                }
+            }
+        }
+        
+        if (Ramp) {
+            for (int k = 0; k < numActive; ++k) {
+                current_.bands[bands[k]] = coeffs[k];
+            }
+        }
+    }
+    
+    // Ramp from wherever the coefficients are now (possibly mid-ramp) to
+    // the target. Bands fading in or out stay active until it ends.
+    void startRamp() {
+        for (int band = 0; band < NUM_BANDS; ++band) {
+            current_.active[band] = current_.active[band] || target_.active[band];
+            rampSteps_[band] = rampStep(current_.bands[band], target_.bands[band], kRampFrames);
+        }
+        rampRemaining_ = kRampFrames;
+        rampPending_ = false;
+    }
+    
+    // Land exactly on the target; bands that faded out restart clean
+    void finishRamp() {
+        for (int band = 0; band < NUM_BANDS; ++band) {
+            if (current_.active[band] && !target_.active[band]) {
+                state_[band].fill(0.0);
+            }
+        }
+        current_ = target_;
+    }
+    
+    static BiquadCoefficients rampStep(const BiquadCoefficients& from,
+                                       const BiquadCoefficients& to, int numFrames) {
+        double inv = 1.0 / numFrames;
+        return {(to.b0 - from.b0) * inv, (to.b1 - from.b1) * inv, (to.b2 - from.b2) * inv,
+                (to.a1 - from.a1) * inv, (to.a2 - from.a2) * inv};
+    }
+    
+    // Dispatch to a cascade unrolled for the number of active bands
+    template <bool Ramp>
+    static void runCascade(BiquadCoefficients* coeffs, const BiquadCoefficients* steps,
+                           double* const* states, int numActive, double* work, int count) {
+        static_assert(NUM_BANDS == 5, "runCascade dispatch assumes 5 bands");
+        switch (numActive) {
+            case 1: detail::cascadeStereoTDF2<1, Ramp>(coeffs, steps, states, work, count); break;
+            case 2: detail::cascadeStereoTDF2<2, Ramp>(coeffs, steps, states, work, count); break;
+            case 3: detail::cascadeStereoTDF2<3, Ramp>(coeffs, steps, states, work, count); break;
+            case 4: detail::cascadeStereoTDF2<4, Ramp>(coeffs, steps, states, work, count); break;
+            case 5: detail::cascadeStereoTDF2<5, Ramp>(coeffs, steps, states, work, count); break;
+            default: break;
+        }
+    }
+    
     void updateFilter(int band) {
         filters_[band].setPeakingEQ(sampleRate_, frequencies_[band], gains_[band], qFactors_[band]);
+        
+        bool active = std::abs(gains_[band]) > 0.01;
+        target_.active[band] = active;
+        target_.bands[band] = active ? filters_[band].getCoefficients() : BiquadCoefficients{};
+        rampPending_ = true;
     }
     
     void updateAllFilters() {
@@ -235,6 +545,18 @@ private:
     std::array<double, NUM_BANDS> gains_;
     std::array<double, NUM_BANDS> qFactors_;
     std::array<BiquadFilter, NUM_BANDS> filters_;
+    
+    // Cascade state per band, TDF-II: {s1L, s1R, s2L, s2R}
+    std::array<std::array<double, 4>, NUM_BANDS> state_{};
+    
+    // Coefficients in use and the ones they ramp to
+    CoefficientSet current_;
+    CoefficientSet target_;
+    bool rampPending_ = false;
+    
+    // Ramp in progress: per-frame increments and frames left
+    std::array<BiquadCoefficients, NUM_BANDS> rampSteps_{};
+    int rampRemaining_ = 0;
 };
 
 } // namespace eq
@@ -0,0 +1,173 @@
+#pragma once
+
+/**
+ * Cached EQ magnitude response for display
+ *
+ * Evaluates the exact biquad response of every band over a fixed table of
+ * display frequencies (typically one per pixel) and keeps each band's
+ * curve, so a band is re-evaluated only when its parameters change and an
+ * idle EQ costs nothing per frame. The trig terms of each frequency are
+ * tabulated once per layout; evaluating a band is then a branch-free loop
+ * over structure-of-arrays tables. Shared by the standalone visualizer and
+ * the VST editor. Header-only, like eq_processor.hpp.
+ */
+
+#include "eq_processor.hpp"
+#include <vector>
+
+namespace eq {
+
+/**
+ * Magnitude response of one biquad in dB over precomputed trig tables
+ * @param c Normalized coefficients
+ * @param cosw cos(w) per point, w = 2 pi f / sampleRate
+ * @param sinw sin(w) per point
+ * @param cos2w cos(2w) per point
+ * @param sin2w sin(2w) per point
+ * @param db Output, count values
+ * @param count Number of points
+ */
+inline void magnitudeResponseDb(const BiquadCoefficients& c,
+                                const double* cosw, const double* sinw,
+                                const double* cos2w, const double* sin2w,
+                                float* db, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        // Same terms as BiquadFilter::getMagnitudeAt, squared to skip the roots
+        double numReal = c.b0 + c.b1 * cosw[i] + c.b2 * cos2w[i];
+        double numImag = -c.b1 * sinw[i] - c.b2 * sin2w[i];
+        double denReal = 1.0 + c.a1 * cosw[i] + c.a2 * cos2w[i];
+        double denImag = -c.a1 * sinw[i] - c.a2 * sin2w[i];
+
+        double numPower = numReal * numReal + numImag * numImag;
+        double denPower = denReal * denReal + denImag * denImag;
+        db[i] = static_cast<float>(10.0 * std::log10(numPower / denPower));
+    }
+}
+
+class ResponseCache {
+public:
+    /**
+     * Set the display frequencies; all bands are re-evaluated if anything changed
+     * @param numPoints Number of points, log-spaced from minFreq to maxFreq inclusive
+     * @param minFreq Frequency of the first point in Hz
+     * @param maxFreq Frequency of the last point in Hz
+     * @param sampleRate Sample rate the filters are designed for in Hz
+     */
+    void setLayout(int numPoints, double minFreq, double maxFreq, double sampleRate) {
+        numPoints = std::max(numPoints, 0);
+        if (numPoints == numPoints_ && minFreq == minFreq_ && maxFreq == maxFreq_ &&
+            sampleRate == sampleRate_) {
+            return;
+        }
+        numPoints_ = numPoints;
+        minFreq_ = minFreq;
+        maxFreq_ = maxFreq;
+        sampleRate_ = sampleRate;
+
+        size_t count = static_cast<size_t>(numPoints);
+        cosw_.resize(count);
+        sinw_.resize(count);
+        cos2w_.resize(count);
+        sin2w_.resize(count);
+
+        double logMin = std::log10(minFreq);
+        double logRange = std::log10(maxFreq) - logMin;
+        for (size_t i = 0; i < count; ++i) {
+            double xNorm = count > 1 ? static_cast<double>(i) / (count - 1) : 0.0;
+            double freq = std::pow(10.0, logMin + xNorm * logRange);
+            double w = 2.0 * M_PI * freq / sampleRate;
+            cosw_[i] = std::cos(w);
+            sinw_[i] = std::sin(w);
+            cos2w_[i] = std::cos(2.0 * w);
+            sin2w_[i] = std::sin(2.0 * w);
+        }
+
+        for (auto& band : bands_) {
+            band.db.assign(count, 0.0f);
+            band.dirty = true;
+        }
+        response_.assign(count, 0.0f);
+        responseDirty_ = true;
+    }
+
+    /**
+     * Update one band; it is re-evaluated by the next response() only if
+     * a parameter actually changed
+     * @param band Band index
+     * @param frequency Center frequency in Hz
+     * @param gainDb Gain in dB (bands within 0.01 dB of 0 are off, as in EQProcessor)
+     * @param q Q factor
+     */
+    void setBand(int band, double frequency, double gainDb, double q) {
+        if (band < 0 || band >= NUM_BANDS) return;
+
+        BandState& state = bands_[band];
+        if (frequency == state.frequency && gainDb == state.gainDb && q == state.q) return;
+        state.frequency = frequency;
+        state.gainDb = gainDb;
+        state.q = q;
+        state.dirty = true;
+    }
+
+    /**
+     * Combined response of all bands in dB, one value per display point
+     */
+    const std::vector<float>& response() {
+        size_t count = static_cast<size_t>(numPoints_);
+        for (auto& band : bands_) {
+            if (!band.dirty) continue;
+            band.dirty = false;
+            responseDirty_ = true;
+
+            band.active = std::abs(band.gainDb) > 0.01;
+            if (!band.active) continue;
+
+            BiquadFilter filter;
+            filter.setPeakingEQ(sampleRate_, band.frequency, band.gainDb, band.q);
+            magnitudeResponseDb(filter.getCoefficients(), cosw_.data(), sinw_.data(),
+                                cos2w_.data(), sin2w_.data(), band.db.data(), count);
+        }
+
+        if (responseDirty_) {
+            // Cascaded magnitudes multiply, so their dB values add
+            std::fill(response_.begin(), response_.end(), 0.0f);
+            for (const auto& band : bands_) {
+                if (!band.active) continue;
+                for (size_t i = 0; i < count; ++i) {
+                    response_[i] += band.db[i];
+                }
+            }
+            responseDirty_ = false;
+        }
+        return response_;
+    }
+
+    int numPoints() const { return numPoints_; }
+
+private:
+    struct BandState {
+        double frequency = 0.0;
+        double gainDb = 0.0;
+        double q = 0.0;
+        bool active = false;
+        bool dirty = true;
+        std::vector<float> db;      // This band's response per point
+    };
+
+    int numPoints_ = 0;
+    double minFreq_ = 0.0;
+    double maxFreq_ = 0.0;
+    double sampleRate_ = 0.0;
+
+    // Trig terms per point
+    std::vector<double> cosw_;
+    std::vector<double> sinw_;
+    std::vector<double> cos2w_;
+    std::vector<double> sin2w_;
+
+    std::array<BandState, NUM_BANDS> bands_{};
+    std::vector<float> response_;
+    bool responseDirty_ = true;
+};
+
+} // namespace eq
@@ -1,9 +1,19 @@
 #include "fft.hpp"
 #include <algorithm>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
 
-// Safe max macro
-#define SAFE_MAX(a, b) (((a) > (b)) ? (a) : (b))
+// Spectrum kernels: SSE2 on x86-64, NEON on AArch64, scalar otherwise
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FFT_SIMD_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define FFT_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
 
 namespace fft {
 
@@ -25,58 +35,147 @@ size_t nextPowerOf2(size_t n) {
     return n + 1;
 }
 
-// Bit-reversal permutation
-static void bitReversePermute(ComplexVector& data) {
-    size_t n = data.size();
-    size_t j = 0;
+// Bit-reversal permutation table for n points (n power of 2)
+static std::vector<uint32_t> makeBitReverseTable(size_t n) {
+    std::vector<uint32_t> table(n, 0);
+    size_t bits = 0;
+    while ((static_cast<size_t>(1) << bits) < n) ++bits;
     
-    for (size_t i = 0; i < n - 1; ++i) {
-        if (i < j) {
-            std::swap(data[i], data[j]);
-        }
-        
-        size_t k = n >> 1;
-        while (k <= j) {
-            j -= k;
-            k >>= 1;
+    for (size_t i = 0; i < n; ++i) {
+        size_t r = 0;
+        for (size_t b = 0; b < bits; ++b) {
+            if (i & (static_cast<size_t>(1) << b)) {
+                r |= static_cast<size_t>(1) << (bits - 1 - b);
+            }
         }
-        j += k;
+        table[i] = static_cast<uint32_t>(r);
     }
+    
+    return table;
 }
 
-void transformInPlace(ComplexVector& data) {
-    size_t n = data.size();
-    
-    if (!isPowerOf2(n)) {
+Plan::Plan(size_t size) : size_(size) {
+    if (size < 2 || !isPowerOf2(size)) {
         throw std::invalid_argument("FFT size must be a power of 2");
     }
     
-    if (n <= 1) return;
+    // Twiddles are computed directly rather than by repeated multiplication,
+    // which keeps rounding error flat across the table
+    twiddles_.resize(size / 2);
+    for (size_t k = 0; k < size / 2; ++k) {
+        double angle = -2.0 * PI * static_cast<double>(k) / static_cast<double>(size);
+        twiddles_[k] = Complex(std::cos(angle), std::sin(angle));
+    }
     
-    // Bit-reversal permutation
-    bitReversePermute(data);
+    bitReverse_ = makeBitReverseTable(size);
+    halfBitReverse_ = makeBitReverseTable(size / 2);
+}
+
+// Iterative radix-2 butterflies over already permuted data.
+// Stage twiddles for a transform of n points are every (stride * N / n)-th
+// entry of the size-N table.
+void Plan::transformCore(Complex* data, size_t n, size_t twiddleStride) const {
+    // First stage has unit twiddles only
+    for (size_t i = 0; i + 1 < n; i += 2) {
+        Complex u = data[i];
+        Complex t = data[i + 1];
+        data[i] = u + t;
+        data[i + 1] = u - t;
+    }
     
-    // Cooley-Tukey iterative FFT
-    for (size_t len = 2; len <= n; len <<= 1) {
-        double angle = -2.0 * PI / static_cast<double>(len);
-        Complex wlen(std::cos(angle), std::sin(angle));
+    for (size_t len = 4; len <= n; len <<= 1) {
+        size_t halfLen = len / 2;
+        size_t step = twiddleStride * (n / len);
         
         for (size_t i = 0; i < n; i += len) {
-            Complex w(1.0, 0.0);
-            
-            for (size_t j = 0; j < len / 2; ++j) {
+            for (size_t j = 0; j < halfLen; ++j) {
+                const Complex& w = twiddles_[j * step];
                 Complex u = data[i + j];
-                Complex t = w * data[i + j + len / 2];
+                const Complex& v = data[i + j + halfLen];
+                Complex t(w.real() * v.real() - w.imag() * v.imag(),
+                          w.real() * v.imag() + w.imag() * v.real());
                 
                 data[i + j] = u + t;
-                data[i + j + len / 2] = u - t;
-                
-                w *= wlen;
+                data[i + j + halfLen] = u - t;
             }
         }
     }
 }
 
+void Plan::forward(Complex* data) const {
+    for (size_t i = 0; i < size_; ++i) {
+        size_t j = bitReverse_[i];
+        if (i < j) {
+            std::swap(data[i], data[j]);
+        }
+    }
+    
+    transformCore(data, size_, 1);
+}
+
+void Plan::forwardReal(const double* input, Complex* output) const {
+    size_t half = size_ / 2;
+    
+    // Pack even/odd samples as one complex point each, written straight
+    // into bit-reversed order
+    for (size_t n = 0; n < half; ++n) {
+        output[halfBitReverse_[n]] = Complex(input[2 * n], input[2 * n + 1]);
+    }
+    
+    transformCore(output, half, 2);
+    
+    // Untangle: X[k] = E[k] + W^k O[k], where E/O are the spectra of the
+    // even and odd samples. Bins k and half-k are processed together so the
+    // split can run in place.
+    Complex z0 = output[0];
+    output[0] = Complex(z0.real() + z0.imag(), 0.0);
+    output[half] = Complex(z0.real() - z0.imag(), 0.0);
+    
+    for (size_t k = 1; k <= half / 2; ++k) {
+        size_t m = half - k;
+        Complex a = output[k];
+        Complex b = std::conj(output[m]);
+        
+        Complex even = 0.5 * (a + b);
+        Complex diff = 0.5 * (a - b);
+        Complex odd(diff.imag(), -diff.real());  // diff / i
+        
+        Complex t = twiddles_[k] * odd;
+        output[k] = even + t;
+        if (m != k) {
+            output[m] = std::conj(even - t);
+        }
+    }
+}
+
+// Per-thread plan cache backing the allocating convenience API
+static const Plan& cachedPlan(size_t n) {
+    thread_local std::vector<std::unique_ptr<Plan>> plans;
+    
+    size_t log2n = 0;
+    while ((static_cast<size_t>(1) << log2n) < n) ++log2n;
+    
+    if (plans.size() <= log2n) {
+        plans.resize(log2n + 1);
+    }
+    if (!plans[log2n]) {
+        plans[log2n] = std::make_unique<Plan>(n);
+    }
+    return *plans[log2n];
+}
+
+void transformInPlace(ComplexVector& data) {
+    size_t n = data.size();
+    
+    if (!isPowerOf2(n)) {
+        throw std::invalid_argument("FFT size must be a power of 2");
+    }
+    
+    if (n <= 1) return;
+    
+    cachedPlan(n).forward(data.data());
+}
+
 ComplexVector transform(const std::vector<double>& signal) {
     size_t n = nextPowerOf2(signal.size());
     ComplexVector data(n, Complex(0.0, 0.0));
@@ -109,71 +208,332 @@ ComplexVector inverse(const ComplexVector& spectrum) {
     return data;
 }
 
+// log2(1 + t) ~ t * (c1 + t * (c2 + t * (c3 + t * c4))) on [0, 1),
+// least-squares fit with |error| < 1.1e-4 (0.0003 dB)
+constexpr float kLog2C1 = 1.4390175f;
+constexpr float kLog2C2 = -0.6799792f;
+constexpr float kLog2C3 = 0.3256841f;
+constexpr float kLog2C4 = -0.0848279f;
+
+// 10 * log10(2): converts log2 of a power to dB
+constexpr float kDbPerLog2 = 3.0103000f;
+
+// Bins per fused chunk (stays in L1 between the two passes)
+constexpr size_t kDbChunk = 256;
+
+// Scalar reference of the vector kernels: exponent from the float bits,
+// mantissa in [1, 2) through the polynomial
+static float fastPowerToDb(float x, float minDb) {
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    float exponent = static_cast<float>(static_cast<int32_t>(bits >> 23) - 127);
+    
+    uint32_t mantissaBits = (bits & 0x007FFFFFu) | 0x3F800000u;
+    float mantissa;
+    std::memcpy(&mantissa, &mantissaBits, sizeof(mantissa));
+    float t = mantissa - 1.0f;
+    
+    float poly = t * (kLog2C1 + t * (kLog2C2 + t * (kLog2C3 + t * kLog2C4)));
+    float db = (exponent + poly) * kDbPerLog2;
+    return db > minDb ? db : minDb;
+}
+
 std::vector<double> magnitude(const ComplexVector& spectrum) {
     std::vector<double> result(spectrum.size());
+    magnitude(spectrum.data(), spectrum.size(), result.data());
+    return result;
+}
+
+void magnitude(const Complex* spectrum, size_t count, double* output) {
+    // Complex values are stored as (re, im) pairs
+    const double* data = reinterpret_cast<const double*>(spectrum);
+    size_t i = 0;
     
-    for (size_t i = 0; i < spectrum.size(); ++i) {
-        result[i] = std::abs(spectrum[i]);
+#if defined(FFT_SIMD_SSE2)
+    for (; i + 2 <= count; i += 2) {
+        __m128d a = _mm_loadu_pd(data + 2 * i);
+        __m128d b = _mm_loadu_pd(data + 2 * i + 2);
+        a = _mm_mul_pd(a, a);
+        b = _mm_mul_pd(b, b);
+        __m128d sum = _mm_add_pd(_mm_unpacklo_pd(a, b), _mm_unpackhi_pd(a, b));
+        _mm_storeu_pd(output + i, _mm_sqrt_pd(sum));
     }
+#elif defined(FFT_SIMD_NEON)
+    for (; i + 2 <= count; i += 2) {
+        float64x2x2_t z = vld2q_f64(data + 2 * i);
+        float64x2_t sum = vfmaq_f64(vmulq_f64(z.val[0], z.val[0]), z.val[1], z.val[1]);
+        vst1q_f64(output + i, vsqrtq_f64(sum));
+    }
+#endif
     
-    return result;
+    // No hypot: bins are far from overflow
+    for (; i < count; ++i) {
+        double re = data[2 * i];
+        double im = data[2 * i + 1];
+        output[i] = std::sqrt(re * re + im * im);
+    }
 }
 
-std::vector<double> powerDb(const ComplexVector& spectrum, double minDb) {
-    std::vector<double> result(spectrum.size());
-    double refPower = 1.0;
+void power(const Complex* spectrum, size_t count, double scale, float* output) {
+    const double* data = reinterpret_cast<const double*>(spectrum);
+    size_t i = 0;
     
-    for (size_t i = 0; i < spectrum.size(); ++i) {
-        double mag = std::abs(spectrum[i]);
-        double power = mag * mag;
-        
-        if (power > 0) {
-            result[i] = 10.0 * std::log10(power / refPower);
-            result[i] = SAFE_MAX(result[i], minDb);
-        } else {
-            result[i] = minDb;
-        }
+#if defined(FFT_SIMD_SSE2)
+    __m128d s = _mm_set1_pd(scale);
+    for (; i + 4 <= count; i += 4) {
+        __m128d a = _mm_loadu_pd(data + 2 * i);
+        __m128d b = _mm_loadu_pd(data + 2 * i + 2);
+        __m128d c = _mm_loadu_pd(data + 2 * i + 4);
+        __m128d d = _mm_loadu_pd(data + 2 * i + 6);
+        a = _mm_mul_pd(a, a);
+        b = _mm_mul_pd(b, b);
+        c = _mm_mul_pd(c, c);
+        d = _mm_mul_pd(d, d);
+        __m128d low = _mm_mul_pd(_mm_add_pd(_mm_unpacklo_pd(a, b), _mm_unpackhi_pd(a, b)), s);
+        __m128d high = _mm_mul_pd(_mm_add_pd(_mm_unpacklo_pd(c, d), _mm_unpackhi_pd(c, d)), s);
+        _mm_storeu_ps(output + i, _mm_movelh_ps(_mm_cvtpd_ps(low), _mm_cvtpd_ps(high)));
     }
+#elif defined(FFT_SIMD_NEON)
+    float64x2_t s = vdupq_n_f64(scale);
+    for (; i + 4 <= count; i += 4) {
+        float64x2x2_t z0 = vld2q_f64(data + 2 * i);
+        float64x2x2_t z1 = vld2q_f64(data + 2 * i + 4);
+        float64x2_t p0 = vfmaq_f64(vmulq_f64(z0.val[0], z0.val[0]), z0.val[1], z0.val[1]);
+        float64x2_t p1 = vfmaq_f64(vmulq_f64(z1.val[0], z1.val[0]), z1.val[1], z1.val[1]);
+        float32x2_t low = vcvt_f32_f64(vmulq_f64(p0, s));
+        vst1q_f32(output + i, vcvt_high_f32_f64(low, vmulq_f64(p1, s)));
+    }
+#endif
     
-    return result;
+    for (; i < count; ++i) {
+        double re = data[2 * i];
+        double im = data[2 * i + 1];
+        output[i] = static_cast<float>((re * re + im * im) * scale);
+    }
 }
 
-std::vector<double> applyHannWindow(const std::vector<double>& signal) {
-    std::vector<double> result(signal.size());
-    size_t n = signal.size();
+void power(const Complex* spectrum, size_t count, double* output) {
+    const double* data = reinterpret_cast<const double*>(spectrum);
+    size_t i = 0;
     
-    for (size_t i = 0; i < n; ++i) {
-        double multiplier = 0.5 * (1.0 - std::cos(2.0 * PI * i / (n - 1)));
-        result[i] = signal[i] * multiplier;
+#if defined(FFT_SIMD_SSE2)
+    for (; i + 2 <= count; i += 2) {
+        __m128d a = _mm_loadu_pd(data + 2 * i);
+        __m128d b = _mm_loadu_pd(data + 2 * i + 2);
+        a = _mm_mul_pd(a, a);
+        b = _mm_mul_pd(b, b);
+        _mm_storeu_pd(output + i, _mm_add_pd(_mm_unpacklo_pd(a, b), _mm_unpackhi_pd(a, b)));
+    }
+#elif defined(FFT_SIMD_NEON)
+    for (; i + 2 <= count; i += 2) {
+        float64x2x2_t z = vld2q_f64(data + 2 * i);
+        vst1q_f64(output + i, vfmaq_f64(vmulq_f64(z.val[0], z.val[0]), z.val[1], z.val[1]));
     }
+#endif
     
-    return result;
+    for (; i < count; ++i) {
+        double re = data[2 * i];
+        double im = data[2 * i + 1];
+        output[i] = re * re + im * im;
+    }
 }
 
-std::vector<double> applyHammingWindow(const std::vector<double>& signal) {
-    std::vector<double> result(signal.size());
-    size_t n = signal.size();
+void powerToDb(const float* power, size_t count, float minDb, float* output) {
+    size_t i = 0;
     
-    for (size_t i = 0; i < n; ++i) {
-        double multiplier = 0.54 - 0.46 * std::cos(2.0 * PI * i / (n - 1));
-        result[i] = signal[i] * multiplier;
+#if defined(FFT_SIMD_SSE2)
+    const __m128i mantissaMask = _mm_set1_epi32(0x007FFFFF);
+    const __m128i oneBits = _mm_set1_epi32(0x3F800000);
+    const __m128i bias = _mm_set1_epi32(127);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 floorDb = _mm_set1_ps(minDb);
+    
+    for (; i + 4 <= count; i += 4) {
+        __m128i bits = _mm_castps_si128(_mm_loadu_ps(power + i));
+        __m128 exponent = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), bias));
+        __m128 t = _mm_sub_ps(_mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, mantissaMask), oneBits)), one);
+        
+        __m128 poly = _mm_add_ps(_mm_set1_ps(kLog2C3), _mm_mul_ps(t, _mm_set1_ps(kLog2C4)));
+        poly = _mm_add_ps(_mm_set1_ps(kLog2C2), _mm_mul_ps(t, poly));
+        poly = _mm_add_ps(_mm_set1_ps(kLog2C1), _mm_mul_ps(t, poly));
+        poly = _mm_mul_ps(t, poly);
+        
+        __m128 db = _mm_mul_ps(_mm_add_ps(exponent, poly), _mm_set1_ps(kDbPerLog2));
+        _mm_storeu_ps(output + i, _mm_max_ps(db, floorDb));
     }
+#elif defined(FFT_SIMD_NEON)
+    const uint32x4_t mantissaMask = vdupq_n_u32(0x007FFFFF);
+    const uint32x4_t oneBits = vdupq_n_u32(0x3F800000);
+    const int32x4_t bias = vdupq_n_s32(127);
+    const float32x4_t floorDb = vdupq_n_f32(minDb);
     
-    return result;
+    for (; i + 4 <= count; i += 4) {
+        uint32x4_t bits = vreinterpretq_u32_f32(vld1q_f32(power + i));
+        float32x4_t exponent = vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)), bias));
+        float32x4_t t = vsubq_f32(vreinterpretq_f32_u32(vorrq_u32(vandq_u32(bits, mantissaMask), oneBits)),
+                                  vdupq_n_f32(1.0f));
+        
+        float32x4_t poly = vfmaq_f32(vdupq_n_f32(kLog2C3), t, vdupq_n_f32(kLog2C4));
+        poly = vfmaq_f32(vdupq_n_f32(kLog2C2), t, poly);
+        poly = vfmaq_f32(vdupq_n_f32(kLog2C1), t, poly);
+        poly = vmulq_f32(t, poly);
+        
+        float32x4_t db = vmulq_f32(vaddq_f32(exponent, poly), vdupq_n_f32(kDbPerLog2));
+        vst1q_f32(output + i, vmaxq_f32(db, floorDb));
+    }
+#endif
+    
+    for (; i < count; ++i) {
+        output[i] = fastPowerToDb(power[i], minDb);
+    }
 }
 
-std::vector<double> applyBlackmanWindow(const std::vector<double>& signal) {
+void powerDb(const Complex* spectrum, size_t count, double scale, float minDb, float* output) {
+    for (size_t i = 0; i < count; i += kDbChunk) {
+        size_t n = (std::min)(kDbChunk, count - i);
+        power(spectrum + i, n, scale, output + i);
+        powerToDb(output + i, n, minDb, output + i);
+    }
+}
+
+std::vector<double> powerDb(const ComplexVector& spectrum, double minDb) {
+    std::vector<float> db(spectrum.size());
+    powerDb(spectrum.data(), spectrum.size(), 1.0, static_cast<float>(minDb), db.data());
+    return std::vector<double>(db.begin(), db.end());
+}
+
+void powerToDb(const double* power, size_t count, float minDb, float* output) {
+    // Narrow into the output, convert in place
+    for (size_t i = 0; i < count; i += kDbChunk) {
+        size_t n = (std::min)(kDbChunk, count - i);
+        for (size_t j = 0; j < n; ++j) {
+            output[i + j] = static_cast<float>(power[i + j]);
+        }
+        powerToDb(output + i, n, minDb, output + i);
+    }
+}
+
+void amplitudeToDb(const double* amplitude, size_t count, float minDb, float* output) {
+    // 20*log10(a) == 10*log10(a^2): square into the output, convert in place
+    for (size_t i = 0; i < count; i += kDbChunk) {
+        size_t n = (std::min)(kDbChunk, count - i);
+        for (size_t j = 0; j < n; ++j) {
+            double a = amplitude[i + j];
+            output[i + j] = static_cast<float>(a * a);
+        }
+        powerToDb(output + i, n, minDb, output + i);
+    }
+}
+
+const char* windowName(WindowType type) {
+    switch (type) {
+        case WindowType::Hann:           return "Hann";
+        case WindowType::Hamming:        return "Hamming";
+        case WindowType::Blackman:       return "Blackman";
+        case WindowType::BlackmanHarris: return "Blackman-Harris";
+        case WindowType::FlatTop:        return "Flat-top";
+    }
+    return "Unknown";
+}
+
+// Cosine-sum coefficients: w[i] = a0 - a1 cos(x) + a2 cos(2x) - a3 cos(3x) + a4 cos(4x)
+static std::vector<double> cosineSumTerms(WindowType type) {
+    switch (type) {
+        case WindowType::Hamming:        return {0.54, 0.46};
+        case WindowType::Blackman:       return {0.42, 0.5, 0.08};
+        case WindowType::BlackmanHarris: return {0.35875, 0.48829, 0.14128, 0.01168};
+        case WindowType::FlatTop:        return {0.21557895, 0.41663158, 0.277263158, 0.083578947, 0.006947368};
+        case WindowType::Hann:
+        default:                         return {0.5, 0.5};
+    }
+}
+
+static std::vector<double> buildWindow(WindowType type, size_t size) {
+    std::vector<double> coefficients(size, 1.0);
+    if (size < 2) return coefficients;
+
+    std::vector<double> terms = cosineSumTerms(type);
+    for (size_t i = 0; i < size; ++i) {
+        double value = terms[0];
+        for (size_t k = 1; k < terms.size(); ++k) {
+            double term = terms[k] * std::cos(2.0 * PI * static_cast<double>(k) * i / (size - 1));
+            value += (k % 2 == 1) ? -term : term;
+        }
+        coefficients[i] = value;
+    }
+    return coefficients;
+}
+
+static double meanOf(const std::vector<double>& values) {
+    double sum = 0.0;
+    for (double value : values) {
+        sum += value;
+    }
+    return values.empty() ? 0.0 : sum / values.size();
+}
+
+std::shared_ptr<const WindowTable> cachedWindow(WindowType type, size_t size) {
+    static std::mutex mutex;
+    static std::map<std::pair<WindowType, size_t>, std::shared_ptr<const WindowTable>> tables;
+
+    size = (std::max)(size, static_cast<size_t>(1));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto key = std::make_pair(type, size);
+    auto found = tables.find(key);
+    if (found != tables.end()) {
+        return found->second;
+    }
+
+    auto table = std::make_shared<WindowTable>();
+    table->type = type;
+    table->coefficients = buildWindow(type, size);
+    table->coherentGain = meanOf(table->coefficients);
+
+    // Same expression on both sides for Hann, so its correction is exactly 1
+    double hannGain = type == WindowType::Hann ? table->coherentGain
+                                               : meanOf(buildWindow(WindowType::Hann, size));
+    table->hannCorrection = table->coherentGain > 0.0 ? hannGain / table->coherentGain : 1.0;
+
+    tables.emplace(key, table);
+    return table;
+}
+
+template <typename Sample>
+static void multiplyWindow(const WindowTable& window, const Sample* input, double* output) {
+    const double* coefficients = window.coefficients.data();
+    for (size_t i = 0; i < window.size(); ++i) {
+        output[i] = input[i] * coefficients[i];
+    }
+}
+
+void applyWindow(const WindowTable& window, const float* input, double* output) {
+    multiplyWindow(window, input, output);
+}
+
+void applyWindow(const WindowTable& window, const double* input, double* output) {
+    multiplyWindow(window, input, output);
+}
+
+static std::vector<double> windowed(const std::vector<double>& signal, WindowType type) {
     std::vector<double> result(signal.size());
-    size_t n = signal.size();
-    
-    for (size_t i = 0; i < n; ++i) {
-        double multiplier = 0.42 - 0.5 * std::cos(2.0 * PI * i / (n - 1)) 
-                          + 0.08 * std::cos(4.0 * PI * i / (n - 1));
-        result[i] = signal[i] * multiplier;
+    if (!signal.empty()) {
+        applyWindow(*cachedWindow(type, signal.size()), signal.data(), result.data());
     }
-    
     return result;
 }
 
+std::vector<double> applyHannWindow(const std::vector<double>& signal) {
+    return windowed(signal, WindowType::Hann);
+}
+
+std::vector<double> applyHammingWindow(const std::vector<double>& signal) {
+    return windowed(signal, WindowType::Hamming);
+}
+
+std::vector<double> applyBlackmanWindow(const std::vector<double>& signal) {
+    return windowed(signal, WindowType::Blackman);
+}
+
 } // namespace fft
 
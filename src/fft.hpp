@@ -3,6 +3,8 @@
 #include <complex>
 #include <vector>
 #include <cmath>
+#include <cstdint>
+#include <memory>
 
 namespace fft {
 
@@ -24,6 +26,56 @@ ComplexVector transform(const std::vector<double>& signal);
  */
 void transformInPlace(ComplexVector& data);
 
+/**
+ * Precomputed FFT plan for a fixed transform size
+ * Twiddle factors and bit-reversal tables are built once at construction,
+ * so repeated transforms do no trig and no heap allocation. A plan is
+ * immutable after construction and can be shared between threads.
+ */
+class Plan {
+public:
+    /**
+     * @param size Transform size (power of 2, at least 2)
+     */
+    explicit Plan(size_t size);
+
+    /**
+     * Get the transform size
+     * @return Number of time-domain points
+     */
+    size_t size() const { return size_; }
+
+    /**
+     * Get the number of bins produced by forwardReal
+     * @return size() / 2 + 1 (DC through Nyquist)
+     */
+    size_t numBins() const { return size_ / 2 + 1; }
+
+    /**
+     * Real-to-complex forward transform
+     * Packs the real input into size()/2 complex points, runs a half-size
+     * complex FFT and untangles the result.
+     *
+     * @param input size() real samples
+     * @param output Caller-owned buffer of numBins() bins
+     */
+    void forwardReal(const double* input, Complex* output) const;
+
+    /**
+     * In-place complex forward transform of size() points
+     * @param data Caller-owned buffer of size() points
+     */
+    void forward(Complex* data) const;
+
+private:
+    void transformCore(Complex* data, size_t n, size_t twiddleStride) const;
+
+    size_t size_;
+    std::vector<Complex> twiddles_;           // exp(-2*pi*i*k/N), k < N/2
+    std::vector<uint32_t> bitReverse_;        // Permutation for N points
+    std::vector<uint32_t> halfBitReverse_;    // Permutation for N/2 points
+};
+
 /**
  * Inverse FFT
  * @param spectrum Frequency domain data
@@ -38,6 +90,31 @@ ComplexVector inverse(const ComplexVector& spectrum);
  */
 std::vector<double> magnitude(const ComplexVector& spectrum);
 
+/**
+ * Compute magnitude spectrum into a caller-owned buffer
+ * @param spectrum Complex FFT output
+ * @param count Number of bins
+ * @param output Magnitude values (count entries)
+ */
+void magnitude(const Complex* spectrum, size_t count, double* output);
+
+/**
+ * Compute power spectrum (magnitude squared, no square root)
+ * @param spectrum Complex FFT output
+ * @param count Number of bins
+ * @param scale Factor applied to every power value (e.g. squared normalization)
+ * @param output Power values (count entries)
+ */
+void power(const Complex* spectrum, size_t count, double scale, float* output);
+
+/**
+ * Compute power spectrum into a caller-owned double buffer (unscaled)
+ * @param spectrum Complex FFT output
+ * @param count Number of bins
+ * @param output Power values (count entries)
+ */
+void power(const Complex* spectrum, size_t count, double* output);
+
 /**
  * Compute power spectrum (magnitude squared) in dB
  * @param spectrum Complex FFT output
@@ -46,6 +123,102 @@ std::vector<double> magnitude(const ComplexVector& spectrum);
  */
 std::vector<double> powerDb(const ComplexVector& spectrum, double minDb = -100.0);
 
+/**
+ * Compute power spectrum in dB into a caller-owned buffer
+ * Fuses power() and powerToDb() in cache-sized chunks.
+ *
+ * @param spectrum Complex FFT output
+ * @param count Number of bins
+ * @param scale Factor applied to every power value before conversion
+ * @param minDb Floor for the output (silent bins read as minDb)
+ * @param output dB values (count entries)
+ */
+void powerDb(const Complex* spectrum, size_t count, double scale, float minDb, float* output);
+
+/**
+ * Convert power values to dB (10*log10)
+ * Uses the float exponent and a polynomial for the mantissa instead of
+ * calling log10; the error is below 0.001 dB. May run in place.
+ *
+ * @param power Power values (>= 0)
+ * @param count Number of values
+ * @param minDb Floor for the output (0 reads as minDb)
+ * @param output dB values (count entries)
+ */
+void powerToDb(const float* power, size_t count, float minDb, float* output);
+
+/**
+ * Convert double power values to dB (10*log10), same approximation
+ * @param power Power values (>= 0)
+ * @param count Number of values
+ * @param minDb Floor for the output (0 reads as minDb)
+ * @param output dB values (count entries)
+ */
+void powerToDb(const double* power, size_t count, float minDb, float* output);
+
+/**
+ * Convert linear amplitudes to dB (20*log10), same approximation as powerToDb
+ * @param amplitude Amplitudes (>= 0)
+ * @param count Number of values
+ * @param minDb Floor for the output (0 reads as minDb)
+ * @param output dB values (count entries)
+ */
+void amplitudeToDb(const double* amplitude, size_t count, float minDb, float* output);
+
+/**
+ * Window functions available as cached tables
+ */
+enum class WindowType {
+    Hann,
+    Hamming,
+    Blackman,
+    BlackmanHarris,     // 4-term, -92 dB sidelobes
+    FlatTop             // Accurate amplitudes, wide main lobe
+};
+
+/**
+ * Get the display name of a window type
+ */
+const char* windowName(WindowType type);
+
+/**
+ * Precomputed window coefficients for one (type, size)
+ * Built once by cachedWindow() and shared read-only between threads.
+ */
+struct WindowTable {
+    WindowType type = WindowType::Hann;
+    std::vector<double> coefficients;   // Symmetric, size() points
+
+    // Mean coefficient: the amplitude a bin-centred sine reads after windowing
+    double coherentGain = 0.0;
+
+    // Hann coherent gain / coherentGain for the same size. Multiplying
+    // amplitudes by it keeps levels calibrated like the Hann window the
+    // analyzers' scaling assumes (exactly 1 for Hann).
+    double hannCorrection = 1.0;
+
+    size_t size() const { return coefficients.size(); }
+};
+
+/**
+ * Get the shared window table for a type and size, building it on first use
+ * Takes a lock and may allocate: call from setup code, not the audio thread.
+ *
+ * @param type Window function
+ * @param size Number of points (at least 1)
+ * @return Immutable table, kept alive by the cache and every holder
+ */
+std::shared_ptr<const WindowTable> cachedWindow(WindowType type, size_t size);
+
+/**
+ * Multiply window.size() samples by a window (may run in place for double input)
+ * @param window Window table
+ * @param input Samples to window
+ * @param output Windowed samples (window.size() entries)
+ */
+void applyWindow(const WindowTable& window, const float* input, double* output);
+void applyWindow(const WindowTable& window, const double* input, double* output);
+
 /**
  * Apply Hann window to signal
  * @param signal Input signal
@@ -0,0 +1,496 @@
+#include "frame_analyzer.hpp"
+#include "perf_stats.hpp"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+// Two-lane double kernels: SSE2 on x86-64, NEON on AArch64, scalar otherwise
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FRAME_SIMD_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define FRAME_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace audio {
+
+namespace {
+
+// max(weights[i] * values[i]) over count entries (0 when empty; values >= 0)
+double weightedMax(const double* weights, const double* values, size_t count) {
+    size_t i = 0;
+    double result = 0.0;
+
+#if defined(FRAME_SIMD_SSE2)
+    __m128d acc = _mm_setzero_pd();
+    for (; i + 2 <= count; i += 2) {
+        acc = _mm_max_pd(acc, _mm_mul_pd(_mm_loadu_pd(weights + i), _mm_loadu_pd(values + i)));
+    }
+    acc = _mm_max_pd(acc, _mm_unpackhi_pd(acc, acc));
+    result = _mm_cvtsd_f64(acc);
+#elif defined(FRAME_SIMD_NEON)
+    float64x2_t acc = vdupq_n_f64(0.0);
+    for (; i + 2 <= count; i += 2) {
+        acc = vmaxq_f64(acc, vmulq_f64(vld1q_f64(weights + i), vld1q_f64(values + i)));
+    }
+    result = vmaxvq_f64(acc);
+#endif
+
+    for (; i < count; ++i) {
+        result = (std::max)(result, weights[i] * values[i]);
+    }
+    return result;
+}
+
+// sum(weights[i] * values[i]) over count entries
+double weightedSum(const double* weights, const double* values, size_t count) {
+    size_t i = 0;
+    double result = 0.0;
+
+#if defined(FRAME_SIMD_SSE2)
+    __m128d acc = _mm_setzero_pd();
+    for (; i + 2 <= count; i += 2) {
+        acc = _mm_add_pd(acc, _mm_mul_pd(_mm_loadu_pd(weights + i), _mm_loadu_pd(values + i)));
+    }
+    acc = _mm_add_pd(acc, _mm_unpackhi_pd(acc, acc));
+    result = _mm_cvtsd_f64(acc);
+#elif defined(FRAME_SIMD_NEON)
+    float64x2_t acc = vdupq_n_f64(0.0);
+    for (; i + 2 <= count; i += 2) {
+        acc = vfmaq_f64(acc, vld1q_f64(weights + i), vld1q_f64(values + i));
+    }
+    result = vaddvq_f64(acc);
+#endif
+
+    for (; i < count; ++i) {
+        result += weights[i] * values[i];
+    }
+    return result;
+}
+
+// Half-band lowpass for 2x decimation: 31-tap Blackman-windowed sinc.
+// Every other tap is zero except the center, so only the odd offsets are kept.
+constexpr size_t kHalfBandTaps = 8;     // Taps at offsets +-1, +-3, ..., +-15
+
+struct HalfBandFilter {
+    double center = 0.5;
+    double taps[kHalfBandTaps] = {};
+
+    HalfBandFilter() {
+        constexpr double kPi = 3.14159265358979323846;
+        constexpr double kHalfLength = 15.0;
+        double sum = center;
+        for (size_t k = 0; k < kHalfBandTaps; ++k) {
+            double offset = static_cast<double>(2 * k + 1);
+            double sinc = std::sin(kPi * offset / 2.0) / (kPi * offset);
+            double phase = kPi * (offset + kHalfLength) / kHalfLength;
+            double blackman = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+            taps[k] = sinc * blackman;
+            sum += 2.0 * taps[k];
+        }
+        // Unity gain at DC
+        center /= sum;
+        for (double& tap : taps) tap /= sum;
+    }
+};
+
+// Lowpass and keep every other sample: output j is centered on input 2j + 1,
+// so the last output lines up with the newest input. Samples outside the
+// frame read as zero (the analysis window is ~0 there anyway).
+template <typename Sample>
+void decimate2(const Sample* input, size_t count, double* output) {
+    static const HalfBandFilter filter;
+    constexpr size_t kReach = 2 * kHalfBandTaps - 1;
+
+    for (size_t j = 0; j < count / 2; ++j) {
+        size_t c = 2 * j + 1;
+        double sum = filter.center * input[c];
+        if (c >= kReach && c + kReach < count) {
+            for (size_t k = 0; k < kHalfBandTaps; ++k) {
+                size_t offset = 2 * k + 1;
+                sum += filter.taps[k] * (static_cast<double>(input[c - offset]) + input[c + offset]);
+            }
+        } else {
+            for (size_t k = 0; k < kHalfBandTaps; ++k) {
+                size_t offset = 2 * k + 1;
+                if (c >= offset) sum += filter.taps[k] * input[c - offset];
+                if (c + offset < count) sum += filter.taps[k] * input[c + offset];
+            }
+        }
+        output[j] = sum;
+    }
+}
+
+// Window the newest plan-size points of a tier's input
+template <typename Sample>
+void applyNewestWindow(const Sample* input, size_t count, const fft::WindowTable& window, double* output) {
+    fft::applyWindow(window, input + (count - window.size()), output);
+}
+
+// Smallest fftSize for which the shortest tier still gets a usable FFT
+constexpr size_t kMinMultiResolutionSize = 1024;
+
+// Share of a decimated tier's Nyquist frequency that is free of aliasing
+constexpr double kDecimatedBandwidth = 0.6;
+
+} // namespace
+
+size_t FrameAnalyzer::chooseTier(double lowFrequency, double highFrequency) const {
+    // Shortest span whose bins still resolve the band and lie below its cutoff;
+    // the longest tier takes whatever no other tier can
+    for (size_t tier = tiers_.size() - 1; tier > 0; --tier) {
+        const Tier& candidate = tiers_[tier];
+        if (highFrequency - lowFrequency >= candidate.binWidth &&
+            highFrequency + candidate.binWidth <= candidate.maxFrequency) {
+            return tier;
+        }
+    }
+    return 0;
+}
+
+void FrameAnalyzer::configure(const AnalyzerConfig& config, uint32_t sampleRate) {
+    fftSize_ = config.fftSize;
+    sampleRate_ = sampleRate;
+    reduction_ = config.bandReduction;
+
+    // Tier layout: (span, decimation)
+    std::vector<std::pair<size_t, size_t>> layout;
+    if (config.multiResolution && fftSize_ >= kMinMultiResolutionSize) {
+        layout = {{fftSize_, 4}, {fftSize_ / 2, 2}, {fftSize_ / 4, 1}, {fftSize_ / 8, 1}};
+    } else {
+        layout = {{fftSize_, 1}};
+    }
+
+    // Plans are kept across reconfigurations when their size survives
+    std::vector<Tier> previous = std::move(tiers_);
+    tiers_.clear();
+    tiers_.resize(layout.size());
+
+    size_t binOffset = 0;
+    size_t maxSize = 0;
+    for (size_t t = 0; t < layout.size(); ++t) {
+        Tier& tier = tiers_[t];
+        tier.span = layout[t].first;
+        tier.decimation = layout[t].second;
+        size_t size = tier.span / tier.decimation;
+
+        for (Tier& old : previous) {
+            if (old.plan && old.plan->size() == size) {
+                tier.plan = std::move(old.plan);
+                break;
+            }
+        }
+        if (!tier.plan) {
+            tier.plan = std::make_unique<fft::Plan>(size);
+        }
+
+        // Shared table, computed once per (type, size) instead of per frame
+        tier.window = fft::cachedWindow(config.window, size);
+
+        double rate = static_cast<double>(sampleRate) / tier.decimation;
+        tier.binWidth = rate / size;
+        tier.maxFrequency = tier.decimation > 1 ? kDecimatedBandwidth * rate / 2.0 : rate / 2.0;
+        tier.binOffset = binOffset;
+        tier.peakFirstBin = binOffset + size / 2;
+        tier.peakEndBin = binOffset;
+
+        binOffset += tier.plan->numBins();
+        maxSize = (std::max)(maxSize, size);
+    }
+
+    bool decimated = tiers_.front().decimation > 1;
+    for (size_t input = 0; input < 2; ++input) {
+        decimated2_[input].assign(decimated ? fftSize_ / 2 : 0, 0.0);
+        decimated4_[input].assign(decimated ? fftSize_ / 4 : 0, 0.0);
+    }
+    windowed_.assign(maxSize, 0.0);
+    bins_.assign(maxSize / 2 + 1, fft::Complex(0.0, 0.0));
+    packed_.assign(maxSize, fft::Complex(0.0, 0.0));
+    for (std::vector<double>& power : binPower_) {
+        power.assign(binOffset, 0.0);
+    }
+
+    double minFreq = config.minFrequency;
+    double maxFreq = (std::min)(config.maxFrequency, static_cast<double>(sampleRate) / 2.0);
+    size_t numBands = config.numBands;
+    bool logScale = config.useLogScale;
+
+    double logMin = std::log10(minFreq);
+    double logStep = (std::log10(maxFreq) - logMin) / numBands;
+    double freqStep = (maxFreq - minFreq) / numBands;
+
+    // Edges of band i (also evaluated one band past either end)
+    auto bandEdge = [&](double i) {
+        return logScale ? std::pow(10.0, logMin + i * logStep) : minFreq + i * freqStep;
+    };
+    auto bandCenter = [&](double i) {
+        // Geometric mean on the log scale, arithmetic on the linear one
+        return logScale ? std::pow(10.0, logMin + (i + 0.5) * logStep)
+                        : minFreq + (i + 0.5) * freqStep;
+    };
+
+    bandFrequencies_.resize(numBands);
+    bandStart_.assign(numBands, 0);
+    bandOffset_.assign(1, 0);
+    bandWeights_.clear();
+
+    std::vector<double> rowWeights;
+
+    for (size_t band = 0; band < numBands; ++band) {
+        double i = static_cast<double>(band);
+        bandFrequencies_[band] = bandCenter(i);
+
+        Tier& tier = tiers_[chooseTier(bandEdge(i), bandEdge(i + 1))];
+        size_t tierSize = tier.plan->size();
+
+        // Positive frequencies below Nyquist are mapped
+        double binWidth = tier.binWidth;
+        double lastBin = static_cast<double>(tierSize / 2 - 1);
+
+        // Amplitude normalization (2/N, half spectrum, window gain relative
+        // to Hann), squared since the weights scale bin power
+        double normFactor = 2.0 / tierSize * tier.window->hannCorrection;
+        normFactor *= normFactor;
+
+        // Band geometry in fractional bins
+        double low = bandEdge(i) / binWidth;
+        double high = bandEdge(i + 1) / binWidth;
+        double center = bandCenter(i) / binWidth;
+
+        // Candidate bins and their weights
+        double reachLow, reachHigh;
+        if (reduction_ == BandReduction::Max) {
+            // Bins inside the band count fully, bins within one bin of an
+            // edge fade out linearly. Narrow low bands thereby interpolate
+            // between their two neighbouring bins instead of repeating one.
+            reachLow = low - 1.0;
+            reachHigh = high + 1.0;
+        } else {
+            // Triangle reaching the neighbouring band centers (at least one
+            // bin each way, which interpolates narrow bands)
+            reachLow = center - (std::max)(center - bandCenter(i - 1) / binWidth, 1.0);
+            reachHigh = center + (std::max)(bandCenter(i + 1) / binWidth - center, 1.0);
+        }
+
+        double firstBin = (std::max)(std::ceil(reachLow), 0.0);
+        double endBin = (std::min)(std::floor(reachHigh), lastBin);
+
+        rowWeights.clear();
+        size_t start = static_cast<size_t>(firstBin);
+        double weightSum = 0.0;
+
+        for (double k = firstBin; k <= endBin; k += 1.0) {
+            double weight;
+            if (reduction_ == BandReduction::Max) {
+                double distance = k < low ? low - k : (k > high ? k - high : 0.0);
+                weight = 1.0 - distance;
+            } else {
+                weight = k <= center ? 1.0 - (center - k) / (center - reachLow)
+                                     : 1.0 - (k - center) / (reachHigh - center);
+            }
+            weight = (std::max)(weight, 0.0);
+            if (reduction_ == BandReduction::Max) {
+                // max(w * |X|)^2 == max(w^2 * |X|^2)
+                weight *= weight;
+            }
+
+            // Keep rows tight: skip zero weights at the front
+            if (rowWeights.empty() && weight == 0.0) {
+                start = static_cast<size_t>(k) + 1;
+                continue;
+            }
+            rowWeights.push_back(weight);
+            weightSum += weight;
+        }
+
+        // Trim zero weights at the back
+        while (!rowWeights.empty() && rowWeights.back() == 0.0) {
+            rowWeights.pop_back();
+        }
+
+        double scale = normFactor;
+        if (reduction_ == BandReduction::WeightedMean && weightSum > 0.0) {
+            scale /= weightSum;
+        }
+
+        start += tier.binOffset;
+        bandStart_[band] = static_cast<uint32_t>(start);
+        for (double weight : rowWeights) {
+            bandWeights_.push_back(weight * scale);
+        }
+        bandOffset_.push_back(static_cast<uint32_t>(bandWeights_.size()));
+
+        if (!rowWeights.empty()) {
+            tier.peakFirstBin = (std::min)(tier.peakFirstBin, start);
+            tier.peakEndBin = (std::max)(tier.peakEndBin, start + rowWeights.size());
+        }
+    }
+}
+
+void FrameAnalyzer::decimate(const float* samples, size_t input) {
+    if (!decimated2_[input].empty()) {
+        decimate2(samples, fftSize_, decimated2_[input].data());
+        decimate2(decimated2_[input].data(), decimated2_[input].size(), decimated4_[input].data());
+    }
+}
+
+void FrameAnalyzer::applyTierWindow(const Tier& tier, const float* samples, size_t input, double* output) const {
+    switch (tier.decimation) {
+        case 4:  applyNewestWindow(decimated4_[input].data(), decimated4_[input].size(), *tier.window, output); break;
+        case 2:  applyNewestWindow(decimated2_[input].data(), decimated2_[input].size(), *tier.window, output); break;
+        default: applyNewestWindow(samples, fftSize_, *tier.window, output); break;
+    }
+}
+
+void FrameAnalyzer::mapBands(const double* power, double* bandPower) const {
+    // One weighted pass per band over contiguous bins
+    const double* weights = bandWeights_.data();
+    size_t numBands = bandStart_.size();
+
+    if (reduction_ == BandReduction::Max) {
+        for (size_t band = 0; band < numBands; ++band) {
+            size_t offset = bandOffset_[band];
+            bandPower[band] = weightedMax(weights + offset, power + bandStart_[band],
+                                          bandOffset_[band + 1] - offset);
+        }
+    } else {
+        for (size_t band = 0; band < numBands; ++band) {
+            size_t offset = bandOffset_[band];
+            bandPower[band] = weightedSum(weights + offset, power + bandStart_[band],
+                                          bandOffset_[band + 1] - offset);
+        }
+    }
+}
+
+double FrameAnalyzer::dominantFrequency(const double* power) const {
+    // Loudest of the mapped bins
+    double maxPower = 0.0;
+    double peakFrequency = 0.0;
+    for (const Tier& tier : tiers_) {
+        for (size_t bin = tier.peakFirstBin; bin < tier.peakEndBin; ++bin) {
+            if (power[bin] > maxPower) {
+                maxPower = power[bin];
+                peakFrequency = (bin - tier.binOffset) * tier.binWidth;
+            }
+        }
+    }
+    return peakFrequency;
+}
+
+void FrameAnalyzer::analyze(const float* samples, double* bandPower, FrameStats& stats) {
+    // Levels over the full frame
+    double rms = 0.0;
+    double peak = 0.0;
+    for (size_t i = 0; i < fftSize_; ++i) {
+        double s = static_cast<double>(samples[i]);
+        rms += s * s;
+        peak = (std::max)(peak, std::abs(s));
+    }
+    stats.rmsLevel = std::sqrt(rms / fftSize_);
+    stats.peakLevel = peak;
+
+    // Decimated copies of the whole window for the low tiers
+    decimate(samples, 0);
+
+    // One FFT per tier (real input, cached plans, preallocated output)
+    uint64_t start = timed_ ? perf::nowNs() : 0;
+    std::vector<double>& power = binPower_[0];
+    for (const Tier& tier : tiers_) {
+        applyTierWindow(tier, samples, 0, windowed_.data());
+        tier.plan->forwardReal(windowed_.data(), bins_.data());
+        fft::power(bins_.data(), tier.plan->numBins(), power.data() + tier.binOffset);
+    }
+    uint64_t fftEnd = timed_ ? perf::nowNs() : 0;
+
+    mapBands(power.data(), bandPower);
+    stats.peakFrequency = dominantFrequency(power.data());
+
+    if (timed_) {
+        perf::record(perf::Stage::Fft, fftEnd - start);
+        perf::record(perf::Stage::Banding, perf::nowNs() - fftEnd);
+    }
+}
+
+void FrameAnalyzer::analyzeStereo(const float* left, const float* right,
+                                  const std::array<double*, kNumChannels>& bandPower,
+                                  std::array<FrameStats, kNumChannels>& stats) {
+    constexpr size_t L = static_cast<size_t>(Channel::Left);
+    constexpr size_t R = static_cast<size_t>(Channel::Right);
+    constexpr size_t M = static_cast<size_t>(Channel::Mid);
+    constexpr size_t S = static_cast<size_t>(Channel::Side);
+
+    // Levels of all four channels in one pass
+    double rms[kNumChannels] = {};
+    double peak[kNumChannels] = {};
+    for (size_t i = 0; i < fftSize_; ++i) {
+        double values[kNumChannels];
+        values[L] = left[i];
+        values[R] = right[i];
+        values[M] = 0.5 * (values[L] + values[R]);
+        values[S] = 0.5 * (values[L] - values[R]);
+        for (size_t c = 0; c < kNumChannels; ++c) {
+            rms[c] += values[c] * values[c];
+            peak[c] = (std::max)(peak[c], std::abs(values[c]));
+        }
+    }
+    for (size_t c = 0; c < kNumChannels; ++c) {
+        stats[c].rmsLevel = std::sqrt(rms[c] / fftSize_);
+        stats[c].peakLevel = peak[c];
+    }
+
+    decimate(left, 0);
+    decimate(right, 1);
+
+    uint64_t start = timed_ ? perf::nowNs() : 0;
+    for (const Tier& tier : tiers_) {
+        size_t size = tier.plan->size();
+
+        // Two real FFTs from one complex FFT: left in the real part, right in
+        // the imaginary part
+        applyTierWindow(tier, left, 0, windowed_.data());
+        for (size_t i = 0; i < size; ++i) {
+            packed_[i] = fft::Complex(windowed_[i], 0.0);
+        }
+        applyTierWindow(tier, right, 1, windowed_.data());
+        for (size_t i = 0; i < size; ++i) {
+            packed_[i].imag(windowed_[i]);
+        }
+        tier.plan->forward(packed_.data());
+
+        // Untangle: L[k] = (Z[k] + conj(Z[N-k])) / 2, R[k] = (Z[k] - conj(Z[N-k])) / 2i.
+        // Mid and side follow by linearity; power is taken in the same pass.
+        const double* z = reinterpret_cast<const double*>(packed_.data());
+        double* power[kNumChannels];
+        for (size_t c = 0; c < kNumChannels; ++c) {
+            power[c] = binPower_[c].data() + tier.binOffset;
+        }
+        for (size_t k = 0; k <= size / 2; ++k) {
+            size_t mirror = k == 0 ? 0 : size - k;
+            double zRe = z[2 * k], zIm = z[2 * k + 1];
+            double mRe = z[2 * mirror], mIm = -z[2 * mirror + 1];
+            double lRe = 0.5 * (zRe + mRe), lIm = 0.5 * (zIm + mIm);
+            double rRe = 0.5 * (zIm - mIm), rIm = -0.5 * (zRe - mRe);
+            double midRe = 0.5 * (lRe + rRe), midIm = 0.5 * (lIm + rIm);
+            double sideRe = 0.5 * (lRe - rRe), sideIm = 0.5 * (lIm - rIm);
+            power[L][k] = lRe * lRe + lIm * lIm;
+            power[R][k] = rRe * rRe + rIm * rIm;
+            power[M][k] = midRe * midRe + midIm * midIm;
+            power[S][k] = sideRe * sideRe + sideIm * sideIm;
+        }
+    }
+
+    uint64_t fftEnd = timed_ ? perf::nowNs() : 0;
+
+    for (size_t c = 0; c < kNumChannels; ++c) {
+        mapBands(binPower_[c].data(), bandPower[c]);
+        stats[c].peakFrequency = dominantFrequency(binPower_[c].data());
+    }
+
+    if (timed_) {
+        perf::record(perf::Stage::Fft, fftEnd - start);
+        perf::record(perf::Stage::Banding, perf::nowNs() - fftEnd);
+    }
+}
+
+} // namespace audio
@@ -0,0 +1,141 @@
+#pragma once
+
+/**
+ * Single-frame spectrum analysis: window, FFT and band mapping
+ *
+ * Shared by the realtime AudioAnalyzer and the offline batch analyzer so
+ * both produce identical bands. Bands are reduced from bin power (no square
+ * root per bin) and returned as power; callers convert each band to dB or
+ * amplitude once. One instance owns its FFT plans and scratch buffers; use
+ * one per thread.
+ *
+ * With AnalyzerConfig::multiResolution the frame is analyzed by several
+ * FFTs ("tiers") of shrinking time span: the full fftSize window decimated
+ * 4x and 2x for the lows, then fftSize/4 and fftSize/8 newest samples at
+ * full rate for the highs. Each band reads the shortest tier that still
+ * resolves it, so high bands react several times faster while bass keeps
+ * the full frequency resolution, at about the cost of one fftSize FFT.
+ */
+
+#include "audio_analyzer.hpp"
+#include "fft.hpp"
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace audio {
+
+/**
+ * Level statistics of one analyzed frame
+ */
+struct FrameStats {
+    double rmsLevel = 0.0;
+    double peakLevel = 0.0;
+    double peakFrequency = 0.0;
+};
+
+class FrameAnalyzer {
+public:
+    // Bump whenever analysis output changes; invalidates cached spectrograms
+    static constexpr uint32_t kRevision = 3;
+
+    FrameAnalyzer() = default;
+
+    /**
+     * Rebuild the FFT plans, windows and band weight table
+     * @param config Analyzer configuration (fftSize, window, bands, frequency
+     *               range, reduction, multi-resolution)
+     * @param sampleRate Sample rate of the analyzed signal in Hz
+     */
+    void configure(const AnalyzerConfig& config, uint32_t sampleRate);
+
+    /**
+     * Analyze one frame (no temporal smoothing)
+     * @param samples fftSize() mono samples, oldest first
+     * @param bandPower Output, numBands() band powers (squared amplitudes)
+     * @param stats Output levels and dominant frequency
+     */
+    void analyze(const float* samples, double* bandPower, FrameStats& stats);
+
+    /**
+     * Analyze one stereo frame into left, right, mid and side bands
+     * Both channels share one complex FFT per tier, so this costs about
+     * two mono frames rather than four.
+     *
+     * @param left fftSize() samples, oldest first
+     * @param right fftSize() samples, oldest first
+     * @param bandPower Outputs indexed by Channel, numBands() band powers each
+     * @param stats Output levels and dominant frequency, indexed by Channel
+     */
+    void analyzeStereo(const float* left, const float* right,
+                       const std::array<double*, kNumChannels>& bandPower,
+                       std::array<FrameStats, kNumChannels>& stats);
+
+    size_t fftSize() const { return fftSize_; }
+    size_t numBands() const { return bandStart_.size(); }
+
+    /**
+     * Center frequency of each band in Hz
+     */
+    const std::vector<double>& bandFrequencies() const { return bandFrequencies_; }
+
+    /**
+     * Record the FFT and banding time of every frame (perf::Stage::Fft,
+     * perf::Stage::Banding); off by default so offline analysis stays out
+     * of the live statistics
+     */
+    void setTimed(bool timed) { timed_ = timed; }
+
+private:
+    // One FFT over the newest span input samples, taken at 1/decimation rate
+    struct Tier {
+        size_t span = 0;
+        size_t decimation = 1;          // 1, 2 or 4
+        std::unique_ptr<fft::Plan> plan;
+        std::shared_ptr<const fft::WindowTable> window;     // plan->size() points
+        size_t binOffset = 0;           // First bin in binPower_
+        double binWidth = 0.0;          // Hz
+        double maxFrequency = 0.0;      // Highest usable frequency (below the decimation filter's cutoff)
+
+        // Bins searched for the dominant frequency (offsets into binPower_)
+        size_t peakFirstBin = 0;
+        size_t peakEndBin = 0;
+    };
+
+    size_t chooseTier(double lowFrequency, double highFrequency) const;
+    void decimate(const float* samples, size_t input);
+    void applyTierWindow(const Tier& tier, const float* samples, size_t input, double* output) const;
+    void mapBands(const double* power, double* bandPower) const;
+    double dominantFrequency(const double* power) const;
+
+    size_t fftSize_ = 0;
+    uint32_t sampleRate_ = 44100;
+    bool timed_ = false;
+
+    // Tiers ordered from the longest (finest) to the shortest span; single
+    // resolution is one full-rate tier of fftSize points
+    std::vector<Tier> tiers_;
+
+    // Per input (mono or left, right): the frame at half and quarter rate
+    std::array<std::vector<double>, 2> decimated2_;
+    std::array<std::vector<double>, 2> decimated4_;
+
+    std::vector<double> windowed_;
+    fft::ComplexVector bins_;
+    fft::ComplexVector packed_;         // Stereo: left + i * right
+
+    // All tiers' bin power, back to back (mono uses the first)
+    std::array<std::vector<double>, kNumChannels> binPower_;
+
+    // Band mapping as a CSR table: band b reads bins starting at
+    // bandStart_[b] with weights bandWeights_[bandOffset_[b] .. bandOffset_[b + 1]).
+    // Weights scale power and include the squared amplitude normalization
+    // (Max: squared weights; WeightedMean: an energy mean).
+    BandReduction reduction_ = BandReduction::Max;
+    std::vector<uint32_t> bandStart_;
+    std::vector<uint32_t> bandOffset_;
+    std::vector<double> bandWeights_;
+    std::vector<double> bandFrequencies_;
+};
+
+} // namespace audio
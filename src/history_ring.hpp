@@ -0,0 +1,109 @@
+#pragma once
+
+/**
+ * Fixed-capacity sample history that always holds the newest samples
+ *
+ * Writes overwrite the oldest samples; reads return the latest N samples
+ * oldest first. Capacity is a power of 2, so positions wrap with a mask,
+ * and every write or read is at most two contiguous copies. Owned by one
+ * thread (no synchronization).
+ */
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+namespace rt {
+
+template <typename T>
+class HistoryRing {
+public:
+    /**
+     * The latest samples as at most two contiguous runs, oldest first
+     */
+    struct Runs {
+        const T* first = nullptr;
+        size_t firstCount = 0;
+        const T* second = nullptr;
+        size_t secondCount = 0;
+    };
+
+    HistoryRing() = default;
+
+    explicit HistoryRing(size_t minCapacity) { reset(minCapacity); }
+
+    /**
+     * Resize and zero the history
+     * @param minCapacity Requested capacity (rounded up to a power of 2)
+     */
+    void reset(size_t minCapacity) {
+        size_t capacity = 1;
+        while (capacity < minCapacity) capacity <<= 1;
+
+        buffer_.assign(capacity, T{});
+        mask_ = capacity - 1;
+        head_ = 0;
+    }
+
+    /**
+     * Zero the history, keeping the capacity
+     */
+    void clear() {
+        std::fill(buffer_.begin(), buffer_.end(), T{});
+        head_ = 0;
+    }
+
+    size_t capacity() const { return buffer_.size(); }
+
+    /**
+     * Append samples, overwriting the oldest
+     * @param data Source samples
+     * @param count Number of samples (only the newest capacity() are kept)
+     */
+    void write(const T* data, size_t count) {
+        if (count > buffer_.size()) {
+            data += count - buffer_.size();
+            count = buffer_.size();
+        }
+
+        size_t first = (std::min)(count, buffer_.size() - head_);
+        std::copy(data, data + first, buffer_.data() + head_);
+        std::copy(data + first, data + count, buffer_.data());
+        head_ = (head_ + count) & mask_;
+    }
+
+    /**
+     * Locate the latest samples without copying
+     * @param count Number of samples (at most capacity())
+     * @return Runs covering the count newest samples, oldest first
+     */
+    Runs latest(size_t count) const {
+        count = (std::min)(count, buffer_.size());
+        size_t start = (head_ - count) & mask_;
+
+        Runs runs;
+        runs.first = buffer_.data() + start;
+        runs.firstCount = (std::min)(count, buffer_.size() - start);
+        runs.second = buffer_.data();
+        runs.secondCount = count - runs.firstCount;
+        return runs;
+    }
+
+    /**
+     * Copy the latest samples, oldest first
+     * @param dest Destination for count samples
+     * @param count Number of samples (at most capacity())
+     */
+    void readLatest(T* dest, size_t count) const {
+        Runs runs = latest(count);
+        std::copy(runs.first, runs.first + runs.firstCount, dest);
+        std::copy(runs.second, runs.second + runs.secondCount, dest + runs.firstCount);
+    }
+
+private:
+    std::vector<T> buffer_;
+    size_t mask_ = 0;
+    size_t head_ = 0;     // Next write position
+};
+
+} // namespace rt
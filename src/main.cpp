@@ -3,9 +3,21 @@
 #include "audio_analyzer.hpp"
 #include "spectrum_visualizer.hpp"
 #include "file_dialog.hpp"
+#include "offline_analyzer.hpp"
+#include "spectrogram_cache.hpp"
+#include "thread_pool.hpp"
+#include "perf_stats.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
 #include <iostream>
+#include <mutex>
 #include <string>
+#include <vector>
 
 void printUsage(const char* programName) {
     std::cout << "\n";
@@ -15,6 +27,7 @@ void printUsage(const char* programName) {
     std::cout << "======================================================================\n";
     std::cout << "\n";
     std::cout << "Usage: " << programName << " [audio_file]\n";
+    std::cout << "       " << programName << " --analyze [--jobs N] [--cache | -o output.spgm] <audio_file_or_directory>...\n";
     std::cout << "\n";
     std::cout << "Supported formats: MP3, WAV, FLAC, OGG, M4A, AAC\n";
     std::cout << "\n";
@@ -29,6 +42,7 @@ void printUsage(const char* programName) {
     std::cout << "  G          - Toggle frequency grid\n";
     std::cout << "  P          - Toggle peak indicators\n";
     std::cout << "  I          - Toggle info display\n";
+    std::cout << "  F3         - Toggle performance overlay\n";
     std::cout << "\n";
     std::cout << "Equalizer (Line mode):\n";
     std::cout << "  E          - Toggle EQ on/off\n";
@@ -40,28 +54,170 @@ void printUsage(const char* programName) {
     std::cout << "\n";
 }
 
+// Analysis settings of the interactive view
+audio::AnalyzerConfig viewAnalyzerConfig() {
+    audio::AnalyzerConfig config;
+    config.fftSize = 8192;        // Larger FFT for better low-freq resolution
+    config.numBands = 256;         // More bands for smoother display
+    config.minFrequency = 20.0;
+    config.maxFrequency = 20000.0;
+    config.smoothingFactor = 0.6;  // Less smoothing for more responsive display
+    config.useLogScale = true;
+    config.multiResolution = true; // Highs from short FFTs, bass keeps 8192-point resolution
+    return config;
+}
+
+// Collect audio files from the command line (directories are searched recursively)
+std::vector<std::string> collectAudioFiles(const std::vector<std::string>& inputs) {
+    static const char* extensions[] = {".mp3", ".wav", ".flac", ".ogg", ".m4a", ".aac"};
+    
+    auto isAudioFile = [](const std::filesystem::path& path) {
+        std::string ext = path.extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), 
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return std::find(std::begin(extensions), std::end(extensions), ext) != std::end(extensions);
+    };
+    
+    std::vector<std::string> files;
+    for (const std::string& input : inputs) {
+        std::error_code error;
+        if (std::filesystem::is_directory(input, error)) {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(input, error)) {
+                if (entry.is_regular_file(error) && isAudioFile(entry.path())) {
+                    files.push_back(entry.path().string());
+                }
+            }
+        } else {
+            files.push_back(input);
+        }
+    }
+    
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+// Offline mode: decode and analyze as fast as possible, no window or audio device.
+// Files are spread across the thread pool and each file's frames are split
+// across it as well.
+int runOfflineAnalysis(int argc, char* argv[]) {
+    std::vector<std::string> inputs;
+    std::string outputFile;
+    size_t jobs = 0;
+    bool useCache = false;
+    
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc) {
+            outputFile = argv[++i];
+        } else if (arg == "--cache") {
+            useCache = true;
+        } else if (arg == "--jobs" && i + 1 < argc) {
+            jobs = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+    
+    std::vector<std::string> files = collectAudioFiles(inputs);
+    if (files.empty() || (!outputFile.empty() && (files.size() != 1 || useCache))) {
+        std::cerr << "Usage: " << argv[0] 
+                  << " --analyze [--jobs N] [--cache | -o output.spgm] <audio_file_or_directory>...\n"
+                  << "  --cache  store results in the player's analysis cache\n"
+                  << "  -o       output path (single input file only)\n";
+        return 1;
+    }
+    
+    // Same analysis as the interactive view, so cached entries are found
+    audio::AnalyzerConfig config = viewAnalyzerConfig();
+    
+    util::ThreadPool pool(jobs);
+    audio::OfflineAnalyzer offline(config, &pool);
+    audio::SpectrogramCache cache;
+    
+    std::mutex printMutex;
+    std::atomic<size_t> failures{0};
+    double totalAudio = 0.0;
+    
+    auto startTime = std::chrono::steady_clock::now();
+    
+    pool.parallelFor(files.size(), 1, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            const std::string& inputFile = files[i];
+            audio::SourceInfo source;
+            if (useCache) {
+                source = audio::SpectrogramCache::hashFile(inputFile);
+                source.sampleRate = audio::OfflineAnalyzer::kDecodeSampleRate;
+                source.channels = audio::OfflineAnalyzer::kDecodeChannels;
+            }
+            std::string output = useCache ? cache.entryPath(source, config) :
+                                 outputFile.empty() ? inputFile + ".spgm" : outputFile;
+            
+            // Already analyzed with these settings
+            audio::SpectrogramReader existing;
+            if (useCache && cache.open(source, config, existing)) {
+                std::lock_guard<std::mutex> lock(printMutex);
+                std::cout << inputFile << ": cached\n";
+                continue;
+            }
+            
+            audio::Spectrogram spectrogram;
+            bool decoded = offline.analyzeFile(inputFile, spectrogram);
+            bool written = decoded && (useCache ? cache.store(source, config, spectrogram) :
+                                                  audio::writeSpectrogram(output, spectrogram));
+            
+            std::lock_guard<std::mutex> lock(printMutex);
+            if (!decoded) {
+                std::cerr << "Failed to decode audio file: " << inputFile << "\n";
+                ++failures;
+            } else if (!written) {
+                std::cerr << "Failed to write spectrogram: " << output << "\n";
+                ++failures;
+            } else {
+                double duration = static_cast<double>(spectrogram.numFrames * spectrogram.hopSize) / 
+                                  spectrogram.sampleRate;
+                totalAudio += duration;
+                std::cout << inputFile << " -> " << output << ": " 
+                          << spectrogram.numFrames << " frames\n";
+            }
+        }
+    });
+    
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    
+    std::cout << files.size() - failures << "/" << files.size() << " files, " 
+              << totalAudio << " s of audio in " << elapsed << " s on " << pool.size() << " threads";
+    if (elapsed > 0.0) {
+        std::cout << " (" << totalAudio / elapsed << "x realtime)";
+    }
+    std::cout << "\n";
+    return failures == 0 ? 0 : 1;
+}
+
 int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--analyze") {
+        return runOfflineAnalysis(argc, argv);
+    }
+    
     printUsage(argv[0]);
     
     // Initialize audio analyzer
     audio::AudioAnalyzer analyzer;
     
     // Configure analyzer
-    audio::AnalyzerConfig analyzerConfig;
-    analyzerConfig.fftSize = 8192;        // Larger FFT for better low-freq resolution
-    analyzerConfig.numBands = 256;         // More bands for smoother display
-    analyzerConfig.minFrequency = 20.0;
-    analyzerConfig.maxFrequency = 20000.0;
-    analyzerConfig.smoothingFactor = 0.6;  // Less smoothing for more responsive display
-    analyzerConfig.useLogScale = true;
-    
-    analyzer.setConfig(analyzerConfig);
+    analyzer.setConfig(viewAnalyzerConfig());
     
     if (!analyzer.initialize()) {
         std::cerr << "Failed to initialize audio analyzer!\n";
         return 1;
     }
     
+    // Per-stage timings, appended once a second when SPECTRUM_PERF_LOG is set.
+    // The render loop records every frame, so it gets its own slot.
+    perf::registerThread();
+    if (!perf::openLogFromEnvironment()) {
+        std::cerr << "Failed to open performance log: " << std::getenv("SPECTRUM_PERF_LOG") << "\n";
+    }
+    
     // Initialize visualizer
     viz::SpectrumVisualizer visualizer;
     
@@ -137,8 +293,9 @@ int main(int argc, char* argv[]) {
         // Handle input
         visualizer.handleInput(analyzer);
         
-        // Get spectrum data
-        audio::SpectrumData spectrum = analyzer.getSpectrum();
+        // Spectrum interpolated to this frame's display time (analysis runs
+        // once per hop on the worker, independent of the frame rate)
+        const audio::SpectrumData& spectrum = analyzer.acquireDisplaySpectrum();
         
         // Render
         visualizer.render(spectrum, analyzer);
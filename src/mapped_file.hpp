@@ -0,0 +1,54 @@
+#pragma once
+
+/**
+ * Read-only memory-mapped file
+ *
+ * Maps a whole file into the address space so it can be handed to a
+ * decoder or parser without copying. Platform headers stay in the .cpp
+ * (this header is safe to include next to raylib).
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace util {
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * Map a file (unmaps a previously opened one first)
+     * @param path File to map
+     * @return True if the file is mapped (empty files fail)
+     */
+    bool open(const std::string& path);
+
+    /**
+     * Unmap the file. Safe to call when nothing is mapped.
+     */
+    void close();
+
+    bool isOpen() const { return data_ != nullptr; }
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+
+#ifdef _WIN32
+    void* file_ = nullptr;      // HANDLE
+    void* mapping_ = nullptr;   // HANDLE
+#endif
+};
+
+} // namespace util
@@ -0,0 +1,182 @@
+// Windows compatibility - must be before any Windows headers
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#endif
+
+#include "miniaudio.h"   // Implementation lives in audio_analyzer.cpp
+
+#include "offline_analyzer.hpp"
+#include "frame_analyzer.hpp"
+#include "mapped_file.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <memory>
+
+namespace audio {
+
+namespace {
+
+// Frames decoded per read
+constexpr size_t kDecodeChunk = 1 << 16;
+
+// Frame ranges per worker: enough to balance, few enough to amortize setup
+constexpr size_t kRangesPerWorker = 8;
+constexpr size_t kMinFramesPerRange = 32;
+
+// Per-thread analysis state
+struct FrameWorkspace {
+    FrameAnalyzer analyzer;
+    std::vector<float> padded;
+    std::vector<double> bands;
+};
+
+} // namespace
+
+OfflineAnalyzer::OfflineAnalyzer(const AnalyzerConfig& config, util::ThreadPool* pool)
+    : config_(config), pool_(pool) {
+}
+
+bool OfflineAnalyzer::decodeFile(const std::string& filepath, std::vector<float>& mono, uint32_t& sampleRate,
+                                 uint32_t& channels) {
+    util::MappedFile file;
+    if (!file.open(filepath)) {
+        return false;
+    }
+
+    ma_decoder_config decoderConfig = ma_decoder_config_init(ma_format_f32, kDecodeChannels, kDecodeSampleRate);
+    ma_decoder decoder;
+    if (ma_decoder_init_memory(file.data(), file.size(), &decoderConfig, &decoder) != MA_SUCCESS) {
+        return false;
+    }
+
+    sampleRate = decoder.outputSampleRate;
+    channels = decoder.outputChannels;
+
+    // Length is an estimate for some formats; it only sizes the reservation
+    ma_uint64 lengthFrames = 0;
+    ma_decoder_get_length_in_pcm_frames(&decoder, &lengthFrames);
+
+    mono.clear();
+    mono.reserve(static_cast<size_t>(lengthFrames));
+
+    std::vector<float> chunk(kDecodeChunk * channels);
+    float scale = 1.0f / static_cast<float>(channels);
+
+    for (;;) {
+        ma_uint64 framesRead = 0;
+        ma_decoder_read_pcm_frames(&decoder, chunk.data(), kDecodeChunk, &framesRead);
+        if (framesRead == 0) break;
+
+        // Mix to mono like the realtime path
+        size_t offset = mono.size();
+        mono.resize(offset + static_cast<size_t>(framesRead));
+        for (size_t i = 0; i < framesRead; ++i) {
+            const float* frame = chunk.data() + i * channels;
+            float sample = 0.0f;
+            for (uint32_t c = 0; c < channels; ++c) {
+                sample += frame[c];
+            }
+            mono[offset + i] = sample * scale;
+        }
+
+        if (framesRead < kDecodeChunk) break;
+    }
+
+    ma_decoder_uninit(&decoder);
+    return true;
+}
+
+bool OfflineAnalyzer::analyzeFile(const std::string& filepath, Spectrogram& result) {
+    std::vector<float> mono;
+    uint32_t sampleRate = 0;
+    uint32_t channels = 0;
+    if (!decodeFile(filepath, mono, sampleRate, channels)) {
+        return false;
+    }
+
+    analyzeSamples(mono.data(), mono.size(), sampleRate, result);
+    result.channels = channels;
+    return true;
+}
+
+void OfflineAnalyzer::analyzeSamples(const float* samples, size_t count, uint32_t sampleRate, Spectrogram& result) {
+    size_t fftSize = config_.fftSize;
+    size_t hopSize = (std::max<size_t>)(config_.hopSize, 1);
+    size_t numBands = config_.numBands;
+
+    result.sampleRate = sampleRate;
+    result.fftSize = static_cast<uint32_t>(fftSize);
+    result.hopSize = static_cast<uint32_t>(hopSize);
+    result.numBands = static_cast<uint32_t>(numBands);
+    result.numFrames = count / hopSize;
+    result.power.assign(static_cast<size_t>(result.numFrames) * numBands, 0.0f);
+    result.levels.assign(static_cast<size_t>(result.numFrames), FrameLevels());
+
+    // One workspace per thread that can run a range (pool workers + caller),
+    // built on first use by the thread that owns it
+    size_t numWorkspaces = pool_ ? pool_->size() + 1 : 1;
+    std::vector<std::unique_ptr<FrameWorkspace>> workspaces(numWorkspaces);
+
+    auto workspaceFor = [&](size_t index) -> FrameWorkspace& {
+        std::unique_ptr<FrameWorkspace>& workspace = workspaces[index];
+        if (!workspace) {
+            workspace = std::make_unique<FrameWorkspace>();
+            workspace->analyzer.configure(config_, sampleRate);
+            workspace->padded.assign(fftSize, 0.0f);
+            workspace->bands.assign(numBands, 0.0);
+        }
+        return *workspace;
+    };
+
+    // The caller's workspace also provides the band layout
+    const std::vector<double>& frequencies =
+        workspaceFor(pool_ ? pool_->workerIndex() : 0).analyzer.bandFrequencies();
+    result.frequencies.assign(frequencies.begin(), frequencies.end());
+
+    auto analyzeRange = [&](size_t first, size_t last) {
+        FrameWorkspace& workspace = workspaceFor(pool_ ? pool_->workerIndex() : 0);
+
+        FrameStats stats;
+        for (size_t i = first; i < last; ++i) {
+            // Frame i ends at sample (i + 1) * hopSize; windows reaching before
+            // the start of the file are zero-padded, as in realtime playback
+            size_t end = (i + 1) * hopSize;
+            const float* window;
+
+            if (end >= fftSize) {
+                window = samples + (end - fftSize);
+            } else {
+                size_t zeros = fftSize - end;
+                std::fill(workspace.padded.begin(), workspace.padded.begin() + zeros, 0.0f);
+                std::copy(samples, samples + end, workspace.padded.begin() + zeros);
+                window = workspace.padded.data();
+            }
+
+            workspace.analyzer.analyze(window, workspace.bands.data(), stats);
+
+            float* out = result.power.data() + i * numBands;
+            for (size_t band = 0; band < numBands; ++band) {
+                out[band] = static_cast<float>(workspace.bands[band]);
+            }
+
+            result.levels[i].rmsLevel = static_cast<float>(stats.rmsLevel);
+            result.levels[i].peakLevel = static_cast<float>(stats.peakLevel);
+            result.levels[i].peakFrequency = static_cast<float>(stats.peakFrequency);
+        }
+    };
+
+    size_t numFrames = static_cast<size_t>(result.numFrames);
+    if (pool_) {
+        size_t grain = (std::max)(kMinFramesPerRange, numFrames / (pool_->size() * kRangesPerWorker));
+        pool_->parallelFor(numFrames, grain, analyzeRange);
+    } else {
+        analyzeRange(0, numFrames);
+    }
+}
+
+} // namespace audio
@@ -0,0 +1,116 @@
+#pragma once
+
+/**
+ * Offline (faster than realtime) spectrum analysis of whole files
+ *
+ * Decodes a memory-mapped file in large chunks with no audio device
+ * opened and computes one STFT frame per hop, using the same FrameAnalyzer
+ * as realtime playback. Frames are unsmoothed and analyze the file as
+ * decoded (before EQ and volume).
+ *
+ * With a thread pool the frames are split into ranges across workers; each
+ * worker uses its own FrameAnalyzer and writes a disjoint slice of the
+ * result, so nothing mutable is shared.
+ */
+
+#include "audio_analyzer.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace util {
+class ThreadPool;
+}
+
+namespace audio {
+
+/**
+ * Levels of one offline frame
+ */
+struct FrameLevels {
+    float rmsLevel = 0.0f;
+    float peakLevel = 0.0f;
+    float peakFrequency = 0.0f;
+};
+
+/**
+ * Band power for every hop of a track
+ */
+struct Spectrogram {
+    uint32_t sampleRate = 0;
+    uint32_t channels = 0;            // Decoded channels (analyzed as a mono mix)
+    uint32_t fftSize = 0;
+    uint32_t hopSize = 0;
+    uint32_t numBands = 0;
+    uint64_t numFrames = 0;
+
+    std::vector<float> frequencies;   // Center frequency of each band (Hz)
+    std::vector<float> power;         // numFrames x numBands, frame-major
+    std::vector<FrameLevels> levels;  // One entry per frame
+
+    /**
+     * Band power of one frame
+     * @param index Frame index (< numFrames)
+     * @return numBands band powers (squared amplitudes)
+     */
+    const float* frame(size_t index) const { return power.data() + index * numBands; }
+
+    /**
+     * Time of a frame: the end of its analysis window
+     * @param index Frame index
+     * @return Position in seconds
+     */
+    double frameTime(size_t index) const {
+        return sampleRate ? static_cast<double>((index + 1) * hopSize) / sampleRate : 0.0;
+    }
+};
+
+class OfflineAnalyzer {
+public:
+    // Same output format as playback so offline and realtime frames line up
+    static constexpr uint32_t kDecodeChannels = 2;
+    static constexpr uint32_t kDecodeSampleRate = 44100;
+
+    /**
+     * @param config Analysis settings (fftSize, hopSize, bands); smoothing is ignored
+     * @param pool Workers for the STFT frames (nullptr = calling thread only)
+     */
+    explicit OfflineAnalyzer(const AnalyzerConfig& config = AnalyzerConfig(),
+                             util::ThreadPool* pool = nullptr);
+
+    /**
+     * Decode a file and analyze all of it
+     * @param filepath Audio file (WAV, MP3, FLAC, etc.)
+     * @param result Output spectrogram
+     * @return True if the file was decoded and analyzed
+     */
+    bool analyzeFile(const std::string& filepath, Spectrogram& result);
+
+    /**
+     * Analyze an already decoded mono signal
+     * @param samples Mono samples
+     * @param count Number of samples
+     * @param sampleRate Sample rate in Hz
+     * @param result Output spectrogram
+     */
+    void analyzeSamples(const float* samples, size_t count, uint32_t sampleRate, Spectrogram& result);
+
+    /**
+     * Decode a whole file to mono at the playback sample rate
+     * @param filepath Audio file
+     * @param mono Output samples
+     * @param sampleRate Output sample rate in Hz
+     * @param channels Decoded channels before the mono mix
+     * @return True if successful
+     */
+    static bool decodeFile(const std::string& filepath, std::vector<float>& mono, uint32_t& sampleRate,
+                           uint32_t& channels);
+
+    const AnalyzerConfig& getConfig() const { return config_; }
+
+private:
+    AnalyzerConfig config_;
+    util::ThreadPool* pool_ = nullptr;
+};
+
+} // namespace audio
@@ -0,0 +1,150 @@
+#pragma once
+
+/**
+ * Fixed-capacity particle pool stored as structure of arrays
+ *
+ * Positions, velocities, lifetimes, sizes and colors live in separate
+ * arrays, so the per-frame integration is a few straight loops over plain
+ * floats that the compiler vectorizes. Slots are recycled through a free
+ * list: spawning and retiring never move other particles or allocate.
+ * Only slots below extent() have ever been used since the last reset;
+ * alive(i) tells which of them hold a live particle.
+ */
+
+#include <raylib.h>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace viz {
+
+class ParticlePool {
+public:
+    /**
+     * Reallocate for a new capacity and drop every particle
+     * @param capacity Maximum number of live particles
+     */
+    void reset(size_t capacity) {
+        x_.assign(capacity, 0.0f);
+        y_.assign(capacity, 0.0f);
+        vx_.assign(capacity, 0.0f);
+        vy_.assign(capacity, 0.0f);
+        life_.assign(capacity, 0.0f);
+        size_.assign(capacity, 0.0f);
+        color_.assign(capacity, Color{0, 0, 0, 0});
+        alive_.assign(capacity, 0);
+
+        // Pop order hands out low slots first, keeping extent() small
+        freeList_.resize(capacity);
+        for (size_t i = 0; i < capacity; ++i) {
+            freeList_[i] = static_cast<uint32_t>(capacity - 1 - i);
+        }
+        extent_ = 0;
+        live_ = 0;
+    }
+
+    size_t capacity() const { return life_.size(); }
+    size_t size() const { return live_; }
+    size_t extent() const { return extent_; }
+    bool full() const { return freeList_.empty(); }
+
+    /**
+     * Add a particle
+     * @return false if the pool is full
+     */
+    bool spawn(Vector2 position, Vector2 velocity, float life, float size, Color color) {
+        if (freeList_.empty()) return false;
+
+        uint32_t slot = freeList_.back();
+        freeList_.pop_back();
+
+        x_[slot] = position.x;
+        y_[slot] = position.y;
+        vx_[slot] = velocity.x;
+        vy_[slot] = velocity.y;
+        life_[slot] = life;
+        size_[slot] = size;
+        color_[slot] = color;
+        alive_[slot] = 1;
+
+        extent_ = extent_ > slot + 1 ? extent_ : slot + 1;
+        ++live_;
+        return true;
+    }
+
+    /**
+     * Advance every particle one frame and retire the expired ones
+     * @param dt Frame time in seconds
+     * @param gravity Downward velocity change per frame
+     * @param fadeRate Life lost per second
+     * @param shrink Size factor per frame
+     * @param minSize Particles smaller than this are retired
+     */
+    void update(float dt, float gravity, float fadeRate, float shrink, float minSize) {
+        float step = dt * 60.0f;
+        float fade = dt * fadeRate;
+        size_t count = extent_;
+
+        // Branch-free over all used slots; dead slots are updated too, which
+        // is cheaper than testing them and harmless since spawn overwrites them
+        // (their size is zeroed on retire, so shrinking never decays into
+        // denormals). One loop per array pair keeps each simple enough to
+        // vectorize.
+        float* x = x_.data();
+        float* y = y_.data();
+        float* vx = vx_.data();
+        float* vy = vy_.data();
+        float* life = life_.data();
+        float* size = size_.data();
+        for (size_t i = 0; i < count; ++i) {
+            x[i] += vx[i] * step;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            y[i] += vy[i] * step;
+            vy[i] += gravity;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            life[i] -= fade;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            size[i] *= shrink;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            if (alive_[i] && (life[i] <= 0.0f || size[i] < minSize)) {
+                alive_[i] = 0;
+                size[i] = 0.0f;
+                freeList_.push_back(static_cast<uint32_t>(i));
+                --live_;
+            }
+        }
+
+        // Trailing dead slots no longer need updating
+        while (extent_ > 0 && !alive_[extent_ - 1]) {
+            --extent_;
+        }
+    }
+
+    bool alive(size_t i) const { return alive_[i] != 0; }
+    float x(size_t i) const { return x_[i]; }
+    float y(size_t i) const { return y_[i]; }
+    float life(size_t i) const { return life_[i]; }
+    float size(size_t i) const { return size_[i]; }
+    Color color(size_t i) const { return color_[i]; }
+
+private:
+    std::vector<float> x_;
+    std::vector<float> y_;
+    std::vector<float> vx_;
+    std::vector<float> vy_;
+    std::vector<float> life_;
+    std::vector<float> size_;
+    std::vector<Color> color_;
+    std::vector<uint8_t> alive_;
+
+    std::vector<uint32_t> freeList_;
+    size_t extent_ = 0;     // One past the highest used slot
+    size_t live_ = 0;
+};
+
+} // namespace viz
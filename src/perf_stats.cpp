@@ -0,0 +1,337 @@
+#include "perf_stats.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+
+namespace perf {
+
+namespace {
+
+// Bucket 0 holds everything under 64 ns; then four buckets per octave up to
+// 2^30 ns (~1 s), the last one also taking anything longer
+constexpr size_t kMinOctave = 6;
+constexpr size_t kOctaves = 24;
+constexpr size_t kBuckets = 1 + kOctaves * 4;
+constexpr size_t kMaxThreads = 32;
+constexpr size_t kSharedSlot = kMaxThreads;
+
+// A registered thread's slot is written by that thread only (relaxed load
+// + store, no read-modify-write); read by the aggregator. Static storage,
+// so everything starts at zero.
+struct ThreadSlot {
+    std::atomic<bool> claimed;
+    std::atomic<uint64_t> counts[kNumStages][kBuckets];
+    std::atomic<uint64_t> totalNs[kNumStages];
+    std::atomic<uint64_t> maxNs[kNumStages];       // Since the last refresh
+};
+
+// One slot per registered thread, plus the shared slot (never claimed)
+// that every other thread adds to atomically
+ThreadSlot slots[kMaxThreads + 1];
+
+// Trivially destructible, so first use on an audio thread allocates nothing
+thread_local ThreadSlot* threadSlot = nullptr;
+
+std::atomic<uint64_t> audioPeriodNs{0};
+
+size_t floorLog2(uint64_t value) {
+    size_t result = 0;
+    for (size_t shift = 32; shift > 0; shift >>= 1) {
+        if (value >> shift) {
+            value >>= shift;
+            result += shift;
+        }
+    }
+    return result;
+}
+
+size_t bucketIndex(uint64_t ns) {
+    if (ns < (uint64_t(1) << kMinOctave)) return 0;
+    size_t octave = floorLog2(ns);
+    size_t quarter = static_cast<size_t>(ns >> (octave - 2)) & 3;
+    return (std::min)(1 + (octave - kMinOctave) * 4 + quarter, kBuckets - 1);
+}
+
+// Upper edge of a bucket in nanoseconds
+double bucketLimitNs(size_t index) {
+    if (index == 0) return static_cast<double>(uint64_t(1) << kMinOctave);
+    size_t octave = kMinOctave + (index - 1) / 4;
+    size_t quarter = (index - 1) % 4;
+    return static_cast<double>((5 + quarter) << (octave - 2));
+}
+
+// Acquire pairs with the previous owner's release, so its last counter
+// stores are visible before this thread adds to them
+ThreadSlot* claimSlot() {
+    for (size_t i = 0; i < kMaxThreads; ++i) {
+        ThreadSlot& slot = slots[i];
+        bool expected = false;
+        if (!slot.claimed.load(std::memory_order_relaxed) &&
+            slot.claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+// Aggregator state (any UI thread, under the mutex)
+struct Aggregator {
+    std::mutex mutex;
+    Snapshot latest;
+    uint64_t lastRefreshNs = 0;
+    uint64_t previousCounts[kNumStages][kBuckets] = {};
+    uint64_t previousTotalNs[kNumStages] = {};
+    std::ofstream log;
+    bool logJson = false;
+};
+
+Aggregator& aggregator() {
+    static Aggregator instance;
+    return instance;
+}
+
+// Smallest bucket limit with at least fraction of the calls at or below it
+double quantileUs(const uint64_t* window, uint64_t count, double fraction) {
+    uint64_t target = static_cast<uint64_t>(fraction * static_cast<double>(count - 1)) + 1;
+    uint64_t cumulative = 0;
+    for (size_t b = 0; b < kBuckets; ++b) {
+        cumulative += window[b];
+        if (cumulative >= target) return bucketLimitNs(b) / 1000.0;
+    }
+    return bucketLimitNs(kBuckets - 1) / 1000.0;
+}
+
+void writeLogRecord(Aggregator& agg) {
+    const Snapshot& s = agg.latest;
+    long long timestamp = static_cast<long long>(std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+
+    if (agg.logJson) {
+        agg.log << "{\"timestamp\":" << timestamp
+                << ",\"interval_s\":" << s.intervalSeconds
+                << ",\"audio_period_us\":" << s.audioPeriodUs
+                << ",\"stages\":{";
+        bool first = true;
+        for (size_t i = 0; i < kNumStages; ++i) {
+            const StageStats& st = s.stages[i];
+            if (st.count == 0) continue;
+            agg.log << (first ? "" : ",") << '"' << stageName(static_cast<Stage>(i)) << "\":{"
+                    << "\"count\":" << st.count
+                    << ",\"p50_us\":" << st.p50Us
+                    << ",\"p99_us\":" << st.p99Us
+                    << ",\"max_us\":" << st.maxUs
+                    << ",\"mean_us\":" << st.meanUs
+                    << ",\"p99_load_pct\":" << s.loadPercent(st.p99Us) << '}';
+            first = false;
+        }
+        agg.log << "}}\n";
+    } else {
+        for (size_t i = 0; i < kNumStages; ++i) {
+            const StageStats& st = s.stages[i];
+            if (st.count == 0) continue;
+            agg.log << timestamp << ',' << stageName(static_cast<Stage>(i)) << ','
+                    << st.count << ',' << st.p50Us << ',' << st.p99Us << ','
+                    << st.maxUs << ',' << st.meanUs << ',' << s.loadPercent(st.p99Us) << '\n';
+        }
+    }
+    agg.log.flush();
+}
+
+// Compact duration: microseconds below 1 ms, milliseconds above
+std::string formatDuration(double us) {
+    char text[32];
+    if (us < 1000.0) {
+        std::snprintf(text, sizeof(text), "%.0fus", us);
+    } else {
+        std::snprintf(text, sizeof(text), "%.1fms", us / 1000.0);
+    }
+    return text;
+}
+
+} // namespace
+
+const char* stageName(Stage stage) {
+    static const char* const kNames[kNumStages] = {
+        "AudioCallback", "Decode", "Equalizer", "Analysis", "Fft",
+        "Banding", "Process", "Render", "Draw"
+    };
+    size_t index = static_cast<size_t>(stage);
+    return index < kNumStages ? kNames[index] : "Unknown";
+}
+
+void registerThread() {
+    if (!threadSlot) {
+        threadSlot = claimSlot();
+    }
+}
+
+void releaseThread() {
+    // The counters stay: the aggregator's sums only ever grow, and the next
+    // owner keeps adding to them
+    if (threadSlot) {
+        threadSlot->claimed.store(false, std::memory_order_release);
+        threadSlot = nullptr;
+    }
+}
+
+void record(Stage stage, uint64_t ns) {
+    size_t s = static_cast<size_t>(stage);
+    ThreadSlot* slot = threadSlot;
+
+    if (!slot) {
+        ThreadSlot& shared = slots[kSharedSlot];
+        shared.counts[s][bucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+        shared.totalNs[s].fetch_add(ns, std::memory_order_relaxed);
+        std::atomic<uint64_t>& maximum = shared.maxNs[s];
+        uint64_t previous = maximum.load(std::memory_order_relaxed);
+        while (ns > previous && !maximum.compare_exchange_weak(previous, ns, std::memory_order_relaxed)) {
+        }
+        return;
+    }
+
+    std::atomic<uint64_t>& count = slot->counts[s][bucketIndex(ns)];
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic<uint64_t>& total = slot->totalNs[s];
+    total.store(total.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+
+    // The aggregator only ever resets this to zero, so a lost race merely
+    // moves this duration into the next interval
+    std::atomic<uint64_t>& maximum = slot->maxNs[s];
+    if (ns > maximum.load(std::memory_order_relaxed)) {
+        maximum.store(ns, std::memory_order_relaxed);
+    }
+}
+
+void setAudioPeriod(uint64_t frames, double sampleRate) {
+    if (sampleRate > 0.0) {
+        audioPeriodNs.store(static_cast<uint64_t>(static_cast<double>(frames) * 1e9 / sampleRate),
+                            std::memory_order_relaxed);
+    }
+}
+
+bool update(double intervalSeconds) {
+    Aggregator& agg = aggregator();
+    std::lock_guard<std::mutex> lock(agg.mutex);
+
+    uint64_t now = nowNs();
+    bool baseline = agg.lastRefreshNs == 0;
+    if (!baseline && static_cast<double>(now - agg.lastRefreshNs) < intervalSeconds * 1e9) {
+        return false;
+    }
+
+    Snapshot s;
+    for (size_t i = 0; i < kNumStages; ++i) {
+        // Counters only grow, so their sum over all slots does too
+        uint64_t window[kBuckets];
+        uint64_t count = 0;
+        for (size_t b = 0; b < kBuckets; ++b) {
+            uint64_t sum = 0;
+            for (const ThreadSlot& slot : slots) {
+                sum += slot.counts[i][b].load(std::memory_order_relaxed);
+            }
+            window[b] = sum - agg.previousCounts[i][b];
+            agg.previousCounts[i][b] = sum;
+            count += window[b];
+        }
+
+        uint64_t totalNs = 0;
+        uint64_t maxNs = 0;
+        for (ThreadSlot& slot : slots) {
+            totalNs += slot.totalNs[i].load(std::memory_order_relaxed);
+            maxNs = (std::max)(maxNs, slot.maxNs[i].exchange(0, std::memory_order_relaxed));
+        }
+        uint64_t windowNs = totalNs - agg.previousTotalNs[i];
+        agg.previousTotalNs[i] = totalNs;
+
+        StageStats& st = s.stages[i];
+        st = StageStats{};
+        st.count = count;
+        if (count > 0) {
+            // Bucket limits overestimate; the exact maximum bounds them
+            st.maxUs = static_cast<double>(maxNs) / 1000.0;
+            st.p50Us = (std::min)(quantileUs(window, count, 0.50), st.maxUs);
+            st.p99Us = (std::min)(quantileUs(window, count, 0.99), st.maxUs);
+            st.meanUs = static_cast<double>(windowNs) / static_cast<double>(count) / 1000.0;
+        }
+    }
+
+    // The first call only sets the starting point
+    if (baseline) {
+        agg.lastRefreshNs = now;
+        return false;
+    }
+
+    s.audioPeriodUs = static_cast<double>(audioPeriodNs.load(std::memory_order_relaxed)) / 1000.0;
+    s.intervalSeconds = static_cast<double>(now - agg.lastRefreshNs) / 1e9;
+    s.sequence = agg.latest.sequence + 1;
+    agg.latest = s;
+    agg.lastRefreshNs = now;
+
+    if (agg.log.is_open()) {
+        writeLogRecord(agg);
+    }
+    return true;
+}
+
+Snapshot snapshot() {
+    Aggregator& agg = aggregator();
+    std::lock_guard<std::mutex> lock(agg.mutex);
+    return agg.latest;
+}
+
+std::string formatStage(const Snapshot& snapshot, Stage stage) {
+    const StageStats& st = snapshot.stage(stage);
+    double rate = snapshot.intervalSeconds > 0.0 ? st.count / snapshot.intervalSeconds : 0.0;
+    char text[128];
+    std::snprintf(text, sizeof(text), "%-13s p50 %-7s p99 %-7s max %-7s %.0f/s", stageName(stage),
+                  formatDuration(st.p50Us).c_str(), formatDuration(st.p99Us).c_str(),
+                  formatDuration(st.maxUs).c_str(), rate);
+    return text;
+}
+
+std::string formatLoad(const Snapshot& snapshot, Stage audioStage) {
+    const StageStats& st = snapshot.stage(audioStage);
+    if (st.count == 0 || snapshot.audioPeriodUs <= 0.0) {
+        return "DSP idle";
+    }
+    char text[128];
+    std::snprintf(text, sizeof(text), "DSP %.0f%% (p99 %.0f%%, max %.0f%%) of %s",
+                  snapshot.loadPercent(st.meanUs), snapshot.loadPercent(st.p99Us),
+                  snapshot.loadPercent(st.maxUs), formatDuration(snapshot.audioPeriodUs).c_str());
+    return text;
+}
+
+bool openLog(const std::string& path) {
+    Aggregator& agg = aggregator();
+    std::lock_guard<std::mutex> lock(agg.mutex);
+
+    // Appending; a new or empty file gets the CSV header below
+    bool empty = !std::ifstream(path, std::ios::ate) || std::ifstream(path, std::ios::ate).tellg() <= 0;
+
+    if (agg.log.is_open()) agg.log.close();
+    agg.log.clear();
+    agg.log.open(path, std::ios::app);
+    if (!agg.log) return false;
+
+    auto endsWith = [&path](const char* suffix) {
+        std::string s(suffix);
+        return path.size() >= s.size() && path.compare(path.size() - s.size(), s.size(), s) == 0;
+    };
+    agg.logJson = endsWith(".json") || endsWith(".jsonl");
+
+    if (!agg.logJson && empty) {
+        agg.log << "timestamp,stage,count,p50_us,p99_us,max_us,mean_us,p99_load_pct\n";
+    }
+    return true;
+}
+
+bool openLogFromEnvironment() {
+    const char* path = std::getenv("SPECTRUM_PERF_LOG");
+    if (!path || !*path) return true;
+    return openLog(path);
+}
+
+} // namespace perf
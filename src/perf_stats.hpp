@@ -0,0 +1,161 @@
+#pragma once
+
+/**
+ * Hot-path instrumentation: scoped stage timers and latency histograms
+ *
+ * A ScopedTimer is two clock reads and a few relaxed stores, safe on the
+ * audio thread. Durations go into log-scale per-thread histograms (about
+ * 20% resolution); one process-wide aggregator turns them into p50/p99/max
+ * per stage and can log every refresh as CSV or JSON lines.
+ */
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace perf {
+
+/**
+ * Instrumented stages
+ */
+enum class Stage : uint32_t {
+    AudioCallback,  // Standalone device callback
+    Decode,         // Standalone decoder thread, per block
+    Equalizer,      // EQProcessor block processing, timed by its callers
+    Analysis,       // One analysis frame (computeSpectrum)
+    Fft,            // FFTs of one frame
+    Banding,        // Band mapping of one frame
+    Process,        // VST PluginProcessor::process
+    Render,         // One UI frame
+    Draw,           // Spectrum drawing within a frame
+    Count
+};
+
+constexpr size_t kNumStages = static_cast<size_t>(Stage::Count);
+
+const char* stageName(Stage stage);
+
+/**
+ * Monotonic time in nanoseconds
+ */
+inline uint64_t nowNs() {
+    using namespace std::chrono;
+    return static_cast<uint64_t>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * Give the calling thread its own histogram slot. Call at thread setup,
+ * not from an audio callback; does nothing once registered or when the
+ * table is full (the thread then shares the common slot).
+ */
+void registerThread();
+
+/**
+ * Hand the calling thread's slot back (thread teardown)
+ */
+void releaseThread();
+
+/**
+ * Add one duration to the calling thread's histogram (lock-free, no
+ * allocation; unregistered threads use atomic adds on a shared slot)
+ * @param stage Stage timed
+ * @param ns Duration in nanoseconds
+ */
+void record(Stage stage, uint64_t ns);
+
+/**
+ * Report the length of the audio buffer being processed, the reference
+ * for DSP load (audio thread, once per buffer)
+ * @param frames Frames in the buffer
+ * @param sampleRate Sample rate in Hz
+ */
+void setAudioPeriod(uint64_t frames, double sampleRate);
+
+/**
+ * Times its own lifetime as one call of a stage
+ */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Stage stage) : stage_(stage), start_(nowNs()) {}
+    ~ScopedTimer() { record(stage_, nowNs() - start_); }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Stage stage_;
+    uint64_t start_;
+};
+
+/**
+ * One stage over the last refresh interval
+ */
+struct StageStats {
+    uint64_t count = 0;     // Calls
+    double p50Us = 0.0;
+    double p99Us = 0.0;
+    double maxUs = 0.0;
+    double meanUs = 0.0;
+};
+
+/**
+ * All stages over the last refresh interval
+ */
+struct Snapshot {
+    std::array<StageStats, kNumStages> stages{};
+    double audioPeriodUs = 0.0;     // Latest reported buffer period (0 = none)
+    double intervalSeconds = 0.0;   // Length of the interval
+    uint64_t sequence = 0;          // Increments with every refresh
+
+    const StageStats& stage(Stage s) const { return stages[static_cast<size_t>(s)]; }
+
+    /**
+     * A duration as a percentage of the audio buffer period
+     * @return 0 when no period was reported
+     */
+    double loadPercent(double us) const {
+        return audioPeriodUs > 0.0 ? 100.0 * us / audioPeriodUs : 0.0;
+    }
+};
+
+/**
+ * One overlay line for a stage, e.g. "Analysis  p50 120us  p99 310us  max 0.4ms  86/s"
+ */
+std::string formatStage(const Snapshot& snapshot, Stage stage);
+
+/**
+ * One overlay line for the DSP load of the audio stage (AudioCallback or
+ * Process) relative to the buffer period, e.g. "DSP 12% (p99 31%, max 40%) of 10.7ms"
+ */
+std::string formatLoad(const Snapshot& snapshot, Stage audioStage);
+
+/**
+ * Refresh the statistics once the interval has passed since the last
+ * refresh; writes a log record when a log is open (UI threads)
+ * @param intervalSeconds Minimum time between refreshes
+ * @return true if the statistics were refreshed
+ */
+bool update(double intervalSeconds = 1.0);
+
+/**
+ * Copy of the latest refreshed statistics
+ */
+Snapshot snapshot();
+
+/**
+ * Append every refresh to a log file: JSON lines if the path ends in
+ * .json or .jsonl, CSV otherwise
+ * @param path Log file path
+ * @return false if the file could not be opened
+ */
+bool openLog(const std::string& path);
+
+/**
+ * Open the log named by the SPECTRUM_PERF_LOG environment variable, if set
+ * @return false if the variable is set but the file could not be opened
+ */
+bool openLogFromEnvironment();
+
+} // namespace perf
@@ -0,0 +1,23 @@
+#include "realtime_guard.hpp"
+
+#ifndef NDEBUG
+
+namespace rt {
+
+static thread_local int noAllocationDepth = 0;
+
+bool isAllocationForbidden() {
+    return noAllocationDepth > 0;
+}
+
+void enterNoAllocationScope() {
+    ++noAllocationDepth;
+}
+
+void leaveNoAllocationScope() {
+    --noAllocationDepth;
+}
+
+} // namespace rt
+
+#endif // NDEBUG
@@ -0,0 +1,48 @@
+#pragma once
+
+/**
+ * Realtime allocation guard - debug-build check for audio threads
+ *
+ * While a ScopedNoAllocation is alive on the current thread, any call to
+ * the global operator new/delete asserts. The check needs the replacement
+ * operators in realtime_guard_hooks.cpp, which only the test targets link
+ * by default (ENABLE_ALLOCATION_GUARD adds them to the app and plugin).
+ * Release builds (NDEBUG) compile the guard away entirely.
+ */
+
+namespace rt {
+
+#ifndef NDEBUG
+
+/**
+ * Check whether heap allocation is forbidden on the calling thread
+ * @return True inside a ScopedNoAllocation
+ */
+bool isAllocationForbidden();
+
+void enterNoAllocationScope();
+void leaveNoAllocationScope();
+
+class ScopedNoAllocation {
+public:
+    ScopedNoAllocation() { enterNoAllocationScope(); }
+    ~ScopedNoAllocation() { leaveNoAllocationScope(); }
+    
+    ScopedNoAllocation(const ScopedNoAllocation&) = delete;
+    ScopedNoAllocation& operator=(const ScopedNoAllocation&) = delete;
+};
+
+#else
+
+inline bool isAllocationForbidden() { return false; }
+
+class ScopedNoAllocation {
+public:
+    ScopedNoAllocation() = default;
+    ScopedNoAllocation(const ScopedNoAllocation&) = delete;
+    ScopedNoAllocation& operator=(const ScopedNoAllocation&) = delete;
+};
+
+#endif
+
+} // namespace rt
@@ -0,0 +1,93 @@
+// Global allocation hooks for the realtime allocation guard. Replacing
+// operator new/delete affects the whole process, so this file is only
+// compiled into the test targets and, with ENABLE_ALLOCATION_GUARD, into
+// the standalone and the plugin.
+
+#include "realtime_guard.hpp"
+
+#ifndef NDEBUG
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+static void* guardedAlloc(std::size_t size) {
+    assert(!rt::isAllocationForbidden() && "heap allocation on a realtime thread");
+    void* p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+static void guardedFree(void* p) noexcept {
+    if (!p) return;
+    assert(!rt::isAllocationForbidden() && "heap deallocation on a realtime thread");
+    std::free(p);
+}
+
+// Over-aligned types (SIMD buffers) come through the std::align_val_t forms
+static void* guardedAlignedAlloc(std::size_t size, std::align_val_t alignment) {
+    assert(!rt::isAllocationForbidden() && "heap allocation on a realtime thread");
+    std::size_t align = (std::max)(static_cast<std::size_t>(alignment), sizeof(void*));
+#ifdef _WIN32
+    void* p = _aligned_malloc(size ? size : 1, align);
+#else
+    void* p = nullptr;
+    if (posix_memalign(&p, align, size ? size : 1) != 0) p = nullptr;
+#endif
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+static void guardedAlignedFree(void* p) noexcept {
+    if (!p) return;
+    assert(!rt::isAllocationForbidden() && "heap deallocation on a realtime thread");
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void* operator new(std::size_t size) { return guardedAlloc(size); }
+void* operator new[](std::size_t size) { return guardedAlloc(size); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try { return guardedAlloc(size); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try { return guardedAlloc(size); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* p) noexcept { guardedFree(p); }
+void operator delete[](void* p) noexcept { guardedFree(p); }
+void operator delete(void* p, std::size_t) noexcept { guardedFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { guardedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { guardedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { guardedFree(p); }
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return guardedAlignedAlloc(size, alignment);
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return guardedAlignedAlloc(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    try { return guardedAlignedAlloc(size, alignment); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    try { return guardedAlignedAlloc(size, alignment); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* p, std::align_val_t) noexcept { guardedAlignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { guardedAlignedFree(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { guardedAlignedFree(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { guardedAlignedFree(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { guardedAlignedFree(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { guardedAlignedFree(p); }
+
+#endif // NDEBUG
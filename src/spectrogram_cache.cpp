@@ -0,0 +1,359 @@
+#include "spectrogram_cache.hpp"
+#include "frame_analyzer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace audio {
+
+namespace {
+
+constexpr char kMagic[4] = {'S', 'P', 'G', 'M'};
+constexpr uint32_t kVersion = 3;    // v1: unindexed float32 frames, v2: no source size or channels
+
+// 16-bit dB quantization; code 0 is silence
+constexpr float kMinDb = -140.0f;
+constexpr float kMaxDb = 20.0f;
+constexpr uint32_t kMaxCode = 65535;
+
+// Fixed-size little-endian header; every section starts 8-byte aligned
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t sourceHash;
+    uint64_t sourceSize;
+    uint64_t configHash;
+    uint32_t sampleRate;
+    uint32_t channels;
+    uint32_t fftSize;
+    uint32_t hopSize;
+    uint32_t numBands;
+    uint32_t reserved;
+    uint64_t numFrames;
+    float minDb;
+    float maxDb;
+    uint64_t frequenciesOffset;   // float32[numBands]
+    uint64_t levelsOffset;        // FrameLevels[numFrames]
+    uint64_t dataOffset;          // uint16[numFrames * numBands]
+};
+
+static_assert(sizeof(FrameLevels) == 12, "FrameLevels is part of the file format");
+
+uint64_t alignTo8(uint64_t value) {
+    return (value + 7) & ~uint64_t(7);
+}
+
+// 64-bit FNV-1a, one byte per step
+constexpr uint64_t kFnvOffset = 14695981039346656037ull;
+constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+uint64_t fnvBytes(uint64_t hash, const uint8_t* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * kFnvPrime;
+    }
+    return hash;
+}
+
+// Integers are hashed as their 8 little-endian bytes
+uint64_t fnvMix(uint64_t hash, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        hash = (hash ^ (value & 0xff)) * kFnvPrime;
+        value >>= 8;
+    }
+    return hash;
+}
+
+// File fingerprint: this many evenly spaced blocks, first and last included
+constexpr size_t kSampledBlocks = 16;
+constexpr size_t kSampledBlockSize = 64 * 1024;
+
+uint64_t doubleBits(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+uint16_t quantizeDb(float power) {
+    if (!(power > 0.0f)) return 0;
+
+    float db = 10.0f * std::log10(power);
+    if (db <= kMinDb) return 0;
+
+    float step = (kMaxDb - kMinDb) / static_cast<float>(kMaxCode - 1);
+    long code = 1 + std::lround((db - kMinDb) / step);
+    return static_cast<uint16_t>((std::min)(code, static_cast<long>(kMaxCode)));
+}
+
+} // namespace
+
+bool writeSpectrogram(const std::string& filepath, const Spectrogram& spectrogram,
+                      const SourceInfo& source, uint64_t configHash) {
+    size_t numBands = spectrogram.numBands;
+    size_t numFrames = static_cast<size_t>(spectrogram.numFrames);
+    if (spectrogram.frequencies.size() != numBands ||
+        spectrogram.power.size() != numFrames * numBands ||
+        spectrogram.levels.size() != numFrames) {
+        return false;
+    }
+
+    FileHeader header = {};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.sourceHash = source.hash;
+    header.sourceSize = source.size;
+    header.configHash = configHash;
+    header.sampleRate = spectrogram.sampleRate;
+    header.channels = spectrogram.channels;
+    header.fftSize = spectrogram.fftSize;
+    header.hopSize = spectrogram.hopSize;
+    header.numBands = spectrogram.numBands;
+    header.numFrames = spectrogram.numFrames;
+    header.minDb = kMinDb;
+    header.maxDb = kMaxDb;
+    header.frequenciesOffset = alignTo8(sizeof(FileHeader));
+    header.levelsOffset = alignTo8(header.frequenciesOffset + numBands * sizeof(float));
+    header.dataOffset = alignTo8(header.levelsOffset + numFrames * sizeof(FrameLevels));
+
+    std::ofstream out(filepath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+
+    const char padding[8] = {};
+    auto padTo = [&](uint64_t offset) {
+        uint64_t position = static_cast<uint64_t>(out.tellp());
+        out.write(padding, static_cast<std::streamsize>(offset - position));
+    };
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    padTo(header.frequenciesOffset);
+    out.write(reinterpret_cast<const char*>(spectrogram.frequencies.data()),
+              static_cast<std::streamsize>(numBands * sizeof(float)));
+
+    padTo(header.levelsOffset);
+    out.write(reinterpret_cast<const char*>(spectrogram.levels.data()),
+              static_cast<std::streamsize>(numFrames * sizeof(FrameLevels)));
+
+    padTo(header.dataOffset);
+    std::vector<uint16_t> row(numBands);
+    for (size_t frame = 0; frame < numFrames; ++frame) {
+        const float* power = spectrogram.frame(frame);
+        for (size_t band = 0; band < numBands; ++band) {
+            row[band] = quantizeDb(power[band]);
+        }
+        out.write(reinterpret_cast<const char*>(row.data()),
+                  static_cast<std::streamsize>(numBands * sizeof(uint16_t)));
+    }
+
+    return static_cast<bool>(out);
+}
+
+bool SpectrogramReader::open(const std::string& filepath) {
+    close();
+
+    if (!file_.open(filepath) || file_.size() < sizeof(FileHeader)) {
+        close();
+        return false;
+    }
+
+    FileHeader header;
+    std::memcpy(&header, file_.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+        header.hopSize == 0 || header.maxDb <= header.minDb) {
+        close();
+        return false;
+    }
+
+    // Every section must lie inside the file
+    uint64_t size = file_.size();
+    uint64_t numBands = header.numBands;
+    uint64_t numFrames = header.numFrames;
+    bool fits = header.frequenciesOffset % 8 == 0 && header.levelsOffset % 8 == 0 &&
+                header.dataOffset % 8 == 0 &&
+                header.frequenciesOffset + numBands * sizeof(float) <= size &&
+                numFrames <= size / sizeof(FrameLevels) &&
+                header.levelsOffset + numFrames * sizeof(FrameLevels) <= size &&
+                (numBands == 0 || numFrames <= size / (numBands * sizeof(uint16_t))) &&
+                header.dataOffset + numFrames * numBands * sizeof(uint16_t) <= size;
+    if (!fits) {
+        close();
+        return false;
+    }
+
+    sourceHash_ = header.sourceHash;
+    sourceSize_ = header.sourceSize;
+    configHash_ = header.configHash;
+    sampleRate_ = header.sampleRate;
+    channels_ = header.channels;
+    fftSize_ = header.fftSize;
+    hopSize_ = header.hopSize;
+    numBands_ = header.numBands;
+    numFrames_ = header.numFrames;
+    minDb_ = header.minDb;
+    dbPerStep_ = (header.maxDb - header.minDb) / static_cast<float>(kMaxCode - 1);
+
+    const uint8_t* base = file_.data();
+    frequencies_ = reinterpret_cast<const float*>(base + header.frequenciesOffset);
+    levels_ = reinterpret_cast<const FrameLevels*>(base + header.levelsOffset);
+    data_ = reinterpret_cast<const uint16_t*>(base + header.dataOffset);
+    return true;
+}
+
+void SpectrogramReader::close() {
+    file_.close();
+    numFrames_ = 0;
+    numBands_ = 0;
+    frequencies_ = nullptr;
+    levels_ = nullptr;
+    data_ = nullptr;
+}
+
+uint64_t SpectrogramReader::frameAt(uint64_t sampleFrame) const {
+    // Frame i covers the window ending at (i + 1) * hopSize
+    uint64_t completed = sampleFrame / hopSize_;
+    uint64_t index = completed > 0 ? completed - 1 : 0;
+    return (std::min)(index, numFrames_ - 1);
+}
+
+void SpectrogramReader::readPower(uint64_t index, double* power, double gain) const {
+    const uint16_t* row = data_ + index * numBands_;
+    double powerGain = gain * gain;
+    for (uint32_t band = 0; band < numBands_; ++band) {
+        uint16_t code = row[band];
+        if (code == 0) {
+            power[band] = 0.0;
+        } else {
+            double db = minDb_ + (code - 1) * static_cast<double>(dbPerStep_);
+            power[band] = powerGain * std::pow(10.0, db / 10.0);
+        }
+    }
+}
+
+void SpectrogramReader::readDb(uint64_t index, float* db) const {
+    const uint16_t* row = data_ + index * numBands_;
+    for (uint32_t band = 0; band < numBands_; ++band) {
+        db[band] = minDb_ + (row[band] == 0 ? 0 : row[band] - 1) * dbPerStep_;
+    }
+}
+
+SpectrogramCache::SpectrogramCache(std::string directory) : directory_(std::move(directory)) {
+}
+
+std::string SpectrogramCache::defaultDirectory() {
+    std::filesystem::path base;
+#ifdef _WIN32
+    if (const char* localAppData = std::getenv("LOCALAPPDATA")) {
+        base = std::filesystem::path(localAppData) / "AudioSpectrumVisualizer";
+    }
+#else
+    if (const char* xdgCache = std::getenv("XDG_CACHE_HOME")) {
+        base = std::filesystem::path(xdgCache) / "AudioSpectrumVisualizer";
+    } else if (const char* home = std::getenv("HOME")) {
+        base = std::filesystem::path(home) / ".cache" / "AudioSpectrumVisualizer";
+    }
+#endif
+    if (base.empty()) {
+        base = "AudioSpectrumVisualizer";
+    }
+    return (base / "spectrograms").string();
+}
+
+SourceInfo SpectrogramCache::hashFile(const std::string& filepath) {
+    SourceInfo source;
+    std::error_code error;
+    auto modified = std::filesystem::last_write_time(filepath, error);
+    util::MappedFile file;
+    if (error || !file.open(filepath)) {
+        return source;
+    }
+
+    uint64_t hash = fnvMix(kFnvOffset, file.size());
+    hash = fnvMix(hash, static_cast<uint64_t>(modified.time_since_epoch().count()));
+
+    // Small files are hashed whole; larger ones by sampled blocks, so only
+    // those pages of the mapping are ever read
+    size_t size = file.size();
+    if (size <= kSampledBlocks * kSampledBlockSize) {
+        hash = fnvBytes(hash, file.data(), size);
+    } else {
+        size_t stride = (size - kSampledBlockSize) / (kSampledBlocks - 1);
+        for (size_t block = 0; block < kSampledBlocks; ++block) {
+            size_t offset = block + 1 < kSampledBlocks ? block * stride : size - kSampledBlockSize;
+            hash = fnvBytes(hash, file.data() + offset, kSampledBlockSize);
+        }
+    }
+    source.hash = hash ? hash : 1;      // 0 means "unknown"
+    source.size = file.size();
+    return source;
+}
+
+uint64_t SpectrogramCache::hashConfig(const AnalyzerConfig& config) {
+    uint64_t hash = kFnvOffset;
+    hash = fnvMix(hash, FrameAnalyzer::kRevision);
+    hash = fnvMix(hash, config.fftSize);
+    hash = fnvMix(hash, config.hopSize);
+    hash = fnvMix(hash, static_cast<uint64_t>(config.window));
+    hash = fnvMix(hash, config.numBands);
+    hash = fnvMix(hash, doubleBits(config.minFrequency));
+    hash = fnvMix(hash, doubleBits(config.maxFrequency));
+    hash = fnvMix(hash, config.useLogScale ? 1 : 0);
+    hash = fnvMix(hash, static_cast<uint64_t>(config.bandReduction));
+    hash = fnvMix(hash, config.multiResolution ? 1 : 0);
+    return hash;
+}
+
+std::string SpectrogramCache::entryPath(const SourceInfo& source, const AnalyzerConfig& config) const {
+    char name[64];
+    std::snprintf(name, sizeof(name), "%016llx-%016llx.spgm",
+                  static_cast<unsigned long long>(source.hash),
+                  static_cast<unsigned long long>(hashConfig(config)));
+    return (std::filesystem::path(directory_) / name).string();
+}
+
+bool SpectrogramCache::store(const SourceInfo& source, const AnalyzerConfig& config,
+                             const Spectrogram& spectrogram) const {
+    std::error_code error;
+    std::filesystem::create_directories(directory_, error);
+
+    // Write under a temporary name so readers never see a partial entry
+    std::string path = entryPath(source, config);
+    std::string temporary = path + ".tmp";
+    if (!writeSpectrogram(temporary, spectrogram, source, hashConfig(config))) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+bool SpectrogramCache::open(const SourceInfo& source, const AnalyzerConfig& config,
+                            SpectrogramReader& reader) const {
+    if (source.hash == 0 || !reader.open(entryPath(source, config))) {
+        return false;
+    }
+
+    // Guard against renamed or hand-copied entries and hash collisions
+    if (reader.sourceHash() != source.hash || reader.sourceSize() != source.size ||
+        (source.sampleRate != 0 && reader.sampleRate() != source.sampleRate) ||
+        (source.channels != 0 && reader.channels() != source.channels) ||
+        reader.configHash() != hashConfig(config) ||
+        reader.numBands() != config.numBands || reader.numFrames() == 0) {
+        reader.close();
+        return false;
+    }
+    return true;
+}
+
+} // namespace audio
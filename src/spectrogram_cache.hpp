@@ -0,0 +1,183 @@
+#pragma once
+
+/**
+ * On-disk spectrogram files and the analysis cache
+ *
+ * A .spgm file stores per-hop band power quantized to 16-bit dB and
+ * per-frame levels, behind a versioned header. Frames have a fixed stride,
+ * so the frame for any timestamp is found by arithmetic and read straight
+ * from the memory-mapped file.
+ *
+ * The cache keeps one .spgm per (file, analysis settings) pair, named by
+ * both hashes, so reopened tracks skip decoding and FFTs. A file is keyed by
+ * its size, modification time and a few sampled blocks, so the key costs the
+ * same for any file length. Entries also record the file size and decoded
+ * format, which must match too.
+ */
+
+#include "audio_analyzer.hpp"
+#include "mapped_file.hpp"
+#include "offline_analyzer.hpp"
+#include <cstdint>
+#include <string>
+
+namespace audio {
+
+/**
+ * Identity of an analyzed file, as far as the cache checks it
+ */
+struct SourceInfo {
+    uint64_t hash = 0;          // File fingerprint (0 = unknown)
+    uint64_t size = 0;          // File size in bytes
+    uint32_t sampleRate = 0;    // Decoded sample rate (0 = not checked)
+    uint32_t channels = 0;      // Decoded channels (0 = not checked)
+};
+
+/**
+ * Write a spectrogram file (.spgm, current version)
+ * @param filepath Output path
+ * @param spectrogram Data to write
+ * @param source Analyzed file (hash and size are stored; zero if unknown)
+ * @param configHash Hash of the analysis settings (0 if unknown)
+ * @return True if the whole file was written
+ */
+bool writeSpectrogram(const std::string& filepath, const Spectrogram& spectrogram,
+                      const SourceInfo& source = SourceInfo(), uint64_t configHash = 0);
+
+/**
+ * Read-only, memory-mapped view of a .spgm file
+ */
+class SpectrogramReader {
+public:
+    SpectrogramReader() = default;
+
+    /**
+     * Map and validate a file
+     * @param filepath .spgm file
+     * @return True if the file is a complete spectrogram of a supported version
+     */
+    bool open(const std::string& filepath);
+
+    void close();
+    bool isOpen() const { return file_.isOpen(); }
+
+    uint64_t sourceHash() const { return sourceHash_; }
+    uint64_t sourceSize() const { return sourceSize_; }
+    uint64_t configHash() const { return configHash_; }
+    uint32_t sampleRate() const { return sampleRate_; }
+    uint32_t channels() const { return channels_; }
+    uint32_t fftSize() const { return fftSize_; }
+    uint32_t hopSize() const { return hopSize_; }
+    uint32_t numBands() const { return numBands_; }
+    uint64_t numFrames() const { return numFrames_; }
+
+    /**
+     * Center frequency of each band in Hz (numBands entries)
+     */
+    const float* frequencies() const { return frequencies_; }
+
+    /**
+     * Frame whose analysis window ends at or before a stream position
+     * @param sampleFrame Stream position in sample frames
+     * @return Frame index, clamped to the available frames (needs numFrames > 0)
+     */
+    uint64_t frameAt(uint64_t sampleFrame) const;
+
+    /**
+     * Levels of one frame
+     * @param index Frame index (< numFrames)
+     */
+    const FrameLevels& levels(uint64_t index) const { return levels_[index]; }
+
+    /**
+     * Dequantize one frame to band power
+     * @param index Frame index (< numFrames)
+     * @param power Output, numBands band powers (squared amplitudes)
+     * @param gain Linear amplitude factor applied to every band
+     */
+    void readPower(uint64_t index, double* power, double gain = 1.0) const;
+
+    /**
+     * Dequantize one frame to dB
+     * @param index Frame index (< numFrames)
+     * @param db Output, numBands values (silence reads as the format floor)
+     */
+    void readDb(uint64_t index, float* db) const;
+
+private:
+    util::MappedFile file_;
+
+    uint64_t sourceHash_ = 0;
+    uint64_t sourceSize_ = 0;
+    uint64_t configHash_ = 0;
+    uint32_t sampleRate_ = 0;
+    uint32_t channels_ = 0;
+    uint32_t fftSize_ = 0;
+    uint32_t hopSize_ = 0;
+    uint32_t numBands_ = 0;
+    uint64_t numFrames_ = 0;
+    float minDb_ = 0.0f;
+    float dbPerStep_ = 0.0f;
+
+    const float* frequencies_ = nullptr;
+    const FrameLevels* levels_ = nullptr;
+    const uint16_t* data_ = nullptr;
+};
+
+/**
+ * Directory of .spgm files keyed by file fingerprint and analysis settings
+ */
+class SpectrogramCache {
+public:
+    /**
+     * @param directory Cache location (created on first store)
+     */
+    explicit SpectrogramCache(std::string directory = defaultDirectory());
+
+    /**
+     * Per-user cache directory for this application
+     */
+    static std::string defaultDirectory();
+
+    /**
+     * Fingerprint a file from its size, modification time and sampled blocks
+     * (reads at most 1 MiB, so it is cheap enough for the UI thread)
+     * @param filepath File to hash
+     * @return Hash and size (sample rate and channels are left to the caller);
+     *         a zero hash if the file can't be read
+     */
+    static SourceInfo hashFile(const std::string& filepath);
+
+    /**
+     * Hash the settings that change analysis output (smoothing is excluded)
+     * @param config Analyzer configuration
+     * @return 64-bit hash
+     */
+    static uint64_t hashConfig(const AnalyzerConfig& config);
+
+    /**
+     * Path of the entry for a file and configuration
+     */
+    std::string entryPath(const SourceInfo& source, const AnalyzerConfig& config) const;
+
+    /**
+     * Store an analysis (written to a temporary file, then renamed)
+     * @return True if stored
+     */
+    bool store(const SourceInfo& source, const AnalyzerConfig& config, const Spectrogram& spectrogram) const;
+
+    /**
+     * Open the entry for a file and configuration
+     * @param source Analyzed file; hash, size and any nonzero format fields must match
+     * @param reader Output reader
+     * @return True if a matching entry exists
+     */
+    bool open(const SourceInfo& source, const AnalyzerConfig& config, SpectrogramReader& reader) const;
+
+    const std::string& getDirectory() const { return directory_; }
+
+private:
+    std::string directory_;
+};
+
+} // namespace audio
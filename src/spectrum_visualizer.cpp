@@ -1,6 +1,8 @@
 #include "spectrum_visualizer.hpp"
 #include "shared_colors.hpp"
 #include "eq_processor.hpp"
+#include "perf_stats.hpp"
+#include <rlgl.h>
 #include <cmath>
 #include <algorithm>
 #include <sstream>
@@ -53,6 +55,15 @@ SpectrumVisualizer::~SpectrumVisualizer() {
     if (fontLoaded_) {
         UnloadFont(font_);
     }
+    if (staticLayer_.id != 0) {
+        UnloadRenderTexture(staticLayer_);
+    }
+    if (spectrogram_.id != 0) {
+        UnloadTexture(spectrogram_);
+    }
+    if (particleTexture_.id != 0) {
+        UnloadTexture(particleTexture_);
+    }
     CloseWindow();
 }
 
@@ -120,6 +131,11 @@ void SpectrumVisualizer::handleInput(audio::AudioAnalyzer& analyzer) {
         config_.showInfo = !config_.showInfo;
     }
     
+    // F3 - toggle performance overlay
+    if (IsKeyPressed(KEY_F3)) {
+        config_.showPerf = !config_.showPerf;
+    }
+    
     // P - toggle peaks
     if (IsKeyPressed(KEY_P)) {
         config_.showPeaks = !config_.showPeaks;
@@ -202,48 +218,49 @@ void SpectrumVisualizer::render(const audio::SpectrumData& spectrum, audio::Audi
     // Handle EQ input first (before BeginDrawing for proper mouse handling)
     handleEQInput(analyzer);
     
-    BeginDrawing();
+    // Refresh the background layer if needed (outside BeginDrawing)
+    updateStaticLayer();
     
-    // Clear with gradient background
-    ClearBackground(config_.theme.background);
+    BeginDrawing();
+    uint64_t frameStart = perf::nowNs();
     
-    // Draw subtle gradient overlay
-    DrawRectangleGradientV(0, 0, GetScreenWidth(), GetScreenHeight(), 
-                           Fade(config_.theme.barMid, 0.05f), 
-                           Fade(config_.theme.background, 0.0f));
+    // Background, gradient and grid
+    drawStaticLayer();
     
-    // Update peaks
+    // Update peaks (long stalls count as a few frames, not a sudden drop)
+    frameStep_ = SAFE_MIN(GetFrameTime(), 0.1f) * 60.0f;
     updatePeaks(spectrum);
     
-    // Render based on style
+    // Render based on style (grids are part of the static layer)
+    uint64_t drawStart = perf::nowNs();
     switch (config_.style) {
         case VisualizerStyle::Line:
-            // Line mode has its own grid built-in
             renderLine(spectrum);
             renderEQControls(analyzer);
             break;
         case VisualizerStyle::Bars:
-            if (config_.showGrid) renderGrid();
             renderBars(spectrum);
             break;
         case VisualizerStyle::Waves:
-            if (config_.showGrid) renderGrid();
             renderWaves(spectrum);
             break;
         case VisualizerStyle::Circles:
-            if (config_.showGrid) renderGrid();
             renderCircles(spectrum);
             break;
         case VisualizerStyle::Particles:
-            if (config_.showGrid) renderGrid();
             updateParticles(spectrum);
             renderParticles(spectrum);
             break;
         case VisualizerStyle::Mirror:
-            if (config_.showGrid) renderGrid();
             renderMirror(spectrum);
             break;
+        case VisualizerStyle::Spectrogram:
+            // Rows come from raw analysis frames, not the blended display frame
+            updateSpectrogram(analyzer.getLatestFrame());
+            renderSpectrogram(spectrum);
+            break;
     }
+    perf::record(perf::Stage::Draw, perf::nowNs() - drawStart);
     
     // Render UI elements
     renderProgressBar(analyzer);
@@ -254,6 +271,14 @@ void SpectrumVisualizer::render(const audio::SpectrumData& spectrum, audio::Audi
     
     renderControls();
     
+    // Statistics refresh once a second, shown or not (they may be logged)
+    perf::update();
+    if (config_.showPerf) {
+        renderPerfOverlay();
+    }
+    
+    // Frame time up to the present (EndDrawing also waits for the target FPS)
+    perf::record(perf::Stage::Render, perf::nowNs() - frameStart);
     EndDrawing();
 }
 
@@ -261,7 +286,7 @@ void SpectrumVisualizer::renderLine(const audio::SpectrumData& spectrum) {
     int width = GetScreenWidth();
     int height = GetScreenHeight();
     
-    size_t numBands = spectrum.magnitudes.size();
+    size_t numBands = spectrum.magnitudesDb.size();
     if (numBands == 0) return;
     
     // Define drawing area with margins
@@ -285,55 +310,20 @@ void SpectrumVisualizer::renderLine(const audio::SpectrumData& spectrum) {
         peakHoldDecay_.resize(numBands, 0.0f);
     }
     
-    // Draw dB scale on left side
-    Color gridColor = Fade(config_.theme.textDim, 0.3f);
-    for (float db = dbMin; db <= dbMax; db += 6.0f) {
-        float yNorm = (db - dbMin) / dbRange;
-        int y = baseY - static_cast<int>(yNorm * graphHeight);
-        
-        // Horizontal grid line
-        DrawLine(marginLeft, y, width - marginRight, y, gridColor);
-        
-        // dB label
-        char label[16];
-        snprintf(label, sizeof(label), "%+.0f", db);
-        DrawText(label, 5, y - 7, 14, config_.theme.textDim);
-    }
-    
-    // Draw frequency scale on bottom
-    const double freqMarkers[] = {20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000};
-    for (int i = 0; i < 10; ++i) {
-        float logPos = (std::log10(freqMarkers[i]) - std::log10(20.0)) / 
-                       (std::log10(20000.0) - std::log10(20.0));
-        int x = marginLeft + static_cast<int>(logPos * graphWidth);
-        
-        // Vertical grid line
-        DrawLine(x, marginTop, x, baseY, gridColor);
-        
-        // Frequency label
-        std::string label = formatFrequency(freqMarkers[i]);
-        int textWidth = MeasureText(label.c_str(), 12);
-        DrawText(label.c_str(), x - textWidth / 2, baseY + 8, 12, config_.theme.textDim);
-    }
-    
-    // Convert magnitudes to dB and build points
-    std::vector<Vector2> points(numBands);
-    std::vector<float> dbValues(numBands);
+    // Build points from the analyzer's dB values
+    float sensitivityDb = 20.0f * std::log10(SAFE_MAX(config_.sensitivity, 1e-6f));
+    linePoints_.resize(numBands);
+    lineDb_.resize(numBands);
+    std::vector<Vector2>& points = linePoints_;
+    std::vector<float>& dbValues = lineDb_;
     
     for (size_t i = 0; i < numBands; ++i) {
         // Calculate x position (logarithmic frequency scale)
         float freqNorm = static_cast<float>(i) / (numBands - 1);
         float x = marginLeft + freqNorm * graphWidth;
         
-        // Convert magnitude to dB
-        float mag = static_cast<float>(spectrum.magnitudes[i]) * config_.sensitivity;
-        float db;
-        if (mag > 0.00001f) {
-            db = 20.0f * std::log10(mag);
-            db = std::clamp(db, dbMin, dbMax);
-        } else {
-            db = dbMin;
-        }
+        // Analyzer dB plus the sensitivity gain
+        float db = std::clamp(spectrum.magnitudesDb[i] + sensitivityDb, dbMin, dbMax);
         dbValues[i] = db;
         
         // Update peak hold
@@ -341,8 +331,8 @@ void SpectrumVisualizer::renderLine(const audio::SpectrumData& spectrum) {
             peakHold_[i] = db;
             peakHoldDecay_[i] = 0.0f;
         } else {
-            peakHoldDecay_[i] += 0.15f;
-            peakHold_[i] -= peakHoldDecay_[i] * 0.1f;
+            peakHoldDecay_[i] += 0.15f * frameStep_;
+            peakHold_[i] -= peakHoldDecay_[i] * 0.1f * frameStep_;
             peakHold_[i] = SAFE_MAX(peakHold_[i], dbMin);
         }
         
@@ -559,39 +549,27 @@ void SpectrumVisualizer::updateParticles(const audio::SpectrumData& spectrum) {
     if (numBands > 0) avgMag /= numBands;
     avgMag *= config_.sensitivity;
     
+    size_t capacity = static_cast<size_t>(SAFE_MAX(config_.maxParticles, 0));
+    if (particles_.capacity() != capacity) {
+        particles_.reset(capacity);
+    }
+    
     // Spawn new particles based on magnitude
-    int particlesToSpawn = static_cast<int>(avgMag * 10);
-    for (int i = 0; i < particlesToSpawn && particles_.size() < 1000; ++i) {
-        Particle p;
-        p.position = {static_cast<float>(GetRandomValue(0, width)), 
-                      static_cast<float>(height + 10)};
-        p.velocity = {static_cast<float>(GetRandomValue(-50, 50)) / 50.0f, 
-                      -avgMag * 8.0f - 2.0f};
-        p.life = 1.0f;
-        p.size = 2.0f + avgMag * 5.0f;
-        
-        float normalizedPos = p.position.x / width;
-        p.color = getBarColor(normalizedPos, avgMag);
-        
-        particles_.push_back(p);
-    }
-    
-    // Update existing particles
-    float dt = GetFrameTime();
-    for (auto& p : particles_) {
-        p.position.x += p.velocity.x * dt * 60.0f;
-        p.position.y += p.velocity.y * dt * 60.0f;
-        p.velocity.y += 0.05f; // Gravity
-        p.life -= dt * 0.5f;
-        p.size *= 0.99f;
-    }
-    
-    // Remove dead particles
-    particles_.erase(
-        std::remove_if(particles_.begin(), particles_.end(),
-                       [](const Particle& p) { return p.life <= 0 || p.size < 0.5f; }),
-        particles_.end()
-    );
+    int particlesToSpawn = static_cast<int>(avgMag * 10 * config_.particleDensity);
+    for (int i = 0; i < particlesToSpawn && !particles_.full(); ++i) {
+        Vector2 position = {static_cast<float>(GetRandomValue(0, width)), 
+                            static_cast<float>(height + 10)};
+        Vector2 velocity = {static_cast<float>(GetRandomValue(-50, 50)) / 50.0f, 
+                            -avgMag * 8.0f - 2.0f};
+        
+        float normalizedPos = position.x / width;
+        particles_.spawn(position, velocity, 1.0f, 2.0f + avgMag * 5.0f,
+                         getBarColor(normalizedPos, avgMag));
+    }
+    
+    // Update existing particles (gravity 0.05 per frame, fade over 2 s,
+    // shrink 1% per frame) and retire dead ones
+    particles_.update(GetFrameTime(), 0.05f, 0.5f, 0.99f, 0.5f);
 }
 
 void SpectrumVisualizer::renderParticles(const audio::SpectrumData& spectrum) {
@@ -615,12 +593,51 @@ void SpectrumVisualizer::renderParticles(const audio::SpectrumData& spectrum) {
         }
     }
     
-    // Render particles
-    for (const auto& p : particles_) {
-        Color color = Fade(p.color, p.life);
-        DrawCircle(static_cast<int>(p.position.x), static_cast<int>(p.position.y), 
-                   p.size, color);
+    // Soft disc, white with an antialiased alpha edge, tinted per particle
+    if (particleTexture_.id == 0) {
+        const int texSize = 64;
+        const float radius = texSize * 0.5f;
+        std::vector<Color> pixels(texSize * texSize);
+        for (int y = 0; y < texSize; ++y) {
+            for (int x = 0; x < texSize; ++x) {
+                float dx = x + 0.5f - radius;
+                float dy = y + 0.5f - radius;
+                float coverage = std::clamp(radius - std::sqrt(dx * dx + dy * dy), 0.0f, 1.0f);
+                pixels[y * texSize + x] = {255, 255, 255, static_cast<unsigned char>(coverage * 255.0f)};
+            }
+        }
+        Image image = {pixels.data(), texSize, texSize, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8};
+        particleTexture_ = LoadTextureFromImage(image);
+        SetTextureFilter(particleTexture_, TEXTURE_FILTER_BILINEAR);
+    }
+    
+    // Render particles: one quad each, all in the rlgl batch (flushed only
+    // when it fills up) instead of a triangle fan per DrawCircle
+    rlSetTexture(particleTexture_.id);
+    rlBegin(RL_QUADS);
+    for (size_t i = 0; i < particles_.extent(); ++i) {
+        if (!particles_.alive(i)) continue;
+        rlCheckRenderBatchLimit(4);
+        
+        // Same placement and fade as DrawCircle(int, int, size, Fade(color, life))
+        float cx = static_cast<float>(static_cast<int>(particles_.x(i)));
+        float cy = static_cast<float>(static_cast<int>(particles_.y(i)));
+        float r = particles_.size(i);
+        Color color = particles_.color(i);
+        color.a = static_cast<unsigned char>(255.0f * std::clamp(particles_.life(i), 0.0f, 1.0f));
+        
+        rlColor4ub(color.r, color.g, color.b, color.a);
+        rlTexCoord2f(0.0f, 0.0f);
+        rlVertex2f(cx - r, cy - r);
+        rlTexCoord2f(0.0f, 1.0f);
+        rlVertex2f(cx - r, cy + r);
+        rlTexCoord2f(1.0f, 1.0f);
+        rlVertex2f(cx + r, cy + r);
+        rlTexCoord2f(1.0f, 0.0f);
+        rlVertex2f(cx + r, cy - r);
     }
+    rlEnd();
+    rlSetTexture(0);
 }
 
 void SpectrumVisualizer::renderMirror(const audio::SpectrumData& spectrum) {
@@ -661,6 +678,214 @@ void SpectrumVisualizer::renderMirror(const audio::SpectrumData& spectrum) {
     }
 }
 
+Color SpectrumVisualizer::spectrogramColor(float db) const {
+    // -90..0 dB through background, low, mid and high bar colors
+    float t = std::clamp((db + 90.0f) / 90.0f, 0.0f, 1.0f);
+    if (t < 0.33f) {
+        return lerpColor(config_.theme.background, config_.theme.barLow, t / 0.33f);
+    } else if (t < 0.66f) {
+        return lerpColor(config_.theme.barLow, config_.theme.barMid, (t - 0.33f) / 0.33f);
+    }
+    return lerpColor(config_.theme.barMid, config_.theme.barHigh, (t - 0.66f) / 0.34f);
+}
+
+void SpectrumVisualizer::updateSpectrogram(const audio::SpectrumData& spectrum) {
+    int numBands = static_cast<int>(spectrum.magnitudesDb.size());
+    if (numBands == 0) return;
+    
+    // (Re)create the ring when the band count changes
+    if (spectrogram_.id == 0 || spectrogram_.width != numBands) {
+        if (spectrogram_.id != 0) {
+            UnloadTexture(spectrogram_);
+        }
+        Image blank = GenImageColor(numBands, kSpectrogramRows, config_.theme.background);
+        spectrogram_ = LoadTextureFromImage(blank);
+        UnloadImage(blank);
+        SetTextureFilter(spectrogram_, TEXTURE_FILTER_POINT);
+        SetTextureWrap(spectrogram_, TEXTURE_WRAP_REPEAT);
+        spectrogramLevels_.assign(static_cast<size_t>(numBands) * kSpectrogramRows, 0);
+        spectrogramPixels_.resize(spectrogramLevels_.size());
+        spectrogramHead_ = 0;
+        spectrogramRecolor_ = true;
+    }
+    
+    if (spectrogramRecolor_) {
+        recolorSpectrogram();
+    }
+    
+    // One row per analysis frame, however often we render
+    if (spectrum.sequence == spectrogramSequence_) return;
+    spectrogramSequence_ = spectrum.sequence;
+    
+    // Levels are stored without sensitivity, which the palette applies
+    uint8_t* levels = spectrogramLevels_.data() + static_cast<size_t>(spectrogramHead_) * numBands;
+    for (int i = 0; i < numBands; ++i) {
+        float code = (spectrum.magnitudesDb[i] - kSpectrogramMinDb) / kSpectrogramDbPerCode;
+        levels[i] = static_cast<uint8_t>(std::clamp(code + 0.5f, 0.0f, 255.0f));
+        spectrogramPixels_[i] = spectrogramPalette_[levels[i]];
+    }
+    
+    Rectangle row = {0.0f, static_cast<float>(spectrogramHead_), static_cast<float>(numBands), 1.0f};
+    UpdateTextureRec(spectrogram_, row, spectrogramPixels_.data());
+    spectrogramHead_ = (spectrogramHead_ + 1) % kSpectrogramRows;
+}
+
+void SpectrumVisualizer::recolorSpectrogram() {
+    float sensitivityDb = 20.0f * std::log10(SAFE_MAX(config_.sensitivity, 1e-6f));
+    for (size_t code = 0; code < spectrogramPalette_.size(); ++code) {
+        float db = kSpectrogramMinDb + static_cast<float>(code) * kSpectrogramDbPerCode;
+        spectrogramPalette_[code] = spectrogramColor(db + sensitivityDb);
+    }
+    spectrogramRecolor_ = false;
+    
+    if (spectrogram_.id == 0) return;
+    for (size_t i = 0; i < spectrogramLevels_.size(); ++i) {
+        spectrogramPixels_[i] = spectrogramPalette_[spectrogramLevels_[i]];
+    }
+    UpdateTexture(spectrogram_, spectrogramPixels_.data());
+}
+
+void SpectrumVisualizer::renderSpectrogram(const audio::SpectrumData& spectrum) {
+    if (spectrogram_.id == 0 || spectrum.magnitudesDb.empty()) return;
+    
+    // A theme change while no frames arrive (paused) still recolors
+    if (spectrogramRecolor_) {
+        recolorSpectrogram();
+    }
+    
+    int width = GetScreenWidth();
+    int height = GetScreenHeight();
+    int controlBarHeight = 70;  // Match control bar and grid labels
+    
+    float top = 80.0f;          // Below the info text
+    float bottom = static_cast<float>(height - controlBarHeight - 22);
+    if (bottom <= top) return;
+    
+    // Newest row at the top, oldest at the bottom. The negative source height
+    // flips the quad; starting at the write row makes the texture coordinates
+    // run past the end of the ring, which the repeat wrap folds back.
+    Rectangle source = {0.0f, static_cast<float>(spectrogramHead_),
+                        static_cast<float>(spectrogram_.width), -static_cast<float>(kSpectrogramRows)};
+    Rectangle dest = {0.0f, top, static_cast<float>(width), bottom - top};
+    DrawTexturePro(spectrogram_, source, dest, {0.0f, 0.0f}, 0.0f, WHITE);
+}
+
+void SpectrumVisualizer::renderLineGrid() {
+    int width = GetScreenWidth();
+    int height = GetScreenHeight();
+    
+    // Same drawing area as renderLine
+    int marginLeft = 55;
+    int marginRight = 15;
+    int marginTop = 50;
+    int marginBottom = 90;
+    
+    int graphWidth = width - marginLeft - marginRight;
+    int graphHeight = height - marginTop - marginBottom;
+    int baseY = height - marginBottom;
+    
+    float dbMin = -60.0f;
+    float dbMax = 0.0f;
+    float dbRange = dbMax - dbMin;
+    
+    // Draw dB scale on left side
+    Color gridColor = Fade(config_.theme.textDim, 0.3f);
+    for (float db = dbMin; db <= dbMax; db += 6.0f) {
+        float yNorm = (db - dbMin) / dbRange;
+        int y = baseY - static_cast<int>(yNorm * graphHeight);
+        
+        // Horizontal grid line
+        DrawLine(marginLeft, y, width - marginRight, y, gridColor);
+        
+        // dB label
+        char label[16];
+        snprintf(label, sizeof(label), "%+.0f", db);
+        DrawText(label, 5, y - 7, 14, config_.theme.textDim);
+    }
+    
+    // Draw frequency scale on bottom
+    const double freqMarkers[] = {20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000};
+    for (int i = 0; i < 10; ++i) {
+        float logPos = (std::log10(freqMarkers[i]) - std::log10(20.0)) / 
+                       (std::log10(20000.0) - std::log10(20.0));
+        int x = marginLeft + static_cast<int>(logPos * graphWidth);
+        
+        // Vertical grid line
+        DrawLine(x, marginTop, x, baseY, gridColor);
+        
+        // Frequency label
+        std::string label = formatFrequency(freqMarkers[i]);
+        int textWidth = MeasureText(label.c_str(), 12);
+        DrawText(label.c_str(), x - textWidth / 2, baseY + 8, 12, config_.theme.textDim);
+    }
+}
+
+SpectrumVisualizer::StaticLayerKey SpectrumVisualizer::currentStaticLayerKey() const {
+    StaticLayerKey key;
+    key.width = GetScreenWidth();
+    key.height = GetScreenHeight();
+    key.lineLayout = config_.style == VisualizerStyle::Line;
+    key.showGrid = config_.showGrid;
+    return key;
+}
+
+void SpectrumVisualizer::drawStaticContent() {
+    // Clear with gradient background
+    ClearBackground(config_.theme.background);
+    
+    // Draw subtle gradient overlay
+    DrawRectangleGradientV(0, 0, GetScreenWidth(), GetScreenHeight(), 
+                           Fade(config_.theme.barMid, 0.05f), 
+                           Fade(config_.theme.background, 0.0f));
+    
+    // Line mode has its own grid built-in
+    if (config_.style == VisualizerStyle::Line) {
+        renderLineGrid();
+    } else if (config_.showGrid) {
+        renderGrid();
+    }
+}
+
+void SpectrumVisualizer::updateStaticLayer() {
+    StaticLayerKey key = currentStaticLayerKey();
+    if (!staticLayerDirty_ && key == staticLayerKey_ && staticLayer_.id != 0) return;
+    
+    if (staticLayer_.id == 0 || key.width != staticLayer_.texture.width ||
+        key.height != staticLayer_.texture.height) {
+        if (staticLayer_.id != 0) {
+            UnloadRenderTexture(staticLayer_);
+        }
+        staticLayer_ = LoadRenderTexture(key.width, key.height);
+    }
+    
+    if (staticLayer_.id != 0) {
+        BeginTextureMode(staticLayer_);
+        drawStaticContent();
+        EndTextureMode();
+    }
+    staticLayerKey_ = key;
+    staticLayerDirty_ = false;
+}
+
+void SpectrumVisualizer::drawStaticLayer() {
+    if (staticLayer_.id == 0) {
+        // No render texture available: draw directly every frame
+        drawStaticContent();
+        return;
+    }
+    
+    // Copy without blending: the layer is the whole background, and its
+    // alpha channel is not meaningful after blended drawing.
+    // Render textures are stored bottom-up, hence the negative height.
+    Rectangle source = {0.0f, 0.0f, static_cast<float>(staticLayer_.texture.width),
+                        -static_cast<float>(staticLayer_.texture.height)};
+    rlDrawRenderBatchActive();
+    rlDisableColorBlend();
+    DrawTextureRec(staticLayer_.texture, source, {0.0f, 0.0f}, WHITE);
+    rlDrawRenderBatchActive();
+    rlEnableColorBlend();
+}
+
 void SpectrumVisualizer::renderGrid() {
     int width = GetScreenWidth();
     int height = GetScreenHeight();
@@ -730,9 +955,40 @@ void SpectrumVisualizer::renderInfo(const audio::AudioAnalyzer& analyzer,
     std::string fpsStr = std::to_string(GetFPS()) + " FPS";
     DrawText(fpsStr.c_str(), GetScreenWidth() - 60, padding, 12, config_.theme.textDim);
     
-    const char* styleNames[] = {"LINE", "BARS", "WAVES", "CIRCLES", "PARTICLES", "MIRROR"};
-    DrawText(styleNames[static_cast<int>(config_.style)], 
-             GetScreenWidth() - 80, padding + 18, 12, config_.theme.accent);
+    const char* styleNames[] = {"LINE", "BARS", "WAVES", "CIRCLES", "PARTICLES", "MIRROR", "SPECTROGRAM"};
+    const char* styleName = styleNames[static_cast<int>(config_.style)];
+    DrawText(styleName, GetScreenWidth() - SAFE_MAX(80, MeasureText(styleName, 12) + padding),
+             padding + 18, 12, config_.theme.accent);
+}
+
+void SpectrumVisualizer::renderPerfOverlay() {
+    // Last second of stage timings, top-right under the FPS counter
+    perf::Snapshot stats = perf::snapshot();
+    
+    int fontSize = 10;
+    int lineHeight = 13;
+    int panelWidth = 330;
+    int x = GetScreenWidth() - panelWidth - 12;
+    int y = 30;
+    
+    int lines = 1;
+    for (size_t i = 0; i < perf::kNumStages; ++i) {
+        if (stats.stages[i].count > 0) ++lines;
+    }
+    DrawRectangleRounded({static_cast<float>(x), static_cast<float>(y),
+                          static_cast<float>(panelWidth), static_cast<float>(lines * lineHeight + 10)},
+                         0.1f, 4, Fade(config_.theme.background, 0.85f));
+    
+    x += 8;
+    y += 5;
+    std::string load = perf::formatLoad(stats, perf::Stage::AudioCallback);
+    DrawText(load.c_str(), x, y, fontSize, config_.theme.accent);
+    for (size_t i = 0; i < perf::kNumStages; ++i) {
+        if (stats.stages[i].count == 0) continue;
+        y += lineHeight;
+        std::string line = perf::formatStage(stats, static_cast<perf::Stage>(i));
+        DrawText(line.c_str(), x, y, fontSize, config_.theme.text);
+    }
 }
 
 void SpectrumVisualizer::renderControls() {
@@ -863,8 +1119,8 @@ void SpectrumVisualizer::updatePeaks(const audio::SpectrumData& spectrum) {
             peaks_[i] = magnitude;
             velocities_[i] = 0.0f;
         } else {
-            velocities_[i] += config_.peakDecay;
-            peaks_[i] -= velocities_[i];
+            velocities_[i] += config_.peakDecay * frameStep_;
+            peaks_[i] -= velocities_[i] * frameStep_;
             peaks_[i] = SAFE_MAX(peaks_[i], 0.0f);
         }
     }
@@ -928,16 +1184,20 @@ void SpectrumVisualizer::setStyle(VisualizerStyle style) {
 
 void SpectrumVisualizer::setTheme(const ColorTheme& theme) {
     config_.theme = theme;
+    staticLayerDirty_ = true;
+    spectrogramRecolor_ = true;
 }
 
 void SpectrumVisualizer::nextTheme() {
     currentTheme_ = (currentTheme_ + 1) % themes_.size();
     config_.theme = themes_[currentTheme_];
+    staticLayerDirty_ = true;
+    spectrogramRecolor_ = true;
 }
 
 void SpectrumVisualizer::nextStyle() {
     int styleInt = static_cast<int>(config_.style);
-    styleInt = (styleInt + 1) % 6;  // Now 6 styles
+    styleInt = (styleInt + 1) % 7;  // Now 7 styles
     config_.style = static_cast<VisualizerStyle>(styleInt);
 }
 
@@ -947,6 +1207,8 @@ const VisualizerConfig& SpectrumVisualizer::getConfig() const {
 
 void SpectrumVisualizer::setConfig(const VisualizerConfig& config) {
     config_ = config;
+    staticLayerDirty_ = true;
+    spectrogramRecolor_ = true;
 }
 
 void SpectrumVisualizer::handleEQInput(audio::AudioAnalyzer& analyzer) {
@@ -1074,51 +1336,22 @@ void SpectrumVisualizer::handleEQInput(audio::AudioAnalyzer& analyzer) {
 
 void SpectrumVisualizer::drawEQSpline(audio::AudioAnalyzer& analyzer, int marginLeft, 
                                       int graphWidth, int marginTop, int graphHeight, int baseY) {
-    const auto& eqConfig = analyzer.getEqualizer();
     int centerY = marginTop + graphHeight / 2;
     
-    // Frequency range (logarithmic)
-    float logFreqMin = std::log10(20.0f);
-    float logFreqMax = std::log10(20000.0f);
-    float logFreqRange = logFreqMax - logFreqMin;
-    
     // dB range
     float dbMin = -12.0f;
     float dbMax = 12.0f;
     float dbRange = dbMax - dbMin;
     
-    // Calculate the combined EQ response at each pixel
-    // This simulates the actual frequency response of cascaded biquad filters
+    // Exact combined response of the cascaded biquads, one point per pixel;
+    // the cache only re-evaluates bands whose parameters changed
+    uint32_t sampleRate = analyzer.getSampleRate();
     int numPoints = graphWidth;
-    std::vector<float> response(numPoints);
-    
-    for (int px = 0; px < numPoints; ++px) {
-        float xNorm = static_cast<float>(px) / (numPoints - 1);
-        float logFreq = logFreqMin + xNorm * logFreqRange;
-        float freq = std::pow(10.0f, logFreq);
-        
-        // Sum contributions from all EQ bands
-        float totalGainDb = 0.0f;
-        
-        for (int band = 0; band < 5; ++band) {
-            float bandFreq = eqControls_[band].frequency;
-            float bandGain = eqControls_[band].gain;
-            float bandQ = eqControls_[band].q;
-            
-            if (std::abs(bandGain) < 0.01f) continue;
-            
-            // Calculate the response of a peaking filter at this frequency
-            // Using simplified magnitude response formula for peaking EQ
-            float logDist = std::log10(freq) - std::log10(bandFreq);
-            float bandwidth = 1.0f / bandQ;  // Wider Q = narrower bandwidth
-            
-            // Bell curve in log-frequency domain
-            float bellShape = std::exp(-(logDist * logDist) / (2.0f * bandwidth * bandwidth * 0.1f));
-            totalGainDb += bandGain * bellShape;
-        }
-        
-        response[px] = totalGainDb;
+    eqResponse_.setLayout(numPoints, eq::MIN_FREQ, eq::MAX_FREQ, sampleRate > 0 ? sampleRate : 44100.0);
+    for (int band = 0; band < eq::NUM_BANDS; ++band) {
+        eqResponse_.setBand(band, eqControls_[band].frequency, eqControls_[band].gain, eqControls_[band].q);
     }
+    const std::vector<float>& response = eqResponse_.response();
     
     // Draw filled area under the curve
     for (int px = 0; px < numPoints - 1; ++px) {
@@ -1,7 +1,11 @@
 #pragma once
 
 #include "audio_analyzer.hpp"
+#include "eq_response.hpp"
+#include "particle_pool.hpp"
 #include <raylib.h>
+#include <array>
+#include <cstdint>
 #include <vector>
 #include <string>
 
@@ -16,7 +20,8 @@ enum class VisualizerStyle {
     Waves,          // Smooth wave visualization
     Circles,        // Circular spectrum
     Particles,      // Particle-based visualization
-    Mirror          // Mirrored bars
+    Mirror,         // Mirrored bars
+    Spectrogram     // Scrolling time-frequency history (waterfall)
 };
 
 /**
@@ -53,13 +58,17 @@ struct VisualizerConfig {
     float barMinHeight = 4.0f;     // Minimum bar height
     float barRounding = 2.0f;      // Corner rounding for bars
     float sensitivity = 1.5f;       // Visual sensitivity multiplier
-    float peakDecay = 0.02f;       // Peak indicator decay rate
+    float peakDecay = 0.02f;       // Peak indicator decay rate (per 60 Hz frame)
     
     bool showPeaks = true;          // Show peak indicators
     bool showGrid = true;           // Show frequency grid
     bool showInfo = true;           // Show audio info
+    bool showPerf = false;          // Show the performance overlay (F3)
     bool showWaveform = false;      // Show waveform overlay
     bool mirrorVertical = false;    // Mirror visualization vertically
+    
+    int maxParticles = 1000;        // Particle pool capacity (Particles style)
+    float particleDensity = 1.0f;   // Particle spawn rate multiplier
 };
 
 /**
@@ -135,21 +144,20 @@ private:
     VisualizerConfig config_;
     std::vector<float> peaks_;
     std::vector<float> velocities_;
+    
+    // Length of this frame in 60 Hz frames; the per-frame decays (peaks,
+    // peak hold) scale by it so they run at the same speed at any frame rate
+    float frameStep_ = 1.0f;
     std::vector<ColorTheme> themes_;
     size_t currentTheme_ = 0;
     
     Font font_;
     bool fontLoaded_ = false;
     
-    // Particle system for particle visualization
-    struct Particle {
-        Vector2 position;
-        Vector2 velocity;
-        float life;
-        float size;
-        Color color;
-    };
-    std::vector<Particle> particles_;
+    // Particle system for particle visualization, drawn as textured quads
+    // in one rlgl batch (soft disc texture, built on first use)
+    ParticlePool particles_;
+    Texture2D particleTexture_{};
     
     // Rendering methods
     void renderLine(const audio::SpectrumData& spectrum);
@@ -158,11 +166,36 @@ private:
     void renderCircles(const audio::SpectrumData& spectrum);
     void renderParticles(const audio::SpectrumData& spectrum);
     void renderMirror(const audio::SpectrumData& spectrum);
+    void renderSpectrogram(const audio::SpectrumData& spectrum);
+    
+    // Spectrogram history: a ring texture with one row per analysis frame
+    // (numBands wide). Each new frame uploads a single row; drawing wraps
+    // the texture coordinates past the write row, so scrolling is free.
+    // The ring's levels are kept as well, so a theme or sensitivity change
+    // recolors the whole history with one upload.
+    static constexpr int kSpectrogramRows = 512;
+    static constexpr float kSpectrogramMinDb = -120.0f;    // Level code 0
+    static constexpr float kSpectrogramDbPerCode = 0.5f;
+    Texture2D spectrogram_{};
+    std::vector<uint8_t> spectrogramLevels_;        // kSpectrogramRows x numBands level codes
+    std::vector<Color> spectrogramPixels_;          // Upload staging (a row or the whole ring)
+    std::array<Color, 256> spectrogramPalette_{};   // Level code -> color
+    int spectrogramHead_ = 0;               // Next row to write
+    uint64_t spectrogramSequence_ = 0;      // Last uploaded SpectrumData::sequence
+    bool spectrogramRecolor_ = true;        // Palette is stale (theme or sensitivity changed)
+    
+    void updateSpectrogram(const audio::SpectrumData& spectrum);
+    void recolorSpectrogram();
+    Color spectrogramColor(float db) const;
     
     // Peak hold for line visualization
     std::vector<float> peakHold_;
     std::vector<float> peakHoldDecay_;
     
+    // Line scratch, reused every frame
+    std::vector<Vector2> linePoints_;
+    std::vector<float> lineDb_;
+    
     // EQ control state
     struct EQControl {
         float x, y;           // Screen position
@@ -178,6 +211,7 @@ private:
     float dragStartY_ = 0;
     float dragStartFreq_ = 0;
     float dragStartGain_ = 0;
+    eq::ResponseCache eqResponse_;
     
     // EQ control rendering
     void renderEQControls(audio::AudioAnalyzer& analyzer);
@@ -186,8 +220,33 @@ private:
                       int marginTop, int graphHeight, int baseY);
     
     void renderGrid();
+    void renderLineGrid();
+    
+    // Retained background: clear, gradient, grid and axis labels, drawn into
+    // a render texture and redrawn only when its key changes or a theme is set
+    struct StaticLayerKey {
+        int width = 0;
+        int height = 0;
+        bool lineLayout = false;    // Line style draws its own dB/frequency grid
+        bool showGrid = false;
+        
+        bool operator==(const StaticLayerKey& other) const {
+            return width == other.width && height == other.height &&
+                   lineLayout == other.lineLayout && showGrid == other.showGrid;
+        }
+    };
+    RenderTexture2D staticLayer_{};
+    StaticLayerKey staticLayerKey_;
+    bool staticLayerDirty_ = true;
+    
+    StaticLayerKey currentStaticLayerKey() const;
+    void drawStaticContent();
+    void updateStaticLayer();
+    void drawStaticLayer();
+    
     void renderInfo(const audio::AudioAnalyzer& analyzer, const audio::SpectrumData& spectrum);
     void renderControls();
+    void renderPerfOverlay();
     void renderProgressBar(const audio::AudioAnalyzer& analyzer);
     
     void updatePeaks(const audio::SpectrumData& spectrum);
@@ -0,0 +1,123 @@
+#pragma once
+
+/**
+ * Lock-free single-producer / single-consumer ring buffer
+ *
+ * One thread writes (typically the audio callback), one thread reads (the
+ * analysis worker). Neither side ever blocks or allocates; when the ring is
+ * full the producer simply writes fewer elements than requested.
+ */
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+namespace rt {
+
+template <typename T>
+class SpscRing {
+public:
+    SpscRing() = default;
+
+    explicit SpscRing(size_t minCapacity) { reset(minCapacity); }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /**
+     * Resize and clear the ring. Not thread-safe: call only while neither
+     * producer nor consumer is running.
+     * @param minCapacity Requested capacity (rounded up to a power of 2)
+     */
+    void reset(size_t minCapacity) {
+        size_t capacity = 1;
+        while (capacity < minCapacity) capacity <<= 1;
+
+        buffer_.assign(capacity, T{});
+        mask_ = capacity - 1;
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+    }
+
+    size_t capacity() const { return buffer_.size(); }
+
+    /**
+     * Number of elements ready to read (consumer side)
+     */
+    size_t readAvailable() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Number of free slots (producer side)
+     */
+    size_t writeAvailable() const {
+        return buffer_.size() - (head_.load(std::memory_order_relaxed) -
+                                 tail_.load(std::memory_order_acquire));
+    }
+
+    /**
+     * Append elements (producer thread only)
+     * @param data Source elements
+     * @param count Number of elements to write
+     * @return Number actually written (less than count when full)
+     */
+    size_t write(const T* data, size_t count) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        count = (std::min)(count, buffer_.size() - (head - tail));
+        if (count == 0) return 0;
+
+        // At most two contiguous runs: up to the end, then from the start
+        size_t start = head & mask_;
+        size_t first = (std::min)(count, buffer_.size() - start);
+        std::copy(data, data + first, buffer_.data() + start);
+        std::copy(data + first, data + count, buffer_.data());
+
+        head_.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * Remove elements (consumer thread only)
+     * @param dest Destination for up to count elements
+     * @param count Maximum number of elements to read
+     * @return Number actually read
+     */
+    size_t read(T* dest, size_t count) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t head = head_.load(std::memory_order_acquire);
+        count = (std::min)(count, head - tail);
+        if (count == 0) return 0;
+
+        size_t start = tail & mask_;
+        size_t first = (std::min)(count, buffer_.size() - start);
+        std::copy(buffer_.data() + start, buffer_.data() + start + first, dest);
+        std::copy(buffer_.data(), buffer_.data() + (count - first), dest + first);
+
+        tail_.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * Drop everything currently readable (consumer thread only)
+     * @return Number of elements dropped
+     */
+    size_t discard() {
+        size_t head = head_.load(std::memory_order_acquire);
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        tail_.store(head, std::memory_order_release);
+        return head - tail;
+    }
+
+private:
+    std::vector<T> buffer_;
+    size_t mask_ = 0;
+
+    // Producer and consumer indices on separate cache lines
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+};
+
+} // namespace rt
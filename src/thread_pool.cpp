@@ -0,0 +1,176 @@
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <exception>
+
+namespace util {
+
+namespace {
+
+// Pool and index of the worker running on this thread
+thread_local const ThreadPool* tlsPool = nullptr;
+thread_local size_t tlsIndex = 0;
+
+} // namespace
+
+ThreadPool::ThreadPool(size_t numThreads) {
+    if (numThreads == 0) {
+        numThreads = (std::max)(std::thread::hardware_concurrency(), 1u);
+    }
+
+    queues_.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; ++i) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+
+    threads_.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; ++i) {
+        threads_.emplace_back(&ThreadPool::run, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stopping_ = true;
+    }
+    sleepCv_.notify_all();
+
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+size_t ThreadPool::workerIndex() const {
+    return tlsPool == this ? tlsIndex : threads_.size();
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    // Workers push to their own deque; other threads spread round-robin
+    size_t index = workerIndex();
+    if (index >= queues_.size()) {
+        index = nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    }
+
+    // Count first so queued_ never underflows when a thief is quick
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        queued_.fetch_add(1);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    sleepCv_.notify_one();
+}
+
+bool ThreadPool::tryRunOne(size_t preferred) {
+    std::function<void()> task;
+    size_t count = queues_.size();
+
+    // Own deque from the back (newest, still cache-warm), others from the front
+    for (size_t i = 0; i < count && !task; ++i) {
+        size_t index = (preferred + i) % count;
+        Queue& queue = *queues_[index];
+
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) continue;
+
+        if (i == 0 && preferred == workerIndex()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+    }
+
+    if (!task) return false;
+
+    queued_.fetch_sub(1);
+    task();
+    return true;
+}
+
+void ThreadPool::run(size_t index) {
+    tlsPool = this;
+    tlsIndex = index;
+
+    for (;;) {
+        if (tryRunOne(index)) continue;
+
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        sleepCv_.wait(lock, [this] { return stopping_ || queued_.load() > 0; });
+        if (stopping_) return;
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body) {
+    if (count == 0) return;
+    grain = (std::max<size_t>)(grain, 1);
+
+    size_t numTasks = (count + grain - 1) / grain;
+    if (numTasks == 1) {
+        body(0, count);
+        return;
+    }
+
+    // Shared by this call's ranges; lives until the last one has counted down
+    struct Loop {
+        std::atomic<size_t> remaining{0};
+        std::atomic<bool> failed{false};
+        std::mutex errorMutex;
+        std::exception_ptr error;
+    } loop;
+    loop.remaining.store(numTasks);
+
+    for (size_t task = 0; task < numTasks; ++task) {
+        size_t begin = task * grain;
+        size_t end = (std::min)(begin + grain, count);
+        submit([this, &body, &loop, begin, end] {
+            // Counts down however the body exits. The last range wakes the
+            // caller; after the decrement loop may already be gone.
+            struct Done {
+                ThreadPool* pool;
+                Loop& loop;
+                ~Done() {
+                    if (loop.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        { std::lock_guard<std::mutex> lock(pool->sleepMutex_); }
+                        pool->sleepCv_.notify_all();
+                    }
+                }
+            } done{this, loop};
+
+            // After a failure the remaining ranges are skipped
+            if (loop.failed.load(std::memory_order_relaxed)) return;
+            try {
+                body(begin, end);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(loop.errorMutex);
+                if (!loop.error) {
+                    loop.error = std::current_exception();
+                }
+                loop.failed.store(true, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    // Help until every range is done. Ranges of this loop may be running
+    // elsewhere; sleep until the last one finishes or more work is queued
+    // (nested loops of those ranges), which this thread can then help with.
+    size_t preferred = (std::min)(workerIndex(), queues_.size() - 1);
+    while (loop.remaining.load(std::memory_order_acquire) > 0) {
+        if (tryRunOne(preferred)) continue;
+
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        sleepCv_.wait(lock, [this, &loop] {
+            return loop.remaining.load(std::memory_order_acquire) == 0 || queued_.load() > 0;
+        });
+    }
+
+    if (loop.error) {
+        std::rethrow_exception(loop.error);
+    }
+}
+
+} // namespace util
@@ -0,0 +1,84 @@
+#pragma once
+
+/**
+ * Work-stealing thread pool for batch (non-realtime) work
+ *
+ * Every worker owns a task deque. Workers run their own tasks newest first
+ * and steal the oldest tasks of other workers when they run dry. Threads
+ * waiting in parallelFor() execute queued tasks and only sleep while none
+ * are queued, so parallel loops may be nested (e.g. files across workers,
+ * frames within a file) without deadlocking. Never use from the audio thread.
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace util {
+
+class ThreadPool {
+public:
+    /**
+     * @param numThreads Worker count (0 = one per hardware thread)
+     */
+    explicit ThreadPool(size_t numThreads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Number of worker threads
+     */
+    size_t size() const { return threads_.size(); }
+
+    /**
+     * Queue a task (runs on any worker)
+     * @param task Work to run
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * Run body over [0, count) split into ranges of about grain items and
+     * return when all ranges are done. The calling thread helps.
+     * If a range throws, ranges not yet started are skipped and the first
+     * exception is rethrown here once every range has finished.
+     * @param count Number of items
+     * @param grain Items per task (at least 1)
+     * @param body Called as body(begin, end) for each range
+     */
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body);
+
+    /**
+     * Index of the calling thread for per-thread workspaces
+     * @return 0..size()-1 on a worker of this pool, size() on any other thread
+     */
+    size_t workerIndex() const;
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void run(size_t index);
+    bool tryRunOne(size_t preferred);
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+    std::atomic<size_t> nextQueue_{0};
+
+    // Idle workers sleep until something is queued
+    std::mutex sleepMutex_;
+    std::condition_variable sleepCv_;
+    std::atomic<size_t> queued_{0};
+    bool stopping_ = false;
+};
+
+} // namespace util
@@ -0,0 +1,76 @@
+#pragma once
+
+/**
+ * Wait-free triple buffer for handing the latest value from one producer
+ * thread to one consumer thread.
+ *
+ * The producer fills writeBuffer() and calls publish(); the consumer calls
+ * update() and reads readBuffer(). Neither side locks, blocks or allocates,
+ * and each always owns one of the three slots exclusively. Intermediate
+ * values are dropped if the producer outpaces the consumer.
+ */
+
+#include <atomic>
+#include <cstdint>
+
+namespace rt {
+
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    /**
+     * Slot the producer may write (producer thread only)
+     */
+    T& writeBuffer() { return buffers_[writeIndex_]; }
+
+    /**
+     * Make the write slot visible to the consumer (producer thread only)
+     */
+    void publish() {
+        uint8_t previous = middle_.exchange(static_cast<uint8_t>(writeIndex_ | kDirty),
+                                            std::memory_order_acq_rel);
+        writeIndex_ = previous & kIndexMask;
+    }
+
+    /**
+     * Take the most recently published slot, if any (consumer thread only)
+     * @return True if readBuffer() now holds a newer value
+     */
+    bool update() {
+        if ((middle_.load(std::memory_order_relaxed) & kDirty) == 0) return false;
+
+        uint8_t previous = middle_.exchange(readIndex_, std::memory_order_acq_rel);
+        readIndex_ = previous & kIndexMask;
+        return true;
+    }
+
+    /**
+     * Slot the consumer currently owns (consumer thread only)
+     */
+    const T& readBuffer() const { return buffers_[readIndex_]; }
+
+    /**
+     * Check for unread data without taking it
+     */
+    bool hasNewData() const {
+        return (middle_.load(std::memory_order_relaxed) & kDirty) != 0;
+    }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kDirty = 0x4;
+
+    T buffers_[3];
+
+    // Producer-owned, shared and consumer-owned slot indices
+    uint8_t writeIndex_ = 0;
+    alignas(64) std::atomic<uint8_t> middle_{1};
+    alignas(64) uint8_t readIndex_ = 2;
+};
+
+} // namespace rt
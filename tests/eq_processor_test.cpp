@@ -0,0 +1,263 @@
+/**
+ * EQProcessor block cascade against per-sample scalar filters
+ *
+ * The cascade runs the bands in transposed direct form II on a SIMD lane
+ * pair (or the scalar fallback), gathered per block and converted in
+ * chunks. With fixed coefficients its float output must match the direct
+ * form I biquad it replaced to within one float ulp at full scale; across a
+ * coefficient change it must follow a per-sample ramp from the old to the
+ * new coefficients over kRampFrames, however the blocks are split.
+ */
+
+#include "eq_processor.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+void expect(bool condition, const char* what) {
+    if (!condition) {
+        std::printf("FAILED %s\n", what);
+        ++failures;
+    }
+}
+
+constexpr double kSampleRate = 48000.0;
+
+// One float ulp at full scale (2^-22): rounding differs between filter forms
+constexpr double kFloatTolerance = 2.4e-7;
+
+// Same arithmetic, different evaluation order (lanes, chunking, FMA)
+constexpr double kDoubleTolerance = 1e-12;
+
+struct BandSettings {
+    double gains[eq::NUM_BANDS];
+    double qs[eq::NUM_BANDS];
+};
+
+constexpr BandSettings kBoosts = {{6.0, -4.5, 3.0, -9.0, 12.0}, {0.7, 1.4, 2.0, 4.0, 0.5}};
+
+// Band 0 fades out, band 2 changes, band 3 fades in, band 4 moves
+constexpr BandSettings kChanged = {{0.0, -4.5, -6.0, -9.0, 3.0}, {0.7, 1.4, 1.0, 4.0, 2.0}};
+constexpr BandSettings kChangedFrom = {{6.0, -4.5, 3.0, 0.0, 12.0}, {0.7, 1.4, 2.0, 4.0, 0.5}};
+
+void applySettings(eq::EQProcessor& processor, const BandSettings& settings) {
+    for (int band = 0; band < eq::NUM_BANDS; ++band) {
+        processor.setBand(band, settings.gains[band], eq::DEFAULT_FREQUENCIES[band], settings.qs[band]);
+    }
+}
+
+// Coefficients of every band, identity where the band is off (as the EQ does)
+std::vector<eq::BiquadCoefficients> design(const BandSettings& settings) {
+    std::vector<eq::BiquadCoefficients> coeffs(eq::NUM_BANDS);
+    for (int band = 0; band < eq::NUM_BANDS; ++band) {
+        if (std::abs(settings.gains[band]) > 0.01) {
+            eq::BiquadFilter filter;
+            filter.setPeakingEQ(kSampleRate, eq::DEFAULT_FREQUENCIES[band], settings.gains[band],
+                                settings.qs[band]);
+            coeffs[band] = filter.getCoefficients();
+        }
+    }
+    return coeffs;
+}
+
+// Per-sample direct form I cascade (the pre-vectorization filter)
+std::vector<double> referenceDF1(const std::vector<eq::BiquadCoefficients>& coeffs,
+                                 const std::vector<float>& input) {
+    std::vector<double> output(input.begin(), input.end());
+    for (const eq::BiquadCoefficients& c : coeffs) {
+        double x1 = 0.0, x2 = 0.0, y1 = 0.0, y2 = 0.0;
+        for (double& sample : output) {
+            double x0 = sample;
+            double y0 = c.b0 * x0 + c.b1 * x1 + c.b2 * x2 - c.a1 * y1 - c.a2 * y2;
+            x2 = x1;
+            x1 = x0;
+            y2 = y1;
+            y1 = y0;
+            sample = y0;
+        }
+    }
+    return output;
+}
+
+bool isIdentity(const eq::BiquadCoefficients& c) {
+    return c.b0 == 1.0 && c.b1 == 0.0 && c.b2 == 0.0 && c.a1 == 0.0 && c.a2 == 0.0;
+}
+
+/**
+ * Per-sample transposed direct form II cascade whose coefficients move
+ * linearly from `from` to `to` over kRampFrames, starting at frame `offset`.
+ * Bands that fade out to identity drop their state when the ramp ends.
+ */
+std::vector<double> referenceRamp(const std::vector<eq::BiquadCoefficients>& from,
+                                  const std::vector<eq::BiquadCoefficients>& to,
+                                  const std::vector<double>& input, size_t offset) {
+    std::vector<double> output(input.size());
+    double s1[eq::NUM_BANDS] = {};
+    double s2[eq::NUM_BANDS] = {};
+    for (size_t i = 0; i < input.size(); ++i) {
+        double t = i < offset ? 0.0
+                              : (std::min)(1.0, static_cast<double>(i - offset + 1) / eq::EQProcessor::kRampFrames);
+        double x = input[i];
+        for (int band = 0; band < eq::NUM_BANDS; ++band) {
+            const eq::BiquadCoefficients& a = from[band];
+            const eq::BiquadCoefficients& b = to[band];
+            double b0 = a.b0 + t * (b.b0 - a.b0);
+            double b1 = a.b1 + t * (b.b1 - a.b1);
+            double b2 = a.b2 + t * (b.b2 - a.b2);
+            double a1 = a.a1 + t * (b.a1 - a.a1);
+            double a2 = a.a2 + t * (b.a2 - a.a2);
+
+            double y = b0 * x + s1[band];
+            s1[band] = b1 * x - a1 * y + s2[band];
+            s2[band] = b2 * x - a2 * y;
+            x = y;
+
+            if (i + 1 == offset + eq::EQProcessor::kRampFrames && isIdentity(b) && !isIdentity(a)) {
+                s1[band] = s2[band] = 0.0;
+            }
+        }
+        output[i] = x;
+    }
+    return output;
+}
+
+// Deterministic signal below -6 dBFS, so boosted output stays under full scale
+std::vector<float> testSignal(size_t count, double frequency) {
+    std::vector<float> samples(count);
+    uint32_t noise = 12345;
+    for (size_t i = 0; i < count; ++i) {
+        noise = noise * 1664525u + 1013904223u;
+        double white = static_cast<double>(noise >> 8) / (1u << 24) - 0.5;
+        samples[i] = static_cast<float>(0.15 * std::sin(frequency * static_cast<double>(i)) + 0.2 * white);
+    }
+    return samples;
+}
+
+// Odd block sizes cross the internal chunk and ramp boundaries
+template <typename Sample>
+void processInBlocks(eq::EQProcessor& processor, std::vector<Sample>& left, std::vector<Sample>& right) {
+    size_t done = 0;
+    for (size_t block = 1; done < left.size(); block = block * 3 + 1) {
+        int count = static_cast<int>((std::min)(block, left.size() - done));
+        processor.processStereo(left.data() + done, right.data() + done, left.data() + done,
+                                right.data() + done, count);
+        done += count;
+    }
+}
+
+template <typename Sample>
+double worstError(const std::vector<Sample>& output, const std::vector<double>& reference) {
+    double worst = 0.0;
+    for (size_t i = 0; i < output.size(); ++i) {
+        worst = (std::max)(worst, std::abs(static_cast<double>(output[i]) - reference[i]));
+    }
+    return worst;
+}
+
+// Fixed coefficients: float output within one ulp of the direct form I filter
+void testStaticMatchesDirectForm() {
+    for (int activeBands = 1; activeBands <= eq::NUM_BANDS; ++activeBands) {
+        BandSettings settings = kBoosts;
+        for (int band = activeBands; band < eq::NUM_BANDS; ++band) {
+            settings.gains[band] = 0.0;
+        }
+
+        eq::EQProcessor processor;
+        applySettings(processor, settings);
+        processor.setSampleRate(kSampleRate);
+        processor.reset();
+
+        std::vector<float> left = testSignal(4096, 0.05);
+        std::vector<float> right = testSignal(4096, 0.31);
+        std::vector<double> refLeft = referenceDF1(design(settings), left);
+        std::vector<double> refRight = referenceDF1(design(settings), right);
+
+        processInBlocks(processor, left, right);
+
+        double worst = (std::max)(worstError(left, refLeft), worstError(right, refRight));
+        if (worst > kFloatTolerance) {
+            std::printf("  %d bands: worst error %.3g\n", activeBands, worst);
+        }
+        expect(worst <= kFloatTolerance, "fixed cascade matches direct form I within one float ulp");
+    }
+}
+
+// A change mid-stream ramps per sample from the old to the new coefficients
+void testRampMatchesPerSampleReference() {
+    const size_t frames = 2048;
+    const size_t changeAt = 333;
+
+    eq::EQProcessor processor;
+    applySettings(processor, kChangedFrom);
+    processor.setSampleRate(kSampleRate);
+    processor.reset();
+
+    std::vector<float> inputL = testSignal(frames, 0.05);
+    std::vector<float> inputR = testSignal(frames, 0.31);
+    std::vector<double> left(inputL.begin(), inputL.end());
+    std::vector<double> right(inputR.begin(), inputR.end());
+    std::vector<double> refLeft = referenceRamp(design(kChangedFrom), design(kChanged), left, changeAt);
+    std::vector<double> refRight = referenceRamp(design(kChangedFrom), design(kChanged), right, changeAt);
+
+    // Double path: before the change, then the rest in odd blocks
+    processor.processStereo(left.data(), right.data(), left.data(), right.data(), static_cast<int>(changeAt));
+    applySettings(processor, kChanged);
+    std::vector<double> restL(left.begin() + changeAt, left.end());
+    std::vector<double> restR(right.begin() + changeAt, right.end());
+    processInBlocks(processor, restL, restR);
+    std::copy(restL.begin(), restL.end(), left.begin() + changeAt);
+    std::copy(restR.begin(), restR.end(), right.begin() + changeAt);
+
+    double worst = (std::max)(worstError(left, refLeft), worstError(right, refRight));
+    if (worst > kDoubleTolerance) {
+        std::printf("  ramp: worst error %.3g\n", worst);
+    }
+    expect(worst <= kDoubleTolerance, "ramped cascade matches the per-sample ramp");
+}
+
+// The float path through the same ramp, within one ulp
+void testFloatRampMatchesPerSampleReference() {
+    const size_t frames = 2048;
+    const size_t changeAt = 100;
+
+    eq::EQProcessor processor;
+    applySettings(processor, kChangedFrom);
+    processor.setSampleRate(kSampleRate);
+    processor.reset();
+
+    std::vector<float> left = testSignal(frames, 0.05);
+    std::vector<float> right = testSignal(frames, 0.31);
+    std::vector<double> refLeft = referenceRamp(design(kChangedFrom), design(kChanged),
+                                                std::vector<double>(left.begin(), left.end()), changeAt);
+    std::vector<double> refRight = referenceRamp(design(kChangedFrom), design(kChanged),
+                                                 std::vector<double>(right.begin(), right.end()), changeAt);
+
+    processor.processStereo(left.data(), right.data(), left.data(), right.data(), static_cast<int>(changeAt));
+    applySettings(processor, kChanged);
+    processor.processStereo(left.data() + changeAt, right.data() + changeAt, left.data() + changeAt,
+                            right.data() + changeAt, static_cast<int>(frames - changeAt));
+
+    double worst = (std::max)(worstError(left, refLeft), worstError(right, refRight));
+    if (worst > kFloatTolerance) {
+        std::printf("  float ramp: worst error %.3g\n", worst);
+    }
+    expect(worst <= kFloatTolerance, "float ramp matches the per-sample ramp within one float ulp");
+}
+
+} // namespace
+
+int main() {
+    testStaticMatchesDirectForm();
+    testRampMatchesPerSampleReference();
+    testFloatRampMatchesPerSampleReference();
+
+    if (failures == 0) {
+        std::printf("All EQ tests passed\n");
+    }
+    return failures == 0 ? 0 : 1;
+}
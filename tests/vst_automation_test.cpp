@@ -0,0 +1,208 @@
+/**
+ * Sample-accurate automation in PluginProcessor
+ *
+ * Hosts may send more automation points in one block than the processor's
+ * fixed event queue holds. Points that no longer fit are applied at block
+ * start; this checks that they are committed to the EQ before the first
+ * sub-block runs, and that an oversized single queue keeps its final value.
+ * A point inside a block must take effect at its own sample offset, exactly
+ * as if the block had been processed in two parts.
+ */
+
+#include "plugin_processor.hpp"
+#include "plugin_ids.hpp"
+#include "public.sdk/source/vst/hosting/parameterchanges.h"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+// Exposes the protected automation path
+class AutomationProbe : public SpectrumEQ::PluginProcessor {
+public:
+    using PluginProcessor::collectParameterChanges;
+    using PluginProcessor::kMaxParamEvents;
+
+    int queuedEvents() const { return numParamEvents_; }
+};
+
+int failures = 0;
+
+void expect(bool condition, const char* what) {
+    if (!condition) {
+        std::printf("FAILED %s\n", what);
+        ++failures;
+    }
+}
+
+// Normalized gain for a dB value (inverse of applyParameterEvent's mapping)
+double normalizedGain(double gainDb) {
+    return (gainDb - eq::MIN_GAIN) / (eq::MAX_GAIN - eq::MIN_GAIN);
+}
+
+void addRamp(Steinberg::Vst::ParameterChanges& changes, Steinberg::Vst::ParamID id,
+             int points, double from, double to) {
+    Steinberg::int32 queueIndex = 0;
+    auto* queue = static_cast<Steinberg::Vst::ParamValueQueue*>(changes.addParameterData(id, queueIndex));
+    for (int p = 0; p < points; ++p) {
+        Steinberg::int32 pointIndex = 0;
+        double t = points > 1 ? static_cast<double>(p) / (points - 1) : 1.0;
+        queue->addPoint(p, from + t * (to - from), pointIndex);
+    }
+}
+
+void addPoint(Steinberg::Vst::ParameterChanges& changes, Steinberg::Vst::ParamID id,
+              Steinberg::int32 offset, double value) {
+    Steinberg::int32 queueIndex = 0;
+    auto* queue = static_cast<Steinberg::Vst::ParamValueQueue*>(changes.addParameterData(id, queueIndex));
+    Steinberg::int32 pointIndex = 0;
+    queue->addPoint(offset, value, pointIndex);
+}
+
+// One in-place stereo block through PluginProcessor::process
+void processBlock(SpectrumEQ::PluginProcessor& processor, Steinberg::Vst::ParameterChanges* changes,
+                  std::vector<float>& left, std::vector<float>& right) {
+    float* channels[2] = {left.data(), right.data()};
+    Steinberg::Vst::AudioBusBuffers input{};
+    input.numChannels = 2;
+    input.silenceFlags = 0;
+    input.channelBuffers32 = channels;
+    Steinberg::Vst::AudioBusBuffers output = input;
+
+    Steinberg::Vst::ProcessData data{};
+    data.symbolicSampleSize = Steinberg::Vst::kSample32;
+    data.numSamples = static_cast<Steinberg::int32>(left.size());
+    data.numInputs = 1;
+    data.numOutputs = 1;
+    data.inputs = &input;
+    data.outputs = &output;
+    data.inputParameterChanges = changes;
+    processor.process(data);
+}
+
+/**
+ * Unsplit per-sample reference: one biquad (TDF-II) whose coefficients sit
+ * at identity before offset, then move linearly to target over rampFrames
+ */
+std::vector<float> referenceFilter(const std::vector<float>& input, size_t offset, int rampFrames,
+                                   const eq::BiquadCoefficients& target) {
+    std::vector<float> output(input.size());
+    eq::BiquadCoefficients from;
+    double s1 = 0.0;
+    double s2 = 0.0;
+    for (size_t i = 0; i < input.size(); ++i) {
+        double t = i < offset ? 0.0 : (std::min)(1.0, static_cast<double>(i - offset + 1) / rampFrames);
+        double b0 = from.b0 + t * (target.b0 - from.b0);
+        double b1 = from.b1 + t * (target.b1 - from.b1);
+        double b2 = from.b2 + t * (target.b2 - from.b2);
+        double a1 = from.a1 + t * (target.a1 - from.a1);
+        double a2 = from.a2 + t * (target.a2 - from.a2);
+
+        double x = input[i];
+        double y = b0 * x + s1;
+        s1 = b1 * x - a1 * y + s2;
+        s2 = b2 * x - a2 * y;
+        output[i] = static_cast<float>(y);
+    }
+    return output;
+}
+
+// Deterministic test signal
+std::vector<float> testSignal(size_t count, double frequency) {
+    std::vector<float> samples(count);
+    for (size_t i = 0; i < count; ++i) {
+        samples[i] = static_cast<float>(0.5 * std::sin(0.0625 * frequency * static_cast<double>(i)) +
+                                        0.25 * std::sin(0.37 * static_cast<double>(i)));
+    }
+    return samples;
+}
+
+// A first queue fills the event queue exactly; the second one overflows
+void testOverflowCommitsBeforeFirstSubBlock() {
+    AutomationProbe processor;
+    Steinberg::Vst::ParameterChanges changes;
+    addRamp(changes, SpectrumEQ::kBand1Freq, AutomationProbe::kMaxParamEvents, 0.2, 0.8);
+    addRamp(changes, SpectrumEQ::kBand2Gain, 8, normalizedGain(0.0), normalizedGain(6.0));
+
+    processor.collectParameterChanges(&changes);
+
+    expect(processor.queuedEvents() == AutomationProbe::kMaxParamEvents, "first queue fills the event queue");
+    expect(std::abs(processor.getEQ().getBandGain(1) - 6.0) < 1e-9,
+           "overflowed band 2 gain is committed before processing");
+    expect(std::abs(processor.getEQ().getBandGain(0)) < 1e-9,
+           "queued band 1 changes wait for their offsets");
+}
+
+// More points in one queue than the event queue holds: only the last is kept
+void testOversizedQueueKeepsFinalValue() {
+    AutomationProbe processor;
+    Steinberg::Vst::ParameterChanges changes;
+    addRamp(changes, SpectrumEQ::kBand3Gain, AutomationProbe::kMaxParamEvents * 2,
+            normalizedGain(-12.0), normalizedGain(-3.0));
+
+    processor.collectParameterChanges(&changes);
+    expect(processor.queuedEvents() == 1, "oversized queue collapses to one event");
+
+    // Processing the block commits that event
+    std::vector<float> left(256, 0.0f);
+    std::vector<float> right(256, 0.0f);
+    processBlock(processor, &changes, left, right);
+    expect(std::abs(processor.getEQ().getBandGain(2) - (-3.0)) < 1e-9,
+           "band 3 gain ends at the last queued value");
+}
+
+// A point at offset 100 of a 512-sample block against the unsplit reference:
+// the new coefficients must start ramping at that sample and be reached
+// eq::EQProcessor::kRampFrames later, whatever the rest of the block holds
+void testMidBlockEventStartsAtItsOffset() {
+    constexpr size_t kBlock = 512;
+    constexpr Steinberg::int32 kOffset = 100;
+
+    AutomationProbe processor;
+    Steinberg::Vst::ParameterChanges changes;
+    addPoint(changes, SpectrumEQ::kBand3Gain, kOffset, normalizedGain(9.0));
+
+    std::vector<float> input = testSignal(kBlock, 1.0);
+    std::vector<float> left = input;
+    std::vector<float> right = testSignal(kBlock, 2.0);
+    processBlock(processor, &changes, left, right);
+
+    const eq::EQProcessor& committed = processor.getEQ();
+    expect(std::abs(committed.getBandGain(2) - 9.0) < 1e-9, "mid-block gain is committed");
+
+    eq::BiquadFilter design;
+    design.setPeakingEQ(44100.0, committed.getBandFrequency(2), committed.getBandGain(2), committed.getBandQ(2));
+    std::vector<float> refLeft = referenceFilter(input, kOffset, eq::EQProcessor::kRampFrames,
+                                                 design.getCoefficients());
+    std::vector<float> refRight = referenceFilter(testSignal(kBlock, 2.0), kOffset,
+                                                  eq::EQProcessor::kRampFrames, design.getCoefficients());
+
+    // Flat EQ up to the offset, so the signal passes untouched
+    bool untouched = true;
+    for (Steinberg::int32 i = 0; i < kOffset; ++i) {
+        untouched = untouched && left[i] == input[i];
+    }
+    expect(untouched, "samples before the offset are unchanged");
+    expect(left[kOffset + 1] != input[kOffset + 1], "the change starts right after its offset");
+
+    double worst = 0.0;
+    for (size_t i = 0; i < kBlock; ++i) {
+        worst = (std::max)(worst, static_cast<double>(std::abs(left[i] - refLeft[i])));
+        worst = (std::max)(worst, static_cast<double>(std::abs(right[i] - refRight[i])));
+    }
+    expect(worst < 1e-5, "output matches the unsplit reference");
+}
+
+} // namespace
+
+int main() {
+    testOverflowCommitsBeforeFirstSubBlock();
+    testOversizedQueueKeepsFinalValue();
+    testMidBlockEventStartsAtItsOffset();
+
+    if (failures == 0) {
+        std::printf("All automation tests passed\n");
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -1,5 +1,6 @@
 #include "gl_renderer.hpp"
 #include <algorithm>
+#include <cstddef>
 #include <cstring>
 
 namespace gl {
@@ -105,6 +106,34 @@ static const uint8_t FONT_DATA[][10] = {
     {0x00,0x00,0x10,0x2A,0x04,0x00,0x00,0x00,0x00,0x00}, // ~
 };
 
+// GL 1.5 buffer object enums (Windows headers stop at GL 1.1)
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER 0x8892
+#endif
+#ifndef GL_STREAM_DRAW
+#define GL_STREAM_DRAW 0x88E0
+#endif
+
+// GL 3.0 framebuffer object enums
+#ifndef GL_FRAMEBUFFER
+#define GL_FRAMEBUFFER 0x8D40
+#endif
+#ifndef GL_COLOR_ATTACHMENT0
+#define GL_COLOR_ATTACHMENT0 0x8CE0
+#endif
+#ifndef GL_FRAMEBUFFER_COMPLETE
+#define GL_FRAMEBUFFER_COMPLETE 0x8CD5
+#endif
+
+// Glyph atlas: 95 glyphs in 8x10 cells, 16 per row; the cell after the
+// last glyph is solid and provides the texel for untextured geometry
+static const int ATLAS_COLUMNS = 16;
+static const int ATLAS_CELL_WIDTH = 8;
+static const int ATLAS_CELL_HEIGHT = 10;
+static const int ATLAS_WIDTH = 128;
+static const int ATLAS_HEIGHT = 64;
+static const int NUM_GLYPHS = 95;
+
 Renderer::Renderer() {}
 
 Renderer::~Renderer() {
@@ -130,15 +159,171 @@ bool Renderer::initialize(int width, int height) {
     // Enable multisampling if available (GL_MULTISAMPLE = 0x809D)
     glEnable(0x809D);
     
+    // Text and shapes share one texture: the atlas, modulated by vertex color
+    createGlyphAtlas();
+    glEnable(GL_TEXTURE_2D);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+    
+    // Batch submission: interleaved position + texcoord + color arrays
+    vertices_.reserve(kMaxBatchVertices);
+    textKey_.reserve(256);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    if (loadBufferApi()) {
+        genBuffers_(1, &vbo_);
+    }
+    loadFramebufferApi();
+    
+    return true;
+}
+
+bool Renderer::loadBufferApi() {
+#ifdef _WIN32
+    // Entry points belong to the current context, so load them per renderer
+    genBuffers_ = reinterpret_cast<GenBuffersProc>(wglGetProcAddress("glGenBuffers"));
+    deleteBuffers_ = reinterpret_cast<DeleteBuffersProc>(wglGetProcAddress("glDeleteBuffers"));
+    bindBuffer_ = reinterpret_cast<BindBufferProc>(wglGetProcAddress("glBindBuffer"));
+    bufferData_ = reinterpret_cast<BufferDataProc>(wglGetProcAddress("glBufferData"));
+#endif
+    if (!genBuffers_ || !deleteBuffers_ || !bindBuffer_ || !bufferData_) {
+        genBuffers_ = nullptr;
+        deleteBuffers_ = nullptr;
+        bindBuffer_ = nullptr;
+        bufferData_ = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool Renderer::loadFramebufferApi() {
+#ifdef _WIN32
+    genFramebuffers_ = reinterpret_cast<GenFramebuffersProc>(wglGetProcAddress("glGenFramebuffers"));
+    deleteFramebuffers_ = reinterpret_cast<DeleteFramebuffersProc>(wglGetProcAddress("glDeleteFramebuffers"));
+    bindFramebuffer_ = reinterpret_cast<BindFramebufferProc>(wglGetProcAddress("glBindFramebuffer"));
+    framebufferTexture2D_ = reinterpret_cast<FramebufferTexture2DProc>(wglGetProcAddress("glFramebufferTexture2D"));
+    checkFramebufferStatus_ = reinterpret_cast<CheckFramebufferStatusProc>(wglGetProcAddress("glCheckFramebufferStatus"));
+#endif
+    if (!genFramebuffers_ || !deleteFramebuffers_ || !bindFramebuffer_ ||
+        !framebufferTexture2D_ || !checkFramebufferStatus_) {
+        genFramebuffers_ = nullptr;
+        deleteFramebuffers_ = nullptr;
+        bindFramebuffer_ = nullptr;
+        framebufferTexture2D_ = nullptr;
+        checkFramebufferStatus_ = nullptr;
+        return false;
+    }
     return true;
 }
 
+bool Renderer::ensureStaticLayer() {
+    if (!genFramebuffers_) return false;
+    if (staticFramebuffer_ != 0 && staticWidth_ == width_ && staticHeight_ == height_) return true;
+    
+    releaseStaticLayer();
+    if (width_ <= 0 || height_ <= 0) return false;
+    
+    glGenTextures(1, &staticTexture_);
+    glBindTexture(GL_TEXTURE_2D, staticTexture_);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width_, height_, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindTexture(GL_TEXTURE_2D, atlasTexture_);
+    
+    genFramebuffers_(1, &staticFramebuffer_);
+    bindFramebuffer_(GL_FRAMEBUFFER, staticFramebuffer_);
+    framebufferTexture2D_(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, staticTexture_, 0);
+    bool complete = checkFramebufferStatus_(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    bindFramebuffer_(GL_FRAMEBUFFER, 0);
+    
+    if (!complete) {
+        // Draw the layer directly from now on
+        releaseStaticLayer();
+        genFramebuffers_ = nullptr;
+        return false;
+    }
+    staticWidth_ = width_;
+    staticHeight_ = height_;
+    return true;
+}
+
+void Renderer::releaseStaticLayer() {
+    if (staticFramebuffer_ != 0) {
+        deleteFramebuffers_(1, &staticFramebuffer_);
+        staticFramebuffer_ = 0;
+    }
+    if (staticTexture_ != 0) {
+        glDeleteTextures(1, &staticTexture_);
+        staticTexture_ = 0;
+    }
+    staticWidth_ = 0;
+    staticHeight_ = 0;
+    staticLayerValid_ = false;
+}
+
+void Renderer::createGlyphAtlas() {
+    std::vector<uint8_t> alpha(ATLAS_WIDTH * ATLAS_HEIGHT, 0);
+    
+    auto cellOrigin = [](int index, int& x, int& y) {
+        x = (index % ATLAS_COLUMNS) * ATLAS_CELL_WIDTH;
+        y = (index / ATLAS_COLUMNS) * ATLAS_CELL_HEIGHT;
+    };
+    
+    for (int glyph = 0; glyph < NUM_GLYPHS; ++glyph) {
+        int originX, originY;
+        cellOrigin(glyph, originX, originY);
+        for (int row = 0; row < FONT_CHAR_HEIGHT; ++row) {
+            uint8_t rowBits = FONT_DATA[glyph][row];
+            for (int col = 0; col < FONT_CHAR_WIDTH; ++col) {
+                if (rowBits & (0x20 >> col)) {
+                    alpha[(originY + row) * ATLAS_WIDTH + originX + col] = 255;
+                }
+            }
+        }
+    }
+    
+    // Solid cell
+    int solidX, solidY;
+    cellOrigin(NUM_GLYPHS, solidX, solidY);
+    for (int row = 0; row < ATLAS_CELL_HEIGHT; ++row) {
+        std::fill_n(alpha.begin() + (solidY + row) * ATLAS_WIDTH + solidX, ATLAS_CELL_WIDTH, uint8_t(255));
+    }
+    whiteU_ = (solidX + ATLAS_CELL_WIDTH * 0.5f) / ATLAS_WIDTH;
+    whiteV_ = (solidY + ATLAS_CELL_HEIGHT * 0.5f) / ATLAS_HEIGHT;
+    
+    // Nearest sampling keeps the pixel font crisp, as when drawn per pixel
+    glGenTextures(1, &atlasTexture_);
+    glBindTexture(GL_TEXTURE_2D, atlasTexture_);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, ATLAS_WIDTH, ATLAS_HEIGHT, 0,
+                 GL_ALPHA, GL_UNSIGNED_BYTE, alpha.data());
+}
+
 void Renderer::resize(int width, int height) {
     width_ = width;
     height_ = height;
 }
 
 void Renderer::shutdown() {
+    if (initialized_) {
+        releaseStaticLayer();
+    }
+    if (initialized_ && vbo_ != 0) {
+        deleteBuffers_(1, &vbo_);
+        vbo_ = 0;
+    }
+    if (initialized_ && atlasTexture_ != 0) {
+        glDeleteTextures(1, &atlasTexture_);
+        atlasTexture_ = 0;
+    }
+    vertices_.clear();
+    textCache_.clear();
     initialized_ = false;
 }
 
@@ -152,29 +337,213 @@ void Renderer::beginFrame() {
     
     glMatrixMode(GL_MODELVIEW);
     glLoadIdentity();
+    
+    glBindTexture(GL_TEXTURE_2D, atlasTexture_);
+    ++frameIndex_;
 }
 
 void Renderer::endFrame() {
+    flush();
     glFlush();
+    
+    if (frameIndex_ % kTextCacheFrames == 0) {
+        evictStaleText();
+    }
+}
+
+void Renderer::flush() {
+    if (vertices_.empty()) return;
+    
+    const GLsizei stride = static_cast<GLsizei>(sizeof(Vertex));
+    if (vbo_ != 0) {
+        // Orphan and refill the stream buffer, then point into it
+        bindBuffer_(GL_ARRAY_BUFFER, vbo_);
+        bufferData_(GL_ARRAY_BUFFER, static_cast<std::ptrdiff_t>(vertices_.size() * sizeof(Vertex)),
+                    vertices_.data(), GL_STREAM_DRAW);
+        glVertexPointer(2, GL_FLOAT, stride, reinterpret_cast<const void*>(offsetof(Vertex, x)));
+        glTexCoordPointer(2, GL_FLOAT, stride, reinterpret_cast<const void*>(offsetof(Vertex, u)));
+        glColorPointer(4, GL_UNSIGNED_BYTE, stride, reinterpret_cast<const void*>(offsetof(Vertex, color)));
+        glDrawArrays(batchMode_, 0, static_cast<GLsizei>(vertices_.size()));
+        bindBuffer_(GL_ARRAY_BUFFER, 0);
+    } else {
+        glVertexPointer(2, GL_FLOAT, stride, &vertices_[0].x);
+        glTexCoordPointer(2, GL_FLOAT, stride, &vertices_[0].u);
+        glColorPointer(4, GL_UNSIGNED_BYTE, stride, &vertices_[0].color);
+        glDrawArrays(batchMode_, 0, static_cast<GLsizei>(vertices_.size()));
+    }
+    vertices_.clear();
+}
+
+Texture Renderer::loadTexture(int width, int height, Color fill) {
+    Texture texture;
+    if (width <= 0 || height <= 0) return texture;
+    
+    std::vector<Color> pixels(static_cast<size_t>(width) * height, fill);
+    glGenTextures(1, &texture.id);
+    glBindTexture(GL_TEXTURE_2D, texture.id);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glBindTexture(GL_TEXTURE_2D, atlasTexture_);
+    
+    texture.width = width;
+    texture.height = height;
+    return texture;
 }
 
-void Renderer::setColor(Color color) {
-    glColor4ub(color.r, color.g, color.b, color.a);
+void Renderer::unloadTexture(Texture& texture) {
+    if (texture.id != 0) {
+        glDeleteTextures(1, &texture.id);
+    }
+    texture = Texture();
+}
+
+void Renderer::updateTextureRec(const Texture& texture, Rectangle rec, const Color* pixels) {
+    if (texture.id == 0) return;
+    
+    // Batched quads may still sample the old contents
+    flush();
+    glBindTexture(GL_TEXTURE_2D, texture.id);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, static_cast<GLint>(rec.x), static_cast<GLint>(rec.y),
+                    static_cast<GLsizei>(rec.width), static_cast<GLsizei>(rec.height),
+                    GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glBindTexture(GL_TEXTURE_2D, atlasTexture_);
+}
+
+void Renderer::drawTexturePro(const Texture& texture, Rectangle source, Rectangle dest, Color tint) {
+    if (texture.id == 0) return;
+    
+    // Texture coordinates as raylib computes them: a negative height
+    // swaps the top and bottom rows
+    float w = static_cast<float>(texture.width);
+    float h = static_cast<float>(texture.height);
+    float u0 = source.x / w;
+    float u1 = (source.x + source.width) / w;
+    float v0 = source.y / h;
+    float v1 = (source.y + source.height) / h;
+    if (source.height < 0) {
+        v0 = (source.y - source.height) / h;
+        v1 = source.y / h;
+    }
+    
+    float x0 = dest.x;
+    float y0 = dest.y;
+    float x1 = dest.x + dest.width;
+    float y1 = dest.y + dest.height;
+    
+    flush();
+    glBindTexture(GL_TEXTURE_2D, texture.id);
+    beginPrimitive(GL_TRIANGLES, 6);
+    vertices_.push_back({x0, y0, u0, v0, tint});
+    vertices_.push_back({x1, y0, u1, v0, tint});
+    vertices_.push_back({x1, y1, u1, v1, tint});
+    vertices_.push_back({x0, y0, u0, v0, tint});
+    vertices_.push_back({x1, y1, u1, v1, tint});
+    vertices_.push_back({x0, y1, u0, v1, tint});
+    flush();
+    glBindTexture(GL_TEXTURE_2D, atlasTexture_);
+}
+
+bool Renderer::beginStaticLayer() {
+    if (!ensureStaticLayer()) return true;
+    if (staticLayerValid_) return false;
+    
+    // Same viewport and projection as the screen, so drawing code is unchanged
+    flush();
+    bindFramebuffer_(GL_FRAMEBUFFER, staticFramebuffer_);
+    return true;
+}
+
+void Renderer::endStaticLayer() {
+    if (staticFramebuffer_ == 0) return;
+    
+    flush();
+    bindFramebuffer_(GL_FRAMEBUFFER, 0);
+    staticLayerValid_ = true;
+}
+
+void Renderer::drawStaticLayer() {
+    if (staticFramebuffer_ == 0 || !staticLayerValid_) return;
+    
+    // Plain copy: the layer replaces the background rather than blending
+    // over it. The texture's first row is the bottom of the screen.
+    flush();
+    glDisable(GL_BLEND);
+    glBindTexture(GL_TEXTURE_2D, staticTexture_);
+    
+    const Color white = Colors::White;
+    const float w = static_cast<float>(width_);
+    const float h = static_cast<float>(height_);
+    beginPrimitive(GL_TRIANGLES, 6);
+    vertices_.push_back({0.0f, 0.0f, 0.0f, 1.0f, white});
+    vertices_.push_back({w, 0.0f, 1.0f, 1.0f, white});
+    vertices_.push_back({w, h, 1.0f, 0.0f, white});
+    vertices_.push_back({0.0f, 0.0f, 0.0f, 1.0f, white});
+    vertices_.push_back({w, h, 1.0f, 0.0f, white});
+    vertices_.push_back({0.0f, h, 0.0f, 0.0f, white});
+    flush();
+    
+    glBindTexture(GL_TEXTURE_2D, atlasTexture_);
+    glEnable(GL_BLEND);
+}
+
+void Renderer::beginPrimitive(GLenum mode, size_t vertexCount) {
+    // Primitives never straddle a submission, so each batch stays well-formed
+    if (mode != batchMode_ || vertices_.size() + vertexCount > kMaxBatchVertices) {
+        flush();
+        batchMode_ = mode;
+    }
+}
+
+void Renderer::pushTriangle(float x1, float y1, float x2, float y2, float x3, float y3, Color color) {
+    beginPrimitive(GL_TRIANGLES, 3);
+    vertex(x1, y1, color);
+    vertex(x2, y2, color);
+    vertex(x3, y3, color);
+}
+
+void Renderer::pushQuad(float x1, float y1, float x2, float y2, float x3, float y3,
+                        float x4, float y4, Color color) {
+    beginPrimitive(GL_TRIANGLES, 6);
+    vertex(x1, y1, color);
+    vertex(x2, y2, color);
+    vertex(x3, y3, color);
+    vertex(x1, y1, color);
+    vertex(x3, y3, color);
+    vertex(x4, y4, color);
+}
+
+void Renderer::pushLine(float x1, float y1, float x2, float y2, Color color) {
+    beginPrimitive(GL_LINES, 2);
+    vertex(x1, y1, color);
+    vertex(x2, y2, color);
+}
+
+void Renderer::pushLineLoop(const Vector2* points, size_t count, Color color) {
+    if (count < 2) return;
+    beginPrimitive(GL_LINES, count * 2);
+    for (size_t i = 0; i < count; ++i) {
+        const Vector2& a = points[i];
+        const Vector2& b = points[(i + 1 == count) ? 0 : i + 1];
+        vertex(a.x, a.y, color);
+        vertex(b.x, b.y, color);
+    }
 }
 
 void Renderer::clearBackground(Color color) {
+    // Clearing discards everything batched so far; submit it first so the
+    // result matches immediate mode
+    flush();
     glClearColor(color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f);
     glClear(GL_COLOR_BUFFER_BIT);
 }
 
 void Renderer::drawRectangle(int x, int y, int w, int h, Color color) {
-    setColor(color);
-    glBegin(GL_QUADS);
-    glVertex2i(x, y);
-    glVertex2i(x + w, y);
-    glVertex2i(x + w, y + h);
-    glVertex2i(x, y + h);
-    glEnd();
+    float x0 = static_cast<float>(x), y0 = static_cast<float>(y);
+    float x1 = static_cast<float>(x + w), y1 = static_cast<float>(y + h);
+    pushQuad(x0, y0, x1, y0, x1, y1, x0, y1, color);
 }
 
 void Renderer::drawRectangleRec(Rectangle rec, Color color) {
@@ -183,14 +552,20 @@ void Renderer::drawRectangleRec(Rectangle rec, Color color) {
 }
 
 void Renderer::drawRoundedCorner(float cx, float cy, float radius, float startAngle, int segments, Color color) {
-    setColor(color);
-    glBegin(GL_TRIANGLE_FAN);
-    glVertex2f(cx, cy);
-    for (int i = 0; i <= segments; ++i) {
+    // Triangle fan around the corner center
+    beginPrimitive(GL_TRIANGLES, static_cast<size_t>(segments) * 3);
+    float prevX = cx + std::cos(startAngle) * radius;
+    float prevY = cy + std::sin(startAngle) * radius;
+    for (int i = 1; i <= segments; ++i) {
         float angle = startAngle + (PI / 2.0f) * i / segments;
-        glVertex2f(cx + std::cos(angle) * radius, cy + std::sin(angle) * radius);
+        float x = cx + std::cos(angle) * radius;
+        float y = cy + std::sin(angle) * radius;
+        vertex(cx, cy, color);
+        vertex(prevX, prevY, color);
+        vertex(x, y, color);
+        prevX = x;
+        prevY = y;
     }
-    glEnd();
 }
 
 void Renderer::drawRectangleRounded(Rectangle rec, float roundness, int segments, Color color) {
@@ -202,38 +577,27 @@ void Renderer::drawRectangleRounded(Rectangle rec, float roundness, int segments
     float radius = (std::min)(rec.width, rec.height) * roundness * 0.5f;
     radius = (std::min)(radius, (std::min)(rec.width, rec.height) * 0.5f);
     
-    setColor(color);
+    float left = rec.x, right = rec.x + rec.width;
+    float top = rec.y, bottom = rec.y + rec.height;
     
     // Center rectangle
-    glBegin(GL_QUADS);
-    glVertex2f(rec.x + radius, rec.y);
-    glVertex2f(rec.x + rec.width - radius, rec.y);
-    glVertex2f(rec.x + rec.width - radius, rec.y + rec.height);
-    glVertex2f(rec.x + radius, rec.y + rec.height);
-    glEnd();
+    pushQuad(left + radius, top, right - radius, top,
+             right - radius, bottom, left + radius, bottom, color);
     
     // Left rectangle
-    glBegin(GL_QUADS);
-    glVertex2f(rec.x, rec.y + radius);
-    glVertex2f(rec.x + radius, rec.y + radius);
-    glVertex2f(rec.x + radius, rec.y + rec.height - radius);
-    glVertex2f(rec.x, rec.y + rec.height - radius);
-    glEnd();
+    pushQuad(left, top + radius, left + radius, top + radius,
+             left + radius, bottom - radius, left, bottom - radius, color);
     
     // Right rectangle
-    glBegin(GL_QUADS);
-    glVertex2f(rec.x + rec.width - radius, rec.y + radius);
-    glVertex2f(rec.x + rec.width, rec.y + radius);
-    glVertex2f(rec.x + rec.width, rec.y + rec.height - radius);
-    glVertex2f(rec.x + rec.width - radius, rec.y + rec.height - radius);
-    glEnd();
+    pushQuad(right - radius, top + radius, right, top + radius,
+             right, bottom - radius, right - radius, bottom - radius, color);
     
     // Corners
     int segs = (std::max)(4, segments);
-    drawRoundedCorner(rec.x + radius, rec.y + radius, radius, PI, segs, color);
-    drawRoundedCorner(rec.x + rec.width - radius, rec.y + radius, radius, -PI/2, segs, color);
-    drawRoundedCorner(rec.x + rec.width - radius, rec.y + rec.height - radius, radius, 0, segs, color);
-    drawRoundedCorner(rec.x + radius, rec.y + rec.height - radius, radius, PI/2, segs, color);
+    drawRoundedCorner(left + radius, top + radius, radius, PI, segs, color);
+    drawRoundedCorner(right - radius, top + radius, radius, -PI/2, segs, color);
+    drawRoundedCorner(right - radius, bottom - radius, radius, 0, segs, color);
+    drawRoundedCorner(left + radius, bottom - radius, radius, PI/2, segs, color);
 }
 
 void Renderer::drawRectangleRoundedLines(Rectangle rec, float roundness, int segments, Color color) {
@@ -246,69 +610,50 @@ void Renderer::drawRectangleRoundedLines(Rectangle rec, float roundness, int seg
     float radius = (std::min)(rec.width, rec.height) * roundness * 0.5f;
     radius = (std::min)(radius, (std::min)(rec.width, rec.height) * 0.5f);
     
-    setColor(color);
-    glBegin(GL_LINE_LOOP);
-    
     int segs = (std::max)(4, segments);
     
-    // Top-left corner
-    for (int i = 0; i <= segs; ++i) {
-        float angle = PI + (PI / 2) * i / segs;
-        glVertex2f(rec.x + radius + std::cos(angle) * radius, 
-                   rec.y + radius + std::sin(angle) * radius);
-    }
-    
-    // Top-right corner
-    for (int i = 0; i <= segs; ++i) {
-        float angle = -PI/2 + (PI / 2) * i / segs;
-        glVertex2f(rec.x + rec.width - radius + std::cos(angle) * radius, 
-                   rec.y + radius + std::sin(angle) * radius);
-    }
-    
-    // Bottom-right corner
-    for (int i = 0; i <= segs; ++i) {
-        float angle = 0 + (PI / 2) * i / segs;
-        glVertex2f(rec.x + rec.width - radius + std::cos(angle) * radius, 
-                   rec.y + rec.height - radius + std::sin(angle) * radius);
-    }
+    // Corner centers and start angles: top-left, top-right, bottom-right, bottom-left
+    const float centers[4][2] = {
+        {rec.x + radius, rec.y + radius},
+        {rec.x + rec.width - radius, rec.y + radius},
+        {rec.x + rec.width - radius, rec.y + rec.height - radius},
+        {rec.x + radius, rec.y + rec.height - radius},
+    };
+    const float startAngles[4] = {PI, -PI/2, 0, PI/2};
     
-    // Bottom-left corner
-    for (int i = 0; i <= segs; ++i) {
-        float angle = PI/2 + (PI / 2) * i / segs;
-        glVertex2f(rec.x + radius + std::cos(angle) * radius, 
-                   rec.y + rec.height - radius + std::sin(angle) * radius);
+    outline_.clear();
+    for (int corner = 0; corner < 4; ++corner) {
+        for (int i = 0; i <= segs; ++i) {
+            float angle = startAngles[corner] + (PI / 2) * i / segs;
+            outline_.push_back({centers[corner][0] + std::cos(angle) * radius,
+                                centers[corner][1] + std::sin(angle) * radius});
+        }
     }
-    
-    glEnd();
+    pushLineLoop(outline_.data(), outline_.size(), color);
 }
 
 void Renderer::drawRectangleLines(int x, int y, int w, int h, Color color) {
-    setColor(color);
-    glBegin(GL_LINE_LOOP);
-    glVertex2i(x, y);
-    glVertex2i(x + w, y);
-    glVertex2i(x + w, y + h);
-    glVertex2i(x, y + h);
-    glEnd();
+    float x0 = static_cast<float>(x), y0 = static_cast<float>(y);
+    float x1 = static_cast<float>(x + w), y1 = static_cast<float>(y + h);
+    const Vector2 corners[4] = {{x0, y0}, {x1, y0}, {x1, y1}, {x0, y1}};
+    pushLineLoop(corners, 4, color);
 }
 
 void Renderer::drawRectangleGradientV(int x, int y, int w, int h, Color top, Color bottom) {
-    glBegin(GL_QUADS);
-    glColor4ub(top.r, top.g, top.b, top.a);
-    glVertex2i(x, y);
-    glVertex2i(x + w, y);
-    glColor4ub(bottom.r, bottom.g, bottom.b, bottom.a);
-    glVertex2i(x + w, y + h);
-    glVertex2i(x, y + h);
-    glEnd();
+    float x0 = static_cast<float>(x), y0 = static_cast<float>(y);
+    float x1 = static_cast<float>(x + w), y1 = static_cast<float>(y + h);
+    beginPrimitive(GL_TRIANGLES, 6);
+    vertex(x0, y0, top);
+    vertex(x1, y0, top);
+    vertex(x1, y1, bottom);
+    vertex(x0, y0, top);
+    vertex(x1, y1, bottom);
+    vertex(x0, y1, bottom);
 }
 
 void Renderer::drawLine(int x1, int y1, int x2, int y2, Color color) {
-    setColor(color);
-    glBegin(GL_LINES);
-    glVertex2i(x1, y1);
-    glVertex2i(x2, y2);
-    glEnd();
+    pushLine(static_cast<float>(x1), static_cast<float>(y1),
+             static_cast<float>(x2), static_cast<float>(y2), color);
 }
 
 void Renderer::drawLineEx(Vector2 start, Vector2 end, float thick, Color color) {
@@ -326,92 +671,122 @@ void Renderer::drawLineEx(Vector2 start, Vector2 end, float thick, Color color)
     float nx = -dy / len * thick * 0.5f;
     float ny = dx / len * thick * 0.5f;
     
-    setColor(color);
-    glBegin(GL_QUADS);
-    glVertex2f(start.x + nx, start.y + ny);
-    glVertex2f(end.x + nx, end.y + ny);
-    glVertex2f(end.x - nx, end.y - ny);
-    glVertex2f(start.x - nx, start.y - ny);
-    glEnd();
+    pushQuad(start.x + nx, start.y + ny, end.x + nx, end.y + ny,
+             end.x - nx, end.y - ny, start.x - nx, start.y - ny, color);
 }
 
 void Renderer::drawCircle(int cx, int cy, float radius, Color color) {
-    int segments = (std::max)(12, static_cast<int>(radius * 0.5f));
-    setColor(color);
-    glBegin(GL_TRIANGLE_FAN);
-    glVertex2i(cx, cy);
-    for (int i = 0; i <= segments; ++i) {
-        float angle = 2.0f * PI * i / segments;
-        glVertex2f(cx + std::cos(angle) * radius, cy + std::sin(angle) * radius);
-    }
-    glEnd();
+    drawCircleGradient(cx, cy, radius, color, color);
 }
 
 void Renderer::drawCircleLines(int cx, int cy, float radius, Color color) {
     int segments = (std::max)(12, static_cast<int>(radius * 0.5f));
-    setColor(color);
-    glBegin(GL_LINE_LOOP);
+    outline_.clear();
     for (int i = 0; i < segments; ++i) {
         float angle = 2.0f * PI * i / segments;
-        glVertex2f(cx + std::cos(angle) * radius, cy + std::sin(angle) * radius);
+        outline_.push_back({cx + std::cos(angle) * radius, cy + std::sin(angle) * radius});
     }
-    glEnd();
+    pushLineLoop(outline_.data(), outline_.size(), color);
 }
 
 void Renderer::drawCircleGradient(int cx, int cy, float radius, Color inner, Color outer) {
     int segments = (std::max)(12, static_cast<int>(radius * 0.5f));
-    glBegin(GL_TRIANGLE_FAN);
-    glColor4ub(inner.r, inner.g, inner.b, inner.a);
-    glVertex2i(cx, cy);
-    glColor4ub(outer.r, outer.g, outer.b, outer.a);
-    for (int i = 0; i <= segments; ++i) {
+    float centerX = static_cast<float>(cx), centerY = static_cast<float>(cy);
+    
+    // Triangle fan from the center
+    beginPrimitive(GL_TRIANGLES, static_cast<size_t>(segments) * 3);
+    float prevX = centerX + radius;
+    float prevY = centerY;
+    for (int i = 1; i <= segments; ++i) {
         float angle = 2.0f * PI * i / segments;
-        glVertex2f(cx + std::cos(angle) * radius, cy + std::sin(angle) * radius);
+        float x = centerX + std::cos(angle) * radius;
+        float y = centerY + std::sin(angle) * radius;
+        vertex(centerX, centerY, inner);
+        vertex(prevX, prevY, outer);
+        vertex(x, y, outer);
+        prevX = x;
+        prevY = y;
     }
-    glEnd();
 }
 
 void Renderer::drawTriangle(Vector2 v1, Vector2 v2, Vector2 v3, Color color) {
-    setColor(color);
-    glBegin(GL_TRIANGLES);
-    glVertex2f(v1.x, v1.y);
-    glVertex2f(v2.x, v2.y);
-    glVertex2f(v3.x, v3.y);
-    glEnd();
+    pushTriangle(v1.x, v1.y, v2.x, v2.y, v3.x, v3.y, color);
 }
 
-void Renderer::drawText(const char* text, int x, int y, int fontSize, Color color) {
-    if (!text) return;
+const Renderer::TextLayout& Renderer::layoutText(const char* text, int fontSize) {
+    // Key: font size, then the text
+    textKey_.assign(reinterpret_cast<const char*>(&fontSize), sizeof(fontSize));
+    textKey_.append(text);
     
-    float scale = fontSize / 10.0f;  // Base font is 10px tall
-    int cursorX = x;
+    auto found = textCache_.find(textKey_);
+    if (found != textCache_.end()) {
+        found->second.lastUsedFrame = frameIndex_;
+        return found->second;
+    }
+    
+    if (textCache_.size() >= kMaxCachedLabels) {
+        evictStaleText();
+        if (textCache_.size() >= kMaxCachedLabels) {
+            textCache_.clear();
+        }
+    }
+    
+    TextLayout& layout = textCache_[textKey_];
+    layout.lastUsedFrame = frameIndex_;
     
-    setColor(color);
+    float scale = fontSize / 10.0f;  // Base font is 10px tall
+    float glyphWidth = FONT_CHAR_WIDTH * scale;
+    float glyphHeight = FONT_CHAR_HEIGHT * scale;
+    int cursorX = 0;
     
     for (const char* p = text; *p; ++p) {
         int charIndex = static_cast<int>(*p) - 32;
-        if (charIndex < 0 || charIndex >= 95) charIndex = 0;  // Default to space
-        
-        const uint8_t* charData = FONT_DATA[charIndex];
+        if (charIndex < 0 || charIndex >= NUM_GLYPHS) charIndex = 0;  // Default to space
         
-        for (int row = 0; row < 10; ++row) {
-            uint8_t rowBits = charData[row];
-            for (int col = 0; col < 6; ++col) {
-                if (rowBits & (0x20 >> col)) {
-                    float px = cursorX + col * scale;
-                    float py = y + row * scale;
-                    
-                    glBegin(GL_QUADS);
-                    glVertex2f(px, py);
-                    glVertex2f(px + scale, py);
-                    glVertex2f(px + scale, py + scale);
-                    glVertex2f(px, py + scale);
-                    glEnd();
-                }
-            }
+        if (charIndex != 0) {
+            float u0 = static_cast<float>((charIndex % ATLAS_COLUMNS) * ATLAS_CELL_WIDTH) / ATLAS_WIDTH;
+            float v0 = static_cast<float>((charIndex / ATLAS_COLUMNS) * ATLAS_CELL_HEIGHT) / ATLAS_HEIGHT;
+            float u1 = u0 + static_cast<float>(FONT_CHAR_WIDTH) / ATLAS_WIDTH;
+            float v1 = v0 + static_cast<float>(FONT_CHAR_HEIGHT) / ATLAS_HEIGHT;
+            float x0 = static_cast<float>(cursorX);
+            float x1 = x0 + glyphWidth;
+            
+            const float quad[6][4] = {
+                {x0, 0.0f, u0, v0}, {x1, 0.0f, u1, v0}, {x1, glyphHeight, u1, v1},
+                {x0, 0.0f, u0, v0}, {x1, glyphHeight, u1, v1}, {x0, glyphHeight, u0, v1},
+            };
+            layout.quads.insert(layout.quads.end(), &quad[0][0], &quad[0][0] + 24);
         }
         
-        cursorX += static_cast<int>(FONT_CHAR_WIDTH * scale);
+        cursorX += static_cast<int>(glyphWidth);
+    }
+    layout.width = cursorX;
+    return layout;
+}
+
+void Renderer::evictStaleText() {
+    for (auto it = textCache_.begin(); it != textCache_.end(); ) {
+        if (frameIndex_ - it->second.lastUsedFrame > kTextCacheFrames) {
+            it = textCache_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void Renderer::drawText(const char* text, int x, int y, int fontSize, Color color) {
+    if (!text || !*text) return;
+    
+    const TextLayout& layout = layoutText(text, fontSize);
+    size_t count = layout.quads.size() / 4;
+    if (count == 0) return;
+    
+    float offsetX = static_cast<float>(x);
+    float offsetY = static_cast<float>(y);
+    beginPrimitive(GL_TRIANGLES, count);
+    const float* q = layout.quads.data();
+    for (size_t i = 0; i < count; ++i, q += 4) {
+        vertices_.push_back({q[0] + offsetX, q[1] + offsetY, q[2], q[3], color});
     }
 }
 
@@ -3,6 +3,23 @@
 /**
  * OpenGL Renderer - raylib-compatible drawing API for VST3
  * This provides the same drawing functions as raylib but uses raw OpenGL
+ *
+ * Draw calls do not touch GL directly: they append colored vertices to a
+ * per-frame batch (triangles or lines), which is submitted with one
+ * glDrawArrays when the primitive type changes, the batch fills up, the
+ * background is cleared or the frame ends. The batch is streamed through a
+ * VBO when the driver exposes GL 1.5 buffer objects, otherwise through
+ * client-side vertex arrays.
+ *
+ * Text comes from a glyph atlas texture built once from the embedded
+ * bitmap font: one textured quad per character. Untextured geometry
+ * samples a solid texel of the same atlas, so shapes and text share every
+ * batch. Label layouts are cached between frames.
+ *
+ * Geometry that only changes on resize or theme change (background, grid,
+ * axis labels) can be drawn into a retained static layer: a framebuffer
+ * object texture that is composited under each frame with one quad. Without
+ * framebuffer object support the layer is simply drawn every frame.
  */
 
 #ifdef _WIN32
@@ -14,8 +31,10 @@
 #endif
 
 #include <GL/gl.h>
+#include <cstddef>
 #include <cstdint>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <cmath>
 
@@ -48,6 +67,13 @@ struct Rectangle {
         : x(x_), y(y_), width(w_), height(h_) {}
 };
 
+// RGBA8 texture; nearest filtering and repeat wrap (raylib's defaults)
+struct Texture {
+    GLuint id = 0;
+    int width = 0;
+    int height = 0;
+};
+
 // ============================================================================
 // Renderer Class
 // ============================================================================
@@ -97,19 +123,142 @@ public:
     void drawText(const char* text, int x, int y, int fontSize, Color color);
     int measureText(const char* text, int fontSize);
     
+    // Textures (owned by the caller; unload before shutdown)
+    Texture loadTexture(int width, int height, Color fill);
+    void unloadTexture(Texture& texture);
+    void updateTextureRec(const Texture& texture, Rectangle rec, const Color* pixels);
+    
+    /**
+     * Draw part of a texture stretched over dest, like raylib's DrawTexturePro
+     * (without origin and rotation). A negative source height flips the image
+     * vertically; source coordinates outside the texture wrap.
+     */
+    void drawTexturePro(const Texture& texture, Rectangle source, Rectangle dest, Color tint);
+    
     // Utilities
     static Color fade(Color color, float alpha);
     static Color lerpColor(Color a, Color b, float t);
     static bool checkCollisionPointRec(Vector2 point, Rectangle rec);
     
+    /**
+     * Submit pending geometry now (call before issuing raw GL commands)
+     */
+    void flush();
+    
+    /**
+     * Start drawing the retained static layer
+     * When this returns true, draw the layer contents and call
+     * endStaticLayer(); when false, the cached layer is still valid.
+     * Without framebuffer objects it returns true every frame and the
+     * contents go straight to the screen.
+     *
+     * @return true if the layer must be drawn now
+     */
+    bool beginStaticLayer();
+    
+    /**
+     * Finish drawing the static layer and return to the screen
+     */
+    void endStaticLayer();
+    
+    /**
+     * Copy the static layer to the screen (replaces everything below it)
+     */
+    void drawStaticLayer();
+    
+    /**
+     * Force the static layer to be redrawn (e.g. after a theme change)
+     */
+    void invalidateStaticLayer() { staticLayerValid_ = false; }
+    
 private:
-    void setColor(Color color);
+    // Interleaved batch vertex (vertex, texture coordinate and color arrays)
+    struct Vertex {
+        float x, y;
+        float u, v;
+        Color color;
+    };
+    
+    // Laid-out label at the origin: two triangles per visible character,
+    // positions and texture coordinates only
+    struct TextLayout {
+        std::vector<float> quads;       // x, y, u, v per vertex
+        int width = 0;
+        uint64_t lastUsedFrame = 0;
+    };
+    
+    // Vertices per draw call before the batch is submitted early
+    static constexpr size_t kMaxBatchVertices = 1 << 16;
+    
+    // Labels kept while drawn at least once every kTextCacheFrames frames
+    static constexpr uint64_t kTextCacheFrames = 120;
+    static constexpr size_t kMaxCachedLabels = 512;
+    
+    void beginPrimitive(GLenum mode, size_t vertexCount);
+    void vertex(float x, float y, Color color) { vertices_.push_back({x, y, whiteU_, whiteV_, color}); }
+    void pushTriangle(float x1, float y1, float x2, float y2, float x3, float y3, Color color);
+    void pushQuad(float x1, float y1, float x2, float y2, float x3, float y3, float x4, float y4, Color color);
+    void pushLine(float x1, float y1, float x2, float y2, Color color);
+    void pushLineLoop(const Vector2* points, size_t count, Color color);
     void drawRoundedCorner(float cx, float cy, float radius, float startAngle, int segments, Color color);
     
+    bool loadBufferApi();
+    bool loadFramebufferApi();
+    bool ensureStaticLayer();
+    void releaseStaticLayer();
+    void createGlyphAtlas();
+    const TextLayout& layoutText(const char* text, int fontSize);
+    void evictStaleText();
+    
     int width_ = 0;
     int height_ = 0;
     bool initialized_ = false;
     
+    // Current batch: GL_TRIANGLES or GL_LINES
+    std::vector<Vertex> vertices_;
+    GLenum batchMode_ = GL_TRIANGLES;
+    std::vector<Vector2> outline_;      // Scratch for line loops
+    
+    // Glyph atlas (alpha texture) and the texel untextured geometry samples
+    GLuint atlasTexture_ = 0;
+    float whiteU_ = 0.0f;
+    float whiteV_ = 0.0f;
+    
+    // Label layouts keyed by font size and text
+    std::unordered_map<std::string, TextLayout> textCache_;
+    std::string textKey_;               // Scratch lookup key
+    uint64_t frameIndex_ = 0;
+    
+    // GL 1.5 buffer object entry points (null when unavailable)
+    using GenBuffersProc = void (APIENTRY*)(GLsizei, GLuint*);
+    using DeleteBuffersProc = void (APIENTRY*)(GLsizei, const GLuint*);
+    using BindBufferProc = void (APIENTRY*)(GLenum, GLuint);
+    using BufferDataProc = void (APIENTRY*)(GLenum, std::ptrdiff_t, const void*, GLenum);
+    GenBuffersProc genBuffers_ = nullptr;
+    DeleteBuffersProc deleteBuffers_ = nullptr;
+    BindBufferProc bindBuffer_ = nullptr;
+    BufferDataProc bufferData_ = nullptr;
+    GLuint vbo_ = 0;
+    
+    // GL 3.0 / ARB_framebuffer_object entry points (null when unavailable)
+    using GenFramebuffersProc = void (APIENTRY*)(GLsizei, GLuint*);
+    using DeleteFramebuffersProc = void (APIENTRY*)(GLsizei, const GLuint*);
+    using BindFramebufferProc = void (APIENTRY*)(GLenum, GLuint);
+    using FramebufferTexture2DProc = void (APIENTRY*)(GLenum, GLenum, GLenum, GLuint, GLint);
+    using CheckFramebufferStatusProc = GLenum (APIENTRY*)(GLenum);
+    GenFramebuffersProc genFramebuffers_ = nullptr;
+    DeleteFramebuffersProc deleteFramebuffers_ = nullptr;
+    BindFramebufferProc bindFramebuffer_ = nullptr;
+    FramebufferTexture2DProc framebufferTexture2D_ = nullptr;
+    CheckFramebufferStatusProc checkFramebufferStatus_ = nullptr;
+    
+    // Static layer: color texture attached to an FBO, at the window size
+    GLuint staticFramebuffer_ = 0;
+    GLuint staticTexture_ = 0;
+    int staticWidth_ = 0;
+    int staticHeight_ = 0;
+    bool staticLayerValid_ = false;
+    
     // Simple bitmap font data (embedded)
     static const int FONT_CHAR_WIDTH = 6;
     static const int FONT_CHAR_HEIGHT = 10;
@@ -4,6 +4,7 @@
 #include "eq_processor.hpp"
 #include "base/source/fstreamer.h"
 #include "pluginterfaces/base/ustring.h"
+#include <cstdint>
 
 namespace SpectrumEQ {
 
@@ -81,6 +82,25 @@ void PluginController::removeEditor(PluginEditor* editor) {
     }
 }
 
+void PluginController::notifyEditorOpen(bool open) {
+    Steinberg::IPtr<Steinberg::Vst::IMessage> message = Steinberg::owned(allocateMessage());
+    if (!message) return;
+    
+    message->setMessageID(kMsgEditorState);
+    message->getAttributes()->setInt("open", open ? 1 : 0);
+    sendMessage(message);
+}
+
+void PluginController::sendAnalysisSettings(int hopSize, bool skipWhenClosed) {
+    Steinberg::IPtr<Steinberg::Vst::IMessage> message = Steinberg::owned(allocateMessage());
+    if (!message) return;
+    
+    message->setMessageID(kMsgAnalysisSettings);
+    message->getAttributes()->setInt("hopSize", hopSize);
+    message->getAttributes()->setInt("skipWhenClosed", skipWhenClosed ? 1 : 0);
+    sendMessage(message);
+}
+
 Steinberg::tresult PLUGIN_API PluginController::setParamNormalized(Steinberg::Vst::ParamID tag, 
                                                                     Steinberg::Vst::ParamValue value) {
     // Call base class first
@@ -135,6 +155,26 @@ Steinberg::tresult PLUGIN_API PluginController::setComponentState(Steinberg::IBS
     return Steinberg::kResultOk;
 }
 
+Steinberg::tresult PLUGIN_API PluginController::notify(Steinberg::Vst::IMessage* message) {
+    if (!message) return Steinberg::kInvalidArgument;
+    
+    if (Steinberg::FIDStringsEqual(message->getMessageID(), kMsgSpectrumPublisher)) {
+        Steinberg::int64 address = 0;
+        Steinberg::Vst::IAttributeList* attributes = message->getAttributes();
+        if (attributes && attributes->getInt("address", address) == Steinberg::kResultOk) {
+            publisher_.store(reinterpret_cast<SpectrumPublisher*>(static_cast<intptr_t>(address)));
+        }
+        return Steinberg::kResultOk;
+    }
+    
+    return EditController::notify(message);
+}
+
+Steinberg::tresult PLUGIN_API PluginController::disconnect(Steinberg::Vst::IConnectionPoint* other) {
+    publisher_.store(nullptr);
+    return EditController::disconnect(other);
+}
+
 Steinberg::IPlugView* PLUGIN_API PluginController::createView(Steinberg::FIDString name) {
     if (Steinberg::FIDStringsEqual(name, Steinberg::Vst::ViewType::kEditor)) {
         auto* editor = new PluginEditor(this);
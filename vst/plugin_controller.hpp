@@ -2,10 +2,12 @@
 
 #include "public.sdk/source/vst/vsteditcontroller.h"
 #include <mutex>
+#include <atomic>
 
 namespace SpectrumEQ {
 
 class PluginEditor;
+class SpectrumPublisher;
 
 /**
  * VST3 Edit Controller
@@ -30,13 +32,38 @@ public:
     // Create custom editor UI
     Steinberg::IPlugView* PLUGIN_API createView(Steinberg::FIDString name) override;
     
+    // IConnectionPoint (receives the processor's spectrum publisher)
+    Steinberg::tresult PLUGIN_API notify(Steinberg::Vst::IMessage* message) override;
+    Steinberg::tresult PLUGIN_API disconnect(Steinberg::Vst::IConnectionPoint* other) override;
+    
+    /**
+     * Spectrum publisher of the connected processor instance
+     * @return Publisher, or nullptr when not connected
+     */
+    SpectrumPublisher* getSpectrumPublisher() const { return publisher_.load(); }
+    
     // Editor management
     void setEditor(PluginEditor* editor);
     void removeEditor(PluginEditor* editor);
     
+    /**
+     * Tell the processor whether the editor is on screen so it can skip
+     * spectrum analysis while nobody is looking
+     * @param open True when the editor window is attached
+     */
+    void notifyEditorOpen(bool open);
+    
+    /**
+     * Configure processor-side analysis scheduling
+     * @param hopSize Samples between FFTs (clamped by the processor)
+     * @param skipWhenClosed Skip analysis entirely while the editor is closed
+     */
+    void sendAnalysisSettings(int hopSize, bool skipWhenClosed);
+    
 private:
     PluginEditor* editor_ = nullptr;
     std::mutex editorMutex_;
+    std::atomic<SpectrumPublisher*> publisher_{nullptr};
 };
 
 } // namespace SpectrumEQ
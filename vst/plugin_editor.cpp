@@ -1,7 +1,7 @@
 #include "plugin_editor.hpp"
 #include "plugin_controller.hpp"
 #include "plugin_ids.hpp"
-#include "shared_data.hpp"
+#include "perf_stats.hpp"
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
@@ -16,6 +16,9 @@ static const wchar_t* REGISTRY_KEY = L"SOFTWARE\\SpectrumEQ";
 static const wchar_t* REG_WINDOW_WIDTH = L"WindowWidth";
 static const wchar_t* REG_WINDOW_HEIGHT = L"WindowHeight";
 static const wchar_t* REG_THEME_INDEX = L"ThemeIndex";
+static const wchar_t* REG_VSYNC = L"VSync";
+static const wchar_t* REG_HOP_SIZE = L"HopSize";
+static const wchar_t* REG_ANALYZE_CLOSED = L"AnalyzeWhenClosed";
 
 namespace SpectrumEQ {
 
@@ -37,9 +40,13 @@ PluginEditor::PluginEditor(PluginController* controller)
         eqControls_[i].q = static_cast<float>(eq::DEFAULT_Q);
     }
     
-    spectrum_.resize(256, 0.0f);
+    spectrum_.resize(256, -60.0f);
     peakHold_.resize(256, -60.0f);
     peakDecay_.resize(256, 0.0f);
+    
+    // Stage timings log (SPECTRUM_PERF_LOG), opened once per process
+    static const bool perfLogOpened = perf::openLogFromEnvironment();
+    (void)perfLogOpened;
 }
 
 PluginEditor::~PluginEditor() {
@@ -104,8 +111,16 @@ Steinberg::tresult PLUGIN_API PluginEditor::attached(void* parent, Steinberg::FI
     // Sync EQ parameters from controller
     syncParametersFromController();
     
-    // Start render timer
-    timerId_ = SetTimer(hwnd_, TIMER_ID, FRAME_INTERVAL, nullptr);
+    // Start the repaint poll; frames are drawn only when something changed
+    applySwapInterval();
+    setTimerInterval(FRAME_INTERVAL);
+    invalidate();
+    
+    // Processor only analyzes while the editor is visible (unless told otherwise)
+    if (controller_) {
+        sendAnalysisSettings();
+        controller_->notifyEditorOpen(true);
+    }
     
     return Steinberg::kResultOk;
 #else
@@ -115,14 +130,21 @@ Steinberg::tresult PLUGIN_API PluginEditor::attached(void* parent, Steinberg::FI
 
 Steinberg::tresult PLUGIN_API PluginEditor::removed() {
 #ifdef _WIN32
+    if (controller_) {
+        sendAnalysisSettings();
+        controller_->notifyEditorOpen(false);
+    }
+    
     // Save settings before closing
     saveSettings();
     
     if (timerId_) {
         KillTimer(hwnd_, TIMER_ID);
         timerId_ = 0;
+        timerInterval_ = 0;
     }
     
+    renderer_.unloadTexture(spectrogram_);
     renderer_.shutdown();
     destroyOpenGLContext();
     destroyWindow();
@@ -166,6 +188,7 @@ Steinberg::tresult PLUGIN_API PluginEditor::onSize(Steinberg::ViewRect* newSize)
 #endif
     
     renderer_.resize(width_, height_);
+    invalidate();
     
     return Steinberg::kResultOk;
 }
@@ -205,6 +228,7 @@ void PluginEditor::updateSpectrum(const std::vector<float>& spectrum) {
         peakDecay_.resize(spectrum.size(), 0.0f);
     }
     spectrum_ = spectrum;
+    invalidate();
 }
 
 // EQ parameter update from controller
@@ -213,11 +237,13 @@ void PluginEditor::updateEQParameter(int band, double gain, double freq, double
         eqControls_[band].gain = static_cast<float>(gain);
         eqControls_[band].frequency = static_cast<float>(freq);
         eqControls_[band].q = static_cast<float>(q);
+        invalidate();
     }
 }
 
 void PluginEditor::setBypass(bool bypass) {
     eqEnabled_ = !bypass;
+    invalidate();
 }
 
 #ifdef _WIN32
@@ -314,9 +340,56 @@ bool PluginEditor::createOpenGLContext() {
         return false;
     }
     
+    // Swap interval control (WGL_EXT_swap_control); without it the driver default applies
+    swapInterval_ = reinterpret_cast<SwapIntervalProc>(wglGetProcAddress("wglSwapIntervalEXT"));
+    
     return true;
 }
 
+void PluginEditor::applySwapInterval() {
+    if (!swapInterval_ || !hdc_ || !hglrc_) return;
+    wglMakeCurrent(hdc_, hglrc_);
+    swapInterval_(vsync_ ? 1 : 0);
+}
+
+bool PluginEditor::isShowing() const {
+    // Not visible, or the host window is minimized
+    return hwnd_ && IsWindowVisible(hwnd_) && !IsIconic(GetAncestor(hwnd_, GA_ROOT));
+}
+
+void PluginEditor::setTimerInterval(UINT interval) {
+    if (interval == timerInterval_) return;
+    timerId_ = SetTimer(hwnd_, TIMER_ID, interval, nullptr);
+    timerInterval_ = interval;
+}
+
+void PluginEditor::onTick() {
+    // Shared by all editors in the process; refreshes at most once a second
+    if (perf::update() && showPerf_) {
+        invalidate();
+    }
+    
+    // Hidden: draw nothing and only check back now and then
+    if (!isShowing()) {
+        setTimerInterval(HIDDEN_INTERVAL);
+        return;
+    }
+    if (timerInterval_ != FRAME_INTERVAL) {
+        setTimerInterval(FRAME_INTERVAL);
+        invalidate();   // Shown again: the last frame may be stale
+    }
+    
+    SpectrumPublisher* publisher = controller_ ? controller_->getSpectrumPublisher() : nullptr;
+    if (publisher && publisher->hasNewData()) {
+        invalidate();
+    }
+    
+    // Nothing new and nothing animating (stopped transport, idle mouse): skip
+    if (needsRepaint_ || peaksFalling_) {
+        render();
+    }
+}
+
 void PluginEditor::destroyOpenGLContext() {
     if (hglrc_) {
         wglMakeCurrent(nullptr, nullptr);
@@ -343,7 +416,7 @@ LRESULT PluginEditor::handleMessage(UINT msg, WPARAM wParam, LPARAM lParam) {
     switch (msg) {
         case WM_TIMER:
             if (wParam == TIMER_ID) {
-                render();
+                onTick();
             }
             return 0;
             
@@ -362,21 +435,25 @@ LRESULT PluginEditor::handleMessage(UINT msg, WPARAM wParam, LPARAM lParam) {
         case WM_LBUTTONDOWN:
             SetCapture(hwnd_);
             handleMouseDown(LOWORD(lParam), HIWORD(lParam));
+            invalidate();
             return 0;
             
         case WM_LBUTTONUP:
             ReleaseCapture();
             handleMouseUp(LOWORD(lParam), HIWORD(lParam));
+            invalidate();
             return 0;
             
         case WM_MOUSEWHEEL:
             handleMouseWheel(GET_WHEEL_DELTA_WPARAM(wParam) / 120.0f);
+            invalidate();
             return 0;
             
         case WM_SIZE:
             width_ = LOWORD(lParam);
             height_ = HIWORD(lParam);
             renderer_.resize(width_, height_);
+            invalidate();
             return 0;
             
         case WM_KEYDOWN:
@@ -384,8 +461,18 @@ LRESULT PluginEditor::handleMessage(UINT msg, WPARAM wParam, LPARAM lParam) {
             if (wParam == 'T') {
                 themeIndex_ = (themeIndex_ + 1) % colors::themes::NUM_THEMES;
                 theme_ = ColorTheme::byIndex(themeIndex_);
+                renderer_.invalidateStaticLayer();
+                spectrogramRecolor_ = true;
                 themeDropdownOpen_ = false;
             }
+            // 'C' key to cycle the analyzed channel
+            else if (wParam == 'C') {
+                cycleChannelView();
+            }
+            // 'S' key to switch between spectrum and spectrogram
+            else if (wParam == 'S') {
+                toggleView();
+            }
             // 'E' key to toggle EQ bypass
             else if (wParam == 'E') {
                 eqEnabled_ = !eqEnabled_;
@@ -394,6 +481,26 @@ LRESULT PluginEditor::handleMessage(UINT msg, WPARAM wParam, LPARAM lParam) {
                     controller_->performEdit(kBypass, eqEnabled_ ? 0.0 : 1.0);
                 }
             }
+            // 'V' key to toggle vsync
+            else if (wParam == 'V') {
+                vsync_ = !vsync_;
+                applySwapInterval();
+            }
+            // 'H' key to cycle the analysis hop size
+            else if (wParam == 'H') {
+                hopSize_ = hopSize_ >= 2048 ? 256 : hopSize_ * 2;
+                sendAnalysisSettings();
+            }
+            // 'A' key to keep analyzing while the editor is closed
+            else if (wParam == 'A') {
+                analyzeWhenClosed_ = !analyzeWhenClosed_;
+                sendAnalysisSettings();
+            }
+            // F3 to toggle the performance overlay
+            else if (wParam == VK_F3) {
+                showPerf_ = !showPerf_;
+            }
+            invalidate();
             return 0;
     }
     
@@ -407,33 +514,64 @@ void PluginEditor::render() {
     if (!hwnd_ || !hdc_ || !hglrc_) return;
     
     wglMakeCurrent(hdc_, hglrc_);
-#endif
     
-    // Fetch latest spectrum data from processor
-    {
-        std::vector<float> newSpectrum;
-        if (SharedSpectrumData::instance().getSpectrum(newSpectrum)) {
+    // Frames are irregular now, so decays advance by the time since the last one
+    ULONGLONG now = GetTickCount64();
+    float elapsed = lastRenderTime_ ? static_cast<float>(now - lastRenderTime_) / 1000.0f : 0.0f;
+    frameStep_ = (std::min)(elapsed, 0.1f) * 60.0f;
+    lastRenderTime_ = now;
+#endif
+    needsRepaint_ = false;
+    peaksFalling_ = false;
+    uint64_t frameStart = perf::nowNs();
+    
+    // Fetch latest spectrum data from this instance's processor
+    SpectrumPublisher* publisher = controller_ ? controller_->getSpectrumPublisher() : nullptr;
+    if (publisher) {
+        if (const SpectrumFrame* frame = publisher->acquire()) {
             std::lock_guard<std::mutex> lock(spectrumMutex_);
-            spectrum_ = std::move(newSpectrum);
+            const float* bandsDb = frame->channel(channelView_);
+            spectrum_.assign(bandsDb, bandsDb + frame->numBands);
+            if (frame->sampleRate > 0.0) {
+                processorSampleRate_ = frame->sampleRate;
+            }
             
             // Resize peak hold arrays if needed
             if (peakHold_.size() != spectrum_.size()) {
                 peakHold_.resize(spectrum_.size(), -60.0f);
                 peakDecay_.resize(spectrum_.size(), 0.0f);
             }
+            
+            if (view_ == View::Spectrogram) {
+                updateSpectrogram();
+            }
         }
     }
     
     renderer_.beginFrame();
-    renderer_.clearBackground(theme_.background);
     
-    // Draw gradient overlay
-    renderer_.drawRectangleGradientV(0, 0, width_, height_,
-        gl::Renderer::fade(theme_.barMid, 0.05f),
-        gl::Renderer::fade(theme_.background, 0.0f));
+    // Background, gradient and grid only change on resize or theme change,
+    // so they are redrawn into the renderer's static layer on demand
+    if (renderer_.beginStaticLayer()) {
+        renderer_.clearBackground(theme_.background);
+        
+        // Draw gradient overlay
+        renderer_.drawRectangleGradientV(0, 0, width_, height_,
+            gl::Renderer::fade(theme_.barMid, 0.05f),
+            gl::Renderer::fade(theme_.background, 0.0f));
+        
+        renderGrid();
+        renderer_.endStaticLayer();
+    }
+    renderer_.drawStaticLayer();
     
-    renderGrid();
-    renderSpectrum();
+    uint64_t drawStart = perf::nowNs();
+    if (view_ == View::Spectrogram) {
+        renderSpectrogram();
+    } else {
+        renderSpectrum();
+    }
+    perf::record(perf::Stage::Draw, perf::nowNs() - drawStart);
     renderEQCurve();
     renderEQControls();
     renderThemeSelector();
@@ -446,14 +584,181 @@ void PluginEditor::render() {
                           static_cast<float>(eqWidth + 14), 16.0f);
     renderer_.drawRectangleRounded(eqBadge, 0.4f, 4, gl::Renderer::fade(eqColor, 0.15f));
     renderer_.drawText(eqLabel, width_ - eqWidth - 15, 10, 11, eqColor);
+    renderChannelBadge(eqBadge.x - 6.0f);
+    renderViewBadge(channelBadge_.x - 6.0f);
+    
+    if (showPerf_) {
+        renderPerfOverlay();
+    }
     
     renderer_.endFrame();
     
+    // Frame time up to the present (SwapBuffers may wait for vsync)
+    perf::record(perf::Stage::Render, perf::nowNs() - frameStart);
+    
 #ifdef _WIN32
     SwapBuffers(hdc_);
 #endif
 }
 
+void PluginEditor::renderPerfOverlay() {
+    // Last second of stage timings, right-aligned under the badges
+    perf::Snapshot stats = perf::snapshot();
+    
+    int fontSize = 10;
+    int lineHeight = 13;
+    int panelWidth = 340;
+    int x = width_ - panelWidth - 12;
+    int y = 30;
+    
+    int lines = 1;
+    for (size_t i = 0; i < perf::kNumStages; ++i) {
+        if (stats.stages[i].count > 0) ++lines;
+    }
+    gl::Rectangle panel(static_cast<float>(x), static_cast<float>(y),
+                        static_cast<float>(panelWidth), static_cast<float>(lines * lineHeight + 10));
+    renderer_.drawRectangleRounded(panel, 0.1f, 4, gl::Renderer::fade(theme_.background, 0.85f));
+    
+    x += 8;
+    y += 5;
+    std::string load = perf::formatLoad(stats, perf::Stage::Process);
+    renderer_.drawText(load.c_str(), x, y, fontSize, theme_.accent);
+    for (size_t i = 0; i < perf::kNumStages; ++i) {
+        if (stats.stages[i].count == 0) continue;
+        y += lineHeight;
+        std::string line = perf::formatStage(stats, static_cast<perf::Stage>(i));
+        renderer_.drawText(line.c_str(), x, y, fontSize, theme_.text);
+    }
+}
+
+void PluginEditor::renderChannelBadge(float rightEdge) {
+    // Analyzed channel, left of the EQ badge; click or 'C' cycles it
+    static const char* const kLabels[kNumSpectrumChannels] = {"L", "R", "MID", "SIDE"};
+    const char* label = kLabels[static_cast<size_t>(channelView_)];
+    
+    int labelWidth = renderer_.measureText(label, 11);
+    channelBadge_ = gl::Rectangle(rightEdge - labelWidth - 14, 8.0f,
+                                  static_cast<float>(labelWidth + 14), 16.0f);
+    
+    bool overBadge = (mouseX_ >= channelBadge_.x && mouseX_ < channelBadge_.x + channelBadge_.width &&
+                      mouseY_ >= channelBadge_.y && mouseY_ < channelBadge_.y + channelBadge_.height);
+    gl::Color color = channelView_ == SpectrumChannel::Mid ? theme_.textDim : theme_.accent;
+    renderer_.drawRectangleRounded(channelBadge_, 0.4f, 4,
+                                   gl::Renderer::fade(color, overBadge ? 0.3f : 0.15f));
+    renderer_.drawText(label, static_cast<int>(channelBadge_.x) + 7, 10, 11, color);
+}
+
+void PluginEditor::cycleChannelView() {
+    size_t next = (static_cast<size_t>(channelView_) + 1) % kNumSpectrumChannels;
+    channelView_ = static_cast<SpectrumChannel>(next);
+    
+    // Peaks of the previous channel would linger on the new one
+    std::lock_guard<std::mutex> lock(spectrumMutex_);
+    std::fill(peakHold_.begin(), peakHold_.end(), -60.0f);
+    std::fill(peakDecay_.begin(), peakDecay_.end(), 0.0f);
+}
+
+void PluginEditor::renderViewBadge(float rightEdge) {
+    // Spectrum/spectrogram switch, left of the channel badge
+    const char* label = view_ == View::Spectrogram ? "GRAM" : "LIVE";
+    
+    int labelWidth = renderer_.measureText(label, 11);
+    viewBadge_ = gl::Rectangle(rightEdge - labelWidth - 14, 8.0f,
+                               static_cast<float>(labelWidth + 14), 16.0f);
+    
+    bool overBadge = (mouseX_ >= viewBadge_.x && mouseX_ < viewBadge_.x + viewBadge_.width &&
+                      mouseY_ >= viewBadge_.y && mouseY_ < viewBadge_.y + viewBadge_.height);
+    gl::Color color = view_ == View::Spectrogram ? theme_.accent : theme_.textDim;
+    renderer_.drawRectangleRounded(viewBadge_, 0.4f, 4,
+                                   gl::Renderer::fade(color, overBadge ? 0.3f : 0.15f));
+    renderer_.drawText(label, static_cast<int>(viewBadge_.x) + 7, 10, 11, color);
+}
+
+void PluginEditor::toggleView() {
+    view_ = view_ == View::Spectrum ? View::Spectrogram : View::Spectrum;
+}
+
+void PluginEditor::updateSpectrogram() {
+    // Called with spectrumMutex_ held, once per new frame
+    int numBands = static_cast<int>(spectrum_.size());
+    if (numBands == 0) return;
+    
+    // (Re)create the ring when the band count changes
+    if (spectrogram_.id == 0 || spectrogram_.width != numBands) {
+        renderer_.unloadTexture(spectrogram_);
+        spectrogram_ = renderer_.loadTexture(numBands, kSpectrogramRows, theme_.background);
+        spectrogramLevels_.assign(static_cast<size_t>(numBands) * kSpectrogramRows, 0);
+        spectrogramPixels_.resize(spectrogramLevels_.size());
+        spectrogramHead_ = 0;
+        spectrogramRecolor_ = true;
+    }
+    
+    if (spectrogramRecolor_) {
+        recolorSpectrogram();
+    }
+    
+    // -60..0 dB (the graph's range) as level codes
+    uint8_t* levels = spectrogramLevels_.data() + static_cast<size_t>(spectrogramHead_) * numBands;
+    for (int i = 0; i < numBands; ++i) {
+        float t = std::clamp((spectrum_[i] + 60.0f) / 60.0f, 0.0f, 1.0f);
+        levels[i] = static_cast<uint8_t>(t * 255.0f + 0.5f);
+        spectrogramPixels_[i] = spectrogramPalette_[levels[i]];
+    }
+    
+    gl::Rectangle row(0.0f, static_cast<float>(spectrogramHead_), static_cast<float>(numBands), 1.0f);
+    renderer_.updateTextureRec(spectrogram_, row, spectrogramPixels_.data());
+    spectrogramHead_ = (spectrogramHead_ + 1) % kSpectrogramRows;
+}
+
+void PluginEditor::recolorSpectrogram() {
+    // Level code through background, low, mid and high
+    for (size_t code = 0; code < spectrogramPalette_.size(); ++code) {
+        float t = static_cast<float>(code) / 255.0f;
+        gl::Color color;
+        if (t < 0.33f) {
+            color = gl::Renderer::lerpColor(theme_.background, theme_.barLow, t / 0.33f);
+        } else if (t < 0.66f) {
+            color = gl::Renderer::lerpColor(theme_.barLow, theme_.barMid, (t - 0.33f) / 0.33f);
+        } else {
+            color = gl::Renderer::lerpColor(theme_.barMid, theme_.barHigh, (t - 0.66f) / 0.34f);
+        }
+        spectrogramPalette_[code] = color;
+    }
+    spectrogramRecolor_ = false;
+    
+    if (spectrogram_.id == 0) return;
+    for (size_t i = 0; i < spectrogramLevels_.size(); ++i) {
+        spectrogramPixels_[i] = spectrogramPalette_[spectrogramLevels_[i]];
+    }
+    gl::Rectangle all(0.0f, 0.0f, static_cast<float>(spectrogram_.width), static_cast<float>(kSpectrogramRows));
+    renderer_.updateTextureRec(spectrogram_, all, spectrogramPixels_.data());
+}
+
+void PluginEditor::renderSpectrogram() {
+    if (spectrogram_.id == 0) return;
+    
+    // A theme change while no frames arrive still recolors the history
+    if (spectrogramRecolor_) {
+        recolorSpectrogram();
+    }
+    
+    int marginLeft = 55;
+    int marginRight = 15;
+    int marginTop = 40;
+    int marginBottom = 40;
+    
+    int graphWidth = width_ - marginLeft - marginRight;
+    int graphHeight = height_ - marginTop - marginBottom;
+    
+    // Newest row at the top: the flipped source starts at the write row and
+    // runs past the end of the ring, which the repeat wrap folds back
+    gl::Rectangle source(0.0f, static_cast<float>(spectrogramHead_),
+                         static_cast<float>(spectrogram_.width), -static_cast<float>(kSpectrogramRows));
+    gl::Rectangle dest(static_cast<float>(marginLeft), static_cast<float>(marginTop),
+                       static_cast<float>(graphWidth), static_cast<float>(graphHeight));
+    renderer_.drawTexturePro(spectrogram_, source, dest, gl::Colors::White);
+}
+
 void PluginEditor::renderGrid() {
     int marginLeft = 55;
     int marginRight = 15;
@@ -503,7 +808,7 @@ void PluginEditor::renderGrid() {
 void PluginEditor::renderSpectrum() {
     std::lock_guard<std::mutex> lock(spectrumMutex_);
     
-    if (spectrum_.empty()) return;
+    if (spectrum_.size() < 2) return;
     
     int marginLeft = 55;
     int marginRight = 15;
@@ -518,20 +823,9 @@ void PluginEditor::renderSpectrum() {
     float dbMax = 0.0f;
     float dbRange = dbMax - dbMin;
     
-    // Map linear FFT bins to logarithmic display
-    // Assuming 44100 Hz sample rate, FFT size gives us bin resolution
-    size_t fftSize = spectrum_.size() * 2;  // spectrum_ is half of FFT
-    float sampleRate = 44100.0f;  // Typical sample rate
-    float binFreqRes = sampleRate / fftSize;
-    
-    float minFreq = 20.0f;
-    float maxFreq = 20000.0f;
-    float logMinFreq = std::log10(minFreq);
-    float logMaxFreq = std::log10(maxFreq);
-    float logRange = logMaxFreq - logMinFreq;
-    
-    // Number of display bands (logarithmically spaced)
-    const int numDisplayBands = 256;
+    // The processor publishes log-spaced display bands in dB, with slope
+    // compensation already applied
+    const size_t numDisplayBands = spectrum_.size();
     std::vector<gl::Vector2> points(numDisplayBands);
     std::vector<float> dbValues(numDisplayBands);
     
@@ -541,44 +835,9 @@ void PluginEditor::renderSpectrum() {
         peakDecay_.resize(numDisplayBands, 0.0f);
     }
     
-    for (int i = 0; i < numDisplayBands; ++i) {
-        // Calculate frequency for this display band (logarithmic)
+    for (size_t i = 0; i < numDisplayBands; ++i) {
         float t = static_cast<float>(i) / (numDisplayBands - 1);
-        float logFreq = logMinFreq + t * logRange;
-        float freq = std::pow(10.0f, logFreq);
-        
-        // Find the corresponding FFT bin
-        int bin = static_cast<int>(freq / binFreqRes);
-        bin = std::clamp(bin, 0, static_cast<int>(spectrum_.size()) - 1);
-        
-        // Get magnitude (average nearby bins for smoothing)
-        // Use more bins at higher frequencies for better averaging
-        float mag = 0.0f;
-        int smoothRange = (std::max)(1, bin / 8);
-        int count = 0;
-        for (int j = -smoothRange; j <= smoothRange; ++j) {
-            int idx = bin + j;
-            if (idx >= 0 && idx < static_cast<int>(spectrum_.size())) {
-                mag += spectrum_[idx];
-                count++;
-            }
-        }
-        if (count > 0) mag /= count;
-        
-        // Apply slope compensation (+4.5 dB per octave from 1kHz)
-        // This compensates for natural pink noise characteristics of audio
-        // and makes the display more balanced like professional analyzers
-        float octavesFrom1k = std::log2(freq / 1000.0f);
-        float slopeCompensation = octavesFrom1k * 4.5f;  // +4.5 dB per octave
-        
-        // Convert to dB with slope compensation
-        float db;
-        if (mag > 0.00001f) {
-            db = 20.0f * std::log10(mag) + slopeCompensation;
-            db = std::clamp(db, dbMin, dbMax);
-        } else {
-            db = dbMin;
-        }
+        float db = std::clamp(spectrum_[i], dbMin, dbMax);
         dbValues[i] = db;
         
         // Peak hold
@@ -586,12 +845,13 @@ void PluginEditor::renderSpectrum() {
             peakHold_[i] = db;
             peakDecay_[i] = 0.0f;
         } else {
-            peakDecay_[i] += 0.15f;
-            peakHold_[i] -= peakDecay_[i] * 0.1f;
-            peakHold_[i] = (std::max)(peakHold_[i], dbMin);
+            peakDecay_[i] += 0.15f * frameStep_;
+            peakHold_[i] -= peakDecay_[i] * 0.1f * frameStep_;
+            peakHold_[i] = (std::max)(peakHold_[i], db);
+            peaksFalling_ = peaksFalling_ || peakHold_[i] > db;
         }
         
-        // X position (already logarithmic from the loop)
+        // X position (bands are already logarithmic)
         float x = marginLeft + t * graphWidth;
         
         // Y position from dB
@@ -656,40 +916,17 @@ void PluginEditor::renderEQCurve() {
     int baseY = height_ - marginBottom;
     int centerY = marginTop + graphHeight / 2;
     
-    float logFreqMin = std::log10(20.0f);
-    float logFreqMax = std::log10(20000.0f);
-    float logFreqRange = logFreqMax - logFreqMin;
-    
     float dbMin = -12.0f;
     float dbMax = 12.0f;
     float dbRange = dbMax - dbMin;
     
+    // Exact cascade response per pixel, re-evaluated only for changed bands
     int numPoints = graphWidth;
-    std::vector<float> response(numPoints);
-    
-    for (int px = 0; px < numPoints; ++px) {
-        float xNorm = static_cast<float>(px) / (numPoints - 1);
-        float logFreq = logFreqMin + xNorm * logFreqRange;
-        float freq = std::pow(10.0f, logFreq);
-        
-        float totalGainDb = 0.0f;
-        
-        for (int band = 0; band < 5; ++band) {
-            float bandFreq = eqControls_[band].frequency;
-            float bandGain = eqControls_[band].gain;
-            float bandQ = eqControls_[band].q;
-            
-            if (std::abs(bandGain) < 0.01f) continue;
-            
-            float logDist = std::log10(freq) - std::log10(bandFreq);
-            float bandwidth = 1.0f / bandQ;
-            
-            float bellShape = std::exp(-(logDist * logDist) / (2.0f * bandwidth * bandwidth * 0.1f));
-            totalGainDb += bandGain * bellShape;
-        }
-        
-        response[px] = totalGainDb;
+    eqResponse_.setLayout(numPoints, eq::MIN_FREQ, eq::MAX_FREQ, processorSampleRate_);
+    for (int band = 0; band < eq::NUM_BANDS; ++band) {
+        eqResponse_.setBand(band, eqControls_[band].frequency, eqControls_[band].gain, eqControls_[band].q);
     }
+    const std::vector<float>& response = eqResponse_.response();
     
     // Filled area
     for (int px = 0; px < numPoints - 1; ++px) {
@@ -839,6 +1076,14 @@ void PluginEditor::handleMouseMove(int x, int y) {
         eqControls_[i].hovered = (dist < 18.0f);
     }
     
+    // Moving over the background changes nothing on screen; repaint only
+    // when the hovered element changes or a band is being dragged
+    int target = hoverTarget();
+    if (target != hoverTarget_ || draggedBand_ >= 0) {
+        hoverTarget_ = target;
+        invalidate();
+    }
+    
     // Handle dragging
     if (draggedBand_ >= 0 && mouseDown_) {
         int marginLeft = 55;
@@ -901,9 +1146,56 @@ void PluginEditor::handleMouseMove(int x, int y) {
     }
 }
 
+int PluginEditor::hoverTarget() const {
+    // EQ controls 0-4, then the badges, the theme button and dropdown items
+    for (int i = 0; i < 5; ++i) {
+        if (eqControls_[i].hovered) return i;
+    }
+    auto over = [this](const gl::Rectangle& r) {
+        return mouseX_ >= r.x && mouseX_ < r.x + r.width && mouseY_ >= r.y && mouseY_ < r.y + r.height;
+    };
+    if (over(channelBadge_)) return 5;
+    if (over(viewBadge_)) return 6;
+    
+    // Same layout as renderThemeSelector()
+    int selectorX = 10;
+    int selectorY = 8;
+    int selectorWidth = 120;
+    int itemHeight = 22;
+    if (over(gl::Rectangle(static_cast<float>(selectorX), static_cast<float>(selectorY),
+                           static_cast<float>(selectorWidth), static_cast<float>(itemHeight)))) {
+        return 7;
+    }
+    if (themeDropdownOpen_) {
+        int dropdownY = selectorY + itemHeight + 2;
+        for (int i = 0; i < colors::themes::NUM_THEMES; ++i) {
+            int itemY = dropdownY + 2 + i * itemHeight;
+            if (over(gl::Rectangle(static_cast<float>(selectorX), static_cast<float>(itemY),
+                                   static_cast<float>(selectorWidth), static_cast<float>(itemHeight)))) {
+                return 8 + i;
+            }
+        }
+    }
+    return -1;
+}
+
 void PluginEditor::handleMouseDown(int x, int y) {
     mouseDown_ = true;
     
+    // Channel badge
+    if (x >= channelBadge_.x && x < channelBadge_.x + channelBadge_.width &&
+        y >= channelBadge_.y && y < channelBadge_.y + channelBadge_.height) {
+        cycleChannelView();
+        return;
+    }
+    
+    // View badge
+    if (x >= viewBadge_.x && x < viewBadge_.x + viewBadge_.width &&
+        y >= viewBadge_.y && y < viewBadge_.y + viewBadge_.height) {
+        toggleView();
+        return;
+    }
+    
     // Theme dropdown handling
     int selectorX = 10;
     int selectorY = 8;
@@ -925,6 +1217,8 @@ void PluginEditor::handleMouseDown(int x, int y) {
                 // Select this theme
                 themeIndex_ = i;
                 theme_ = ColorTheme::byIndex(themeIndex_);
+                renderer_.invalidateStaticLayer();
+                spectrogramRecolor_ = true;
                 themeDropdownOpen_ = false;
                 return;
             }
@@ -1050,6 +1344,8 @@ void PluginEditor::syncParametersFromController() {
 }
 
 void PluginEditor::onParameterChange(Steinberg::Vst::ParamID id, double normalizedValue) {
+    invalidate();
+    
     // Handle parameter changes from host/automation
     float logFreqMin = std::log10(20.0f);
     float logFreqMax = std::log10(20000.0f);
@@ -1085,6 +1381,12 @@ void PluginEditor::onParameterChange(Steinberg::Vst::ParamID id, double normaliz
     }
 }
 
+void PluginEditor::sendAnalysisSettings() {
+    if (controller_) {
+        controller_->sendAnalysisSettings(hopSize_, !analyzeWhenClosed_);
+    }
+}
+
 void PluginEditor::loadSettings() {
 #ifdef _WIN32
     HKEY hKey;
@@ -1108,6 +1410,24 @@ void PluginEditor::loadSettings() {
             themeIndex_ = static_cast<int>(value) % colors::themes::NUM_THEMES;
         }
         
+        size = sizeof(DWORD);
+        if (RegQueryValueExW(hKey, REG_VSYNC, nullptr, nullptr,
+                             reinterpret_cast<LPBYTE>(&value), &size) == ERROR_SUCCESS) {
+            vsync_ = value != 0;
+        }
+        
+        size = sizeof(DWORD);
+        if (RegQueryValueExW(hKey, REG_HOP_SIZE, nullptr, nullptr,
+                             reinterpret_cast<LPBYTE>(&value), &size) == ERROR_SUCCESS) {
+            hopSize_ = static_cast<int>(value);
+        }
+        
+        size = sizeof(DWORD);
+        if (RegQueryValueExW(hKey, REG_ANALYZE_CLOSED, nullptr, nullptr,
+                             reinterpret_cast<LPBYTE>(&value), &size) == ERROR_SUCCESS) {
+            analyzeWhenClosed_ = value != 0;
+        }
+        
         RegCloseKey(hKey);
         settingsLoaded_ = true;
     }
@@ -1115,6 +1435,9 @@ void PluginEditor::loadSettings() {
     // Enforce minimum size
     if (width_ < 600) width_ = 800;
     if (height_ < 350) height_ = 450;
+    
+    // Hop sizes the 'H' key cycles through
+    if (hopSize_ < 256 || hopSize_ > 2048 || (hopSize_ & (hopSize_ - 1)) != 0) hopSize_ = 1024;
 #endif
 }
 
@@ -1140,6 +1463,18 @@ void PluginEditor::saveSettings() {
         RegSetValueExW(hKey, REG_THEME_INDEX, 0, REG_DWORD,
                        reinterpret_cast<const BYTE*>(&value), sizeof(DWORD));
         
+        value = vsync_ ? 1 : 0;
+        RegSetValueExW(hKey, REG_VSYNC, 0, REG_DWORD,
+                       reinterpret_cast<const BYTE*>(&value), sizeof(DWORD));
+        
+        value = static_cast<DWORD>(hopSize_);
+        RegSetValueExW(hKey, REG_HOP_SIZE, 0, REG_DWORD,
+                       reinterpret_cast<const BYTE*>(&value), sizeof(DWORD));
+        
+        value = analyzeWhenClosed_ ? 1 : 0;
+        RegSetValueExW(hKey, REG_ANALYZE_CLOSED, 0, REG_DWORD,
+                       reinterpret_cast<const BYTE*>(&value), sizeof(DWORD));
+        
         RegCloseKey(hKey);
     }
 #endif
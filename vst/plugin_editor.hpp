@@ -10,8 +10,12 @@
 #include "pluginterfaces/vst/vsttypes.h"
 #include "gl_renderer.hpp"
 #include "eq_processor.hpp"
+#include "eq_response.hpp"
 #include "fft.hpp"
 #include "shared_colors.hpp"
+#include "shared_data.hpp"
+#include <array>
+#include <cstdint>
 #include <vector>
 #include <mutex>
 #include <atomic>
@@ -103,7 +107,7 @@ public:
     Steinberg::uint32 PLUGIN_API release() override;
     Steinberg::tresult PLUGIN_API queryInterface(const Steinberg::TUID iid, void** obj) override;
     
-    // Spectrum data update (called from processor)
+    // Spectrum data update (display band levels in dB of the viewed channel)
     void updateSpectrum(const std::vector<float>& spectrum);
     
     // EQ parameter update (called from controller for automation)
@@ -125,11 +129,29 @@ private:
     
     // Rendering
     void render();
+    
+    // Repaint scheduling: the timer only polls; a frame is drawn when a new
+    // spectrum arrived, something was invalidated (input, parameters, theme,
+    // resize) or peak hold is still falling. Hidden editors draw nothing.
+    void onTick();
+    void invalidate() { needsRepaint_ = true; }
+    bool isShowing() const;
+    void setTimerInterval(UINT interval);
+    int hoverTarget() const;
+    void applySwapInterval();
     void renderSpectrum();
     void renderEQControls();
     void renderEQCurve();
     void renderGrid();
     void renderThemeSelector();
+    void renderChannelBadge(float rightEdge);
+    void cycleChannelView();
+    void renderViewBadge(float rightEdge);
+    void toggleView();
+    void updateSpectrogram();
+    void recolorSpectrogram();
+    void renderSpectrogram();
+    void renderPerfOverlay();
     
     // Input handling
     void handleMouseMove(int x, int y);
@@ -143,6 +165,7 @@ private:
     // Settings persistence (registry)
     void loadSettings();
     void saveSettings();
+    void sendAnalysisSettings();
     
     // Utilities
     gl::Color getBarColor(float normalizedFreq, float magnitude) const;
@@ -173,16 +196,37 @@ private:
     int height_ = 720;
     bool settingsLoaded_ = false;
     
-    // Spectrum data
+    // Spectrum data (display band levels in dB of channelView_)
+    SpectrumChannel channelView_ = SpectrumChannel::Mid;
+    gl::Rectangle channelBadge_;
     std::vector<float> spectrum_;
     std::vector<float> peakHold_;
     std::vector<float> peakDecay_;
     std::mutex spectrumMutex_;
     
+    // Main view: live spectrum or scrolling spectrogram ('S' or badge toggles)
+    enum class View { Spectrum, Spectrogram };
+    View view_ = View::Spectrum;
+    gl::Rectangle viewBadge_;
+    
+    // Spectrogram history: ring texture with one row per spectrum frame.
+    // A new frame uploads a single row; drawing wraps the texture
+    // coordinates past the write row, so scrolling costs nothing. Rows are
+    // kept as levels too, so a theme change recolors the history at once.
+    static constexpr int kSpectrogramRows = 512;
+    gl::Texture spectrogram_;
+    std::vector<uint8_t> spectrogramLevels_;        // kSpectrogramRows x numBands, 0..255 over -60..0 dB
+    std::vector<gl::Color> spectrogramPixels_;      // Upload staging (a row or the whole ring)
+    std::array<gl::Color, 256> spectrogramPalette_{};
+    int spectrogramHead_ = 0;           // Next row to write
+    bool spectrogramRecolor_ = true;    // Palette is stale (theme changed)
+    
     // EQ controls
     EQControl eqControls_[5];
     int draggedBand_ = -1;
     bool eqEnabled_ = true;
+    eq::ResponseCache eqResponse_;
+    double processorSampleRate_ = 44100.0;  // From the latest spectrum frame
     
     // Mouse state
     int mouseX_ = 0;
@@ -192,8 +236,31 @@ private:
     
     // Animation
     UINT_PTR timerId_ = 0;
+    UINT timerInterval_ = 0;
     static constexpr int TIMER_ID = 1;
-    static constexpr int FRAME_INTERVAL = 16; // ~60 FPS
+    static constexpr int FRAME_INTERVAL = 16;   // Repaint poll while visible (~60 Hz)
+    static constexpr int HIDDEN_INTERVAL = 250; // Visibility check while hidden
+    
+    std::atomic<bool> needsRepaint_{true};      // Set from host callbacks too
+    bool peaksFalling_ = false;                 // Peak hold above the spectrum
+    int hoverTarget_ = -1;                      // What the mouse is over (hoverTarget())
+    ULONGLONG lastRenderTime_ = 0;              // GetTickCount64() of the last frame
+    float frameStep_ = 1.0f;                    // Last frame length in 60 Hz frames
+    
+    // Performance overlay (F3); stage timings refresh once a second
+    bool showPerf_ = false;
+    
+    // Processor analysis scheduling, saved with the settings and sent on
+    // open and close: 'H' cycles the hop (256..2048 samples), 'A' keeps
+    // analyzing while the editor is closed
+    int hopSize_ = 1024;
+    bool analyzeWhenClosed_ = false;
+    
+    // Vsync ('V' toggles, saved with the settings). Off by default: with
+    // several editors on the host's UI thread, blocking swaps would add up.
+    bool vsync_ = false;
+    using SwapIntervalProc = BOOL (WINAPI*)(int);
+    SwapIntervalProc swapInterval_ = nullptr;   // WGL_EXT_swap_control, may be null
 };
 
 } // namespace SpectrumEQ
@@ -37,6 +37,11 @@ enum ParamID : Steinberg::Vst::ParamID {
     kNumParams
 };
 
+// Processor <-> controller message IDs (IConnectionPoint)
+constexpr const char* kMsgEditorState = "EditorState";          // attr "open": 0/1
+constexpr const char* kMsgAnalysisSettings = "AnalysisSettings"; // attrs "hopSize", "skipWhenClosed"
+constexpr const char* kMsgSpectrumPublisher = "SpectrumPublisher"; // attr "address" (0 = gone)
+
 // Helper to get param IDs for a band
 inline Steinberg::Vst::ParamID getBandGainParam(int band) { return static_cast<Steinberg::Vst::ParamID>(kBand1Gain + band * 3); }
 inline Steinberg::Vst::ParamID getBandFreqParam(int band) { return static_cast<Steinberg::Vst::ParamID>(kBand1Freq + band * 3); }
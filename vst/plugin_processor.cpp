@@ -1,16 +1,15 @@
 #include "plugin_processor.hpp"
 #include "plugin_ids.hpp"
-#include "shared_data.hpp"
+#include "realtime_guard.hpp"
+#include "perf_stats.hpp"
 #include "pluginterfaces/vst/ivstparameterchanges.h"
 #include "base/source/fstreamer.h"
+#include <algorithm>
 
 namespace SpectrumEQ {
 
 PluginProcessor::PluginProcessor() {
     setControllerClass(kControllerUID);
-    
-    inputBuffer_.resize(kFFTSize, 0.0f);
-    spectrum_.resize(kFFTSize / 2, 0.0f);
 }
 
 PluginProcessor::~PluginProcessor() = default;
@@ -29,14 +28,68 @@ Steinberg::tresult PLUGIN_API PluginProcessor::initialize(Steinberg::FUnknown* c
 }
 
 Steinberg::tresult PLUGIN_API PluginProcessor::terminate() {
+    worker_.stop();
     return AudioEffect::terminate();
 }
 
+void PluginProcessor::allocateAnalysisBuffers() {
+    sampleQueue_.reset(kSampleQueueSize);
+    frameScratch_.assign(kFFTSize, StereoSample{0.0f, 0.0f});
+    drainBuffer_.assign(kFFTSize, StereoSample{0.0f, 0.0f});
+    drainLeft_.assign(kFFTSize, 0.0f);
+    drainRight_.assign(kFFTSize, 0.0f);
+    inputLeft_.reset(kFFTSize);
+    inputRight_.reset(kFFTSize);
+    for (std::vector<float>& power : binPower_) {
+        power.assign(kFFTSize / 2, 0.0f);
+    }
+    spectrum_.assign(kDisplayBands * kNumSpectrumChannels, kDisplayFloorDb);
+    fftPacked_.assign(kFFTSize, fft::Complex(0.0, 0.0));
+    window_ = fft::cachedWindow(fft::WindowType::Hann, kFFTSize);
+    samplesSinceAnalysis_ = 0;
+    publishedSilence_ = false;
+    buildDisplayBands();
+}
+
+void PluginProcessor::buildDisplayBands() {
+    double binWidth = sampleRate_ / kFFTSize;
+    int lastBin = static_cast<int>(kFFTSize / 2) - 1;
+    double logMin = std::log10(kDisplayMinFreq);
+    double logRange = std::log10(kDisplayMaxFreq) - logMin;
+    
+    displayFirstBin_.resize(kDisplayBands);
+    displayEndBin_.resize(kDisplayBands);
+    displayScale_.resize(kDisplayBands);
+    
+    for (size_t band = 0; band < kDisplayBands; ++band) {
+        double t = static_cast<double>(band) / (kDisplayBands - 1);
+        double freq = std::pow(10.0, logMin + t * logRange);
+        
+        // Average nearby bins, more of them at higher frequencies
+        int bin = std::clamp(static_cast<int>(freq / binWidth), 0, lastBin);
+        int smoothRange = (std::max)(1, bin / 8);
+        int first = (std::max)(bin - smoothRange, 0);
+        int last = (std::min)(bin + smoothRange, lastBin);
+        
+        // Slope compensation (+4.5 dB per octave from 1 kHz) balances the
+        // natural pink noise tilt of music, like professional analyzers
+        double slopeDb = std::log2(freq / 1000.0) * 4.5;
+        
+        displayFirstBin_[band] = static_cast<uint32_t>(first);
+        displayEndBin_[band] = static_cast<uint32_t>(last + 1);
+        displayScale_[band] = static_cast<float>(std::pow(10.0, slopeDb / 10.0) / (last - first + 1));
+    }
+}
+
 Steinberg::tresult PLUGIN_API PluginProcessor::setActive(Steinberg::TBool state) {
     if (state) {
+        // Processing is stopped here, so the ring can be reset safely
+        worker_.stop();
+        allocateAnalysisBuffers();
         eq_.reset();
-        std::fill(inputBuffer_.begin(), inputBuffer_.end(), 0.0f);
-        inputBufferPos_ = 0;
+        worker_.start([this] { analyzeQueuedSamples(); });
+    } else {
+        worker_.stop();
     }
     return AudioEffect::setActive(state);
 }
@@ -55,8 +108,11 @@ Steinberg::tresult PLUGIN_API PluginProcessor::canProcessSampleSize(Steinberg::i
     return Steinberg::kResultFalse;
 }
 
-void PluginProcessor::processParameterChanges(Steinberg::Vst::IParameterChanges* paramChanges) {
+void PluginProcessor::collectParameterChanges(Steinberg::Vst::IParameterChanges* paramChanges) {
+    numParamEvents_ = 0;
     if (!paramChanges) return;
+    
+    bool overflowed = false;
 
     Steinberg::int32 numParamsChanged = paramChanges->getParameterCount();
     for (Steinberg::int32 i = 0; i < numParamsChanged; ++i) {
@@ -65,143 +121,364 @@ void PluginProcessor::processParameterChanges(Steinberg::Vst::IParameterChanges*
 
         Steinberg::Vst::ParamID paramId = paramQueue->getParameterId();
         Steinberg::int32 numPoints = paramQueue->getPointCount();
+        if (numPoints <= 0) continue;
+        
+        // If every point doesn't fit, keep at least the final value
+        Steinberg::int32 first = 0;
+        if (numPoints > kMaxParamEvents - numParamEvents_) {
+            first = numPoints - 1;
+        }
         
-        if (numPoints > 0) {
-            Steinberg::int32 sampleOffset;
-            Steinberg::Vst::ParamValue value;
+        for (Steinberg::int32 p = first; p < numPoints; ++p) {
+            ParamEvent event;
+            if (paramQueue->getPoint(p, event.sampleOffset, event.value) != Steinberg::kResultTrue) {
+                continue;
+            }
+            event.id = paramId;
+            event.order = numParamEvents_;
             
-            // Get the last value
-            if (paramQueue->getPoint(numPoints - 1, sampleOffset, value) == Steinberg::kResultTrue) {
-                // Handle parameter based on ID
-                if (paramId == kBypass) {
-                    eq_.setBypass(value > 0.5);
-                } else {
-                    // Determine which band and parameter type
-                    int band = paramId / 3;
-                    int paramType = paramId % 3;
-                    
-                    if (band < eq::NUM_BANDS) {
-                        switch (paramType) {
-                            case 0: // Gain
-                                eq_.setBandGain(band, eq::MIN_GAIN + value * (eq::MAX_GAIN - eq::MIN_GAIN));
-                                break;
-                            case 1: // Frequency (logarithmic)
-                                {
-                                    double logMin = std::log10(eq::MIN_FREQ);
-                                    double logMax = std::log10(eq::MAX_FREQ);
-                                    double freq = std::pow(10.0, logMin + value * (logMax - logMin));
-                                    eq_.setBandFrequency(band, freq);
-                                }
-                                break;
-                            case 2: // Q (logarithmic)
-                                {
-                                    double logMin = std::log10(eq::MIN_Q);
-                                    double logMax = std::log10(eq::MAX_Q);
-                                    double q = std::pow(10.0, logMin + value * (logMax - logMin));
-                                    eq_.setBandQ(band, q);
-                                }
-                                break;
-                        }
-                    }
-                }
+            if (numParamEvents_ < kMaxParamEvents) {
+                paramEvents_[numParamEvents_++] = event;
+            } else {
+                // Out of room entirely: apply at block start
+                applyParameterEvent(event);
+                overflowed = true;
             }
         }
     }
+    
+    // Commit those now, before the first sub-block runs
+    if (overflowed) {
+        commitBandChanges();
+    }
+    
+    // Order by offset, then arrival (std::sort never allocates, unlike
+    // std::stable_sort, so the tie-break keeps it deterministic instead)
+    std::sort(paramEvents_.begin(), paramEvents_.begin() + numParamEvents_,
+              [](const ParamEvent& a, const ParamEvent& b) {
+                  if (a.sampleOffset != b.sampleOffset) return a.sampleOffset < b.sampleOffset;
+                  return a.order < b.order;
+              });
 }
 
-Steinberg::tresult PLUGIN_API PluginProcessor::process(Steinberg::Vst::ProcessData& data) {
-    // Process parameter changes
-    processParameterChanges(data.inputParameterChanges);
+void PluginProcessor::applyParameterEvent(const ParamEvent& event) {
+    if (event.id == kBypass) {
+        eq_.setBypass(event.value > 0.5);
+        return;
+    }
+    
+    // Determine which band and parameter type
+    int band = static_cast<int>(event.id / 3);
+    int paramType = static_cast<int>(event.id % 3);
+    if (band >= eq::NUM_BANDS) return;
+    
+    PendingBand& pending = pendingBands_[band];
+    if (!pending.dirty) {
+        pending.gain = eq_.getBandGain(band);
+        pending.frequency = eq_.getBandFrequency(band);
+        pending.q = eq_.getBandQ(band);
+        pending.dirty = true;
+    }
+    
+    switch (paramType) {
+        case 0: // Gain
+            pending.gain = eq::MIN_GAIN + event.value * (eq::MAX_GAIN - eq::MIN_GAIN);
+            break;
+        case 1: // Frequency (logarithmic)
+            {
+                double logMin = std::log10(eq::MIN_FREQ);
+                double logMax = std::log10(eq::MAX_FREQ);
+                pending.frequency = std::pow(10.0, logMin + event.value * (logMax - logMin));
+            }
+            break;
+        case 2: // Q (logarithmic)
+            {
+                double logMin = std::log10(eq::MIN_Q);
+                double logMax = std::log10(eq::MAX_Q);
+                pending.q = std::pow(10.0, logMin + event.value * (logMax - logMin));
+            }
+            break;
+    }
+}
 
-    // Check for valid audio
-    if (data.numInputs == 0 || data.numOutputs == 0) {
-        return Steinberg::kResultOk;
+void PluginProcessor::applyAllParameterEvents() {
+    // No audio to split: just land on the final values
+    for (int e = 0; e < numParamEvents_; ++e) {
+        applyParameterEvent(paramEvents_[e]);
+    }
+    commitBandChanges();
+}
+
+void PluginProcessor::commitBandChanges() {
+    // One coefficient design per touched band, however many of its
+    // parameters moved at this offset
+    for (int band = 0; band < eq::NUM_BANDS; ++band) {
+        PendingBand& pending = pendingBands_[band];
+        if (pending.dirty) {
+            eq_.setBand(band, pending.gain, pending.frequency, pending.q);
+            pending.dirty = false;
+        }
     }
+}
+
+template <typename Sample>
+void PluginProcessor::processSubBlock(Sample** in, Sample** out, Steinberg::int32 numChannels,
+                                      Steinberg::int32 offset, Steinberg::int32 count) {
+    if (count <= 0) return;
+    
+    perf::ScopedTimer timer(perf::Stage::Equalizer);
+    
+    // Block cascade, both channels in one SIMD lane pair. Coefficient
+    // changes committed before this call start ramping at its first frame
+    // (eq::EQProcessor::kRampFrames long, carried into later sub-blocks).
+    // in == out is fine: each chunk is read before it is written.
+    if (numChannels >= 2) {
+        eq_.processStereo(in[0] + offset, in[1] + offset, out[0] + offset, out[1] + offset, count);
+    } else if (numChannels == 1) {
+        eq_.processMono(in[0] + offset, out[0] + offset, count);
+    }
+}
 
+template <typename Sample>
+void PluginProcessor::queueForAnalysis(Sample** out, Steinberg::int32 numChannels,
+                                       Steinberg::int32 numSamples) {
+    // Queue stereo frames for the analysis worker (drops samples when full,
+    // never blocks). Scratch is fixed-size, so long host blocks go in chunks.
+    for (Steinberg::int32 offset = 0; offset < numSamples; ) {
+        Steinberg::int32 count = (std::min)(numSamples - offset,
+                                            static_cast<Steinberg::int32>(frameScratch_.size()));
+        const Sample* left = out[0] + offset;
+        const Sample* right = (numChannels >= 2 ? out[1] : out[0]) + offset;
+        for (Steinberg::int32 i = 0; i < count; ++i) {
+            frameScratch_[i] = StereoSample{static_cast<float>(left[i]), static_cast<float>(right[i])};
+        }
+        sampleQueue_.write(frameScratch_.data(), static_cast<size_t>(count));
+        offset += count;
+    }
+}
+
+template <typename Sample>
+void PluginProcessor::processAudio(Steinberg::Vst::ProcessData& data, Sample** in, Sample** out) {
     Steinberg::int32 numChannels = data.inputs[0].numChannels;
     Steinberg::int32 numSamples = data.numSamples;
 
-    // Get audio buffers
-    float** in = data.inputs[0].channelBuffers32;
-    float** out = data.outputs[0].channelBuffers32;
-
     // Check for silence flags
     if (data.inputs[0].silenceFlags != 0) {
+        applyAllParameterEvents();
+        
         data.outputs[0].silenceFlags = data.inputs[0].silenceFlags;
         for (Steinberg::int32 ch = 0; ch < numChannels; ++ch) {
             if (in[ch] != out[ch]) {
-                memset(out[ch], 0, numSamples * sizeof(float));
+                memset(out[ch], 0, numSamples * sizeof(Sample));
             }
         }
+        return;
+    }
+
+    // Split the block at automation offsets so each change lands on its
+    // sample; all points sharing an offset are committed together
+    Steinberg::int32 position = 0;
+    for (int e = 0; e < numParamEvents_; ) {
+        Steinberg::int32 offset = std::clamp(paramEvents_[e].sampleOffset, position, numSamples);
+        processSubBlock(in, out, numChannels, position, offset - position);
+        position = offset;
+        
+        do {
+            applyParameterEvent(paramEvents_[e]);
+            ++e;
+        } while (e < numParamEvents_ && paramEvents_[e].sampleOffset <= position);
+        commitBandChanges();
+    }
+    processSubBlock(in, out, numChannels, position, numSamples - position);
+
+    // Nothing reads the spectrum while the editor is closed
+    bool analyze = editorOpen_.load(std::memory_order_relaxed) ||
+                   !skipAnalysisWhenClosed_.load(std::memory_order_relaxed);
+    if (analyze && numChannels > 0) {
+        queueForAnalysis(out, numChannels, numSamples);
+    }
+
+    data.outputs[0].silenceFlags = 0;
+}
+
+Steinberg::tresult PLUGIN_API PluginProcessor::process(Steinberg::Vst::ProcessData& data) {
+    // Debug builds assert on any heap allocation from here on
+    rt::ScopedNoAllocation noAllocation;
+    perf::ScopedTimer timer(perf::Stage::Process);
+    perf::setAudioPeriod(static_cast<uint64_t>((std::max)(data.numSamples, 0)), sampleRate_);
+    
+    // Gather automation points, sorted by sample offset
+    collectParameterChanges(data.inputParameterChanges);
+
+    // Check for valid audio
+    if (data.numInputs == 0 || data.numOutputs == 0) {
+        applyAllParameterEvents();
         return Steinberg::kResultOk;
     }
 
-    // Process audio
-    if (numChannels >= 2) {
-        // Stereo processing
-        for (Steinberg::int32 i = 0; i < numSamples; ++i) {
-            float left = in[0][i];
-            float right = in[1][i];
-            
-            // Apply EQ
-            eq_.process(left, right);
-            
-            out[0][i] = left;
-            out[1][i] = right;
-            
-            // Fill spectrum buffer (mono mix)
-            inputBuffer_[inputBufferPos_] = (left + right) * 0.5f;
-            inputBufferPos_ = (inputBufferPos_ + 1) % kFFTSize;
-        }
-    } else if (numChannels == 1) {
-        // Mono processing
-        for (Steinberg::int32 i = 0; i < numSamples; ++i) {
-            float sample = in[0][i];
-            sample = eq_.processMono(sample);
-            out[0][i] = sample;
-            
-            inputBuffer_[inputBufferPos_] = sample;
-            inputBufferPos_ = (inputBufferPos_ + 1) % kFFTSize;
-        }
+    // Native double path when the host runs 64-bit, no conversion pass
+    if (data.symbolicSampleSize == Steinberg::Vst::kSample64) {
+        processAudio(data, data.inputs[0].channelBuffers64, data.outputs[0].channelBuffers64);
+    } else {
+        processAudio(data, data.inputs[0].channelBuffers32, data.outputs[0].channelBuffers32);
     }
 
-    // Compute spectrum periodically (every buffer)
-    {
-        std::lock_guard<std::mutex> lock(spectrumMutex_);
-        
-        // Simple magnitude calculation for visualization
-        // (In a real implementation, you'd use the FFT class)
-        static fft::ComplexVector fftData(kFFTSize);
-        static std::vector<double> tempBuffer(kFFTSize);
+    return Steinberg::kResultOk;
+}
+
+void PluginProcessor::analyzeQueuedSamples() {
+    size_t hopSize = hopSize_.load(std::memory_order_relaxed);
+    
+    // Drain one hop at a time into the history
+    for (;;) {
+        size_t wanted = hopSize - (std::min)(samplesSinceAnalysis_, hopSize - 1);
+        wanted = (std::min)(wanted, drainBuffer_.size());
+        size_t count = sampleQueue_.read(drainBuffer_.data(), wanted);
+        if (count == 0) break;
         
-        // Copy with windowing
-        for (size_t i = 0; i < kFFTSize; ++i) {
-            size_t idx = (inputBufferPos_ + i) % kFFTSize;
-            double window = 0.5 * (1.0 - std::cos(2.0 * M_PI * i / (kFFTSize - 1)));
-            tempBuffer[i] = inputBuffer_[idx] * window;
+        for (size_t i = 0; i < count; ++i) {
+            drainLeft_[i] = drainBuffer_[i].left;
+            drainRight_[i] = drainBuffer_[i].right;
         }
+        inputLeft_.write(drainLeft_.data(), count);
+        inputRight_.write(drainRight_.data(), count);
+        samplesSinceAnalysis_ += count;
         
-        // Convert to complex and compute FFT using the shared fft namespace
-        auto complexSpectrum = fft::transform(tempBuffer);
-        auto magnitudes = fft::magnitude(complexSpectrum);
-        
-        // Copy to spectrum buffer (normalize)
-        double normFactor = 2.0 / kFFTSize;
-        for (size_t i = 0; i < kFFTSize / 2; ++i) {
-            spectrum_[i] = static_cast<float>(magnitudes[i] * normFactor);
+        if (samplesSinceAnalysis_ >= hopSize) {
+            samplesSinceAnalysis_ = 0;
+            
+            // The published spectrum carries no state between frames, so if
+            // the worker fell behind only the newest complete hop needs an FFT
+            if (sampleQueue_.readAvailable() < hopSize) {
+                computeSpectrum();
+            }
         }
-        
-        // Update shared buffer for editor
-        SharedSpectrumData::instance().setSpectrum(spectrum_);
     }
+}
 
-    data.outputs[0].silenceFlags = 0;
-    return Steinberg::kResultOk;
+void PluginProcessor::computeSpectrum() {
+    perf::ScopedTimer timer(perf::Stage::Analysis);
+    uint64_t start = perf::nowNs();
+    
+    constexpr size_t L = static_cast<size_t>(SpectrumChannel::Left);
+    constexpr size_t R = static_cast<size_t>(SpectrumChannel::Right);
+    constexpr size_t M = static_cast<size_t>(SpectrumChannel::Mid);
+    constexpr size_t S = static_cast<size_t>(SpectrumChannel::Side);
+    
+    // Unwrap the history oldest first with the cached window applied: left
+    // in the real part, right in the imaginary part, so one complex FFT
+    // yields both channels
+    const double* window = window_->coefficients.data();
+    rt::HistoryRing<float>::Runs left = inputLeft_.latest(kFFTSize);
+    rt::HistoryRing<float>::Runs right = inputRight_.latest(kFFTSize);
+    for (size_t i = 0; i < left.firstCount; ++i) {
+        fftPacked_[i] = fft::Complex(left.first[i] * window[i], right.first[i] * window[i]);
+    }
+    fft::Complex* packed = fftPacked_.data() + left.firstCount;
+    window += left.firstCount;
+    for (size_t i = 0; i < left.secondCount; ++i) {
+        packed[i] = fft::Complex(left.second[i] * window[i], right.second[i] * window[i]);
+    }
+    fftPlan_.forward(fftPacked_.data());
+    
+    // Untangle: L[k] = (Z[k] + conj(Z[N-k])) / 2, R[k] = (Z[k] - conj(Z[N-k])) / 2i.
+    // Mid and side follow by linearity. Normalized power (2/N amplitude,
+    // squared; no square roots) for every channel in the same pass.
+    double normFactor = 2.0 / kFFTSize;
+    double powerScale = normFactor * normFactor;
+    for (size_t k = 0; k < kFFTSize / 2; ++k) {
+        const fft::Complex& z = fftPacked_[k];
+        fft::Complex mirror = std::conj(fftPacked_[k == 0 ? 0 : kFFTSize - k]);
+        fft::Complex left = 0.5 * (z + mirror);
+        fft::Complex right = fft::Complex(0.0, -0.5) * (z - mirror);
+        fft::Complex mid = 0.5 * (left + right);
+        fft::Complex side = 0.5 * (left - right);
+        binPower_[L][k] = static_cast<float>(std::norm(left) * powerScale);
+        binPower_[R][k] = static_cast<float>(std::norm(right) * powerScale);
+        binPower_[M][k] = static_cast<float>(std::norm(mid) * powerScale);
+        binPower_[S][k] = static_cast<float>(std::norm(side) * powerScale);
+    }
+    
+    uint64_t fftEnd = perf::nowNs();
+    perf::record(perf::Stage::Fft, fftEnd - start);
+    
+    // Average into display bands, then convert to dB in one vector pass
+    for (size_t channel = 0; channel < kNumSpectrumChannels; ++channel) {
+        const float* power = binPower_[channel].data();
+        float* bands = spectrum_.data() + channel * kDisplayBands;
+        for (size_t band = 0; band < kDisplayBands; ++band) {
+            float sum = 0.0f;
+            for (uint32_t bin = displayFirstBin_[band]; bin < displayEndBin_[band]; ++bin) {
+                sum += power[bin];
+            }
+            bands[band] = sum * displayScale_[band];
+        }
+    }
+    fft::powerToDb(spectrum_.data(), spectrum_.size(), kDisplayFloorDb, spectrum_.data());
+    perf::record(perf::Stage::Banding, perf::nowNs() - fftEnd);
+    
+    // A stopped transport often still streams digital silence; one silent
+    // frame is enough, after which the editor has nothing new to repaint
+    bool silent = std::all_of(spectrum_.begin(), spectrum_.end(),
+                              [](float db) { return db <= kDisplayFloorDb; });
+    if (silent && publishedSilence_) return;
+    publishedSilence_ = silent;
+    
+    // Hand off to this instance's editor
+    publisher_.publish(spectrum_.data(), kDisplayBands, sampleRate_);
 }
 
-std::vector<float> PluginProcessor::getSpectrum() {
-    std::lock_guard<std::mutex> lock(spectrumMutex_);
-    return spectrum_;
+void PluginProcessor::sendPublisherAddress(SpectrumPublisher* publisher) {
+    Steinberg::IPtr<Steinberg::Vst::IMessage> message = Steinberg::owned(allocateMessage());
+    if (!message) return;
+    
+    // Only meaningful when processor and controller share a process, which
+    // is the case for every host that connects them directly
+    message->setMessageID(kMsgSpectrumPublisher);
+    message->getAttributes()->setInt("address",
+        static_cast<Steinberg::int64>(reinterpret_cast<intptr_t>(publisher)));
+    sendMessage(message);
+}
+
+Steinberg::tresult PLUGIN_API PluginProcessor::connect(Steinberg::Vst::IConnectionPoint* other) {
+    Steinberg::tresult result = AudioEffect::connect(other);
+    if (result == Steinberg::kResultTrue) {
+        sendPublisherAddress(&publisher_);
+    }
+    return result;
+}
+
+Steinberg::tresult PLUGIN_API PluginProcessor::disconnect(Steinberg::Vst::IConnectionPoint* other) {
+    // Tell the controller to drop the pointer while the peer is still known
+    sendPublisherAddress(nullptr);
+    return AudioEffect::disconnect(other);
+}
+
+Steinberg::tresult PLUGIN_API PluginProcessor::notify(Steinberg::Vst::IMessage* message) {
+    if (!message) return Steinberg::kInvalidArgument;
+    
+    Steinberg::Vst::IAttributeList* attributes = message->getAttributes();
+    
+    if (Steinberg::FIDStringsEqual(message->getMessageID(), kMsgEditorState)) {
+        Steinberg::int64 open = 0;
+        if (attributes && attributes->getInt("open", open) == Steinberg::kResultOk) {
+            editorOpen_.store(open != 0);
+        }
+        return Steinberg::kResultOk;
+    }
+    
+    if (Steinberg::FIDStringsEqual(message->getMessageID(), kMsgAnalysisSettings)) {
+        Steinberg::int64 value = 0;
+        if (attributes && attributes->getInt("hopSize", value) == Steinberg::kResultOk) {
+            hopSize_.store(static_cast<size_t>(std::clamp<Steinberg::int64>(value, 32, kFFTSize)));
+        }
+        if (attributes && attributes->getInt("skipWhenClosed", value) == Steinberg::kResultOk) {
+            skipAnalysisWhenClosed_.store(value != 0);
+        }
+        return Steinberg::kResultOk;
+    }
+    
+    return AudioEffect::notify(message);
 }
 
 Steinberg::tresult PLUGIN_API PluginProcessor::setState(Steinberg::IBStream* state) {
@@ -3,8 +3,14 @@
 #include "public.sdk/source/vst/vstaudioeffect.h"
 #include "eq_processor.hpp"
 #include "fft.hpp"
+#include "spsc_ring.hpp"
+#include "history_ring.hpp"
+#include "analysis_worker.hpp"
+#include "shared_data.hpp"
 #include <vector>
-#include <mutex>
+#include <array>
+#include <atomic>
+#include <memory>
 
 namespace SpectrumEQ {
 
@@ -31,24 +37,111 @@ public:
     Steinberg::tresult PLUGIN_API canProcessSampleSize(Steinberg::int32 symbolicSampleSize) override;
     Steinberg::tresult PLUGIN_API setState(Steinberg::IBStream* state) override;
     Steinberg::tresult PLUGIN_API getState(Steinberg::IBStream* state) override;
-
-    // Get spectrum data for visualization (thread-safe)
-    std::vector<float> getSpectrum();
+    
+    // IConnectionPoint (editor visibility / analysis settings from controller,
+    // spectrum publisher address to the controller)
+    Steinberg::tresult PLUGIN_API connect(Steinberg::Vst::IConnectionPoint* other) override;
+    Steinberg::tresult PLUGIN_API disconnect(Steinberg::Vst::IConnectionPoint* other) override;
+    Steinberg::tresult PLUGIN_API notify(Steinberg::Vst::IMessage* message) override;
     
     // Get EQ processor for UI
     const eq::EQProcessor& getEQ() const { return eq_; }
 
 protected:
-    void processParameterChanges(Steinberg::Vst::IParameterChanges* paramChanges);
+    // Automation point from the host (normalized value)
+    struct ParamEvent {
+        Steinberg::int32 sampleOffset;
+        Steinberg::Vst::ParamID id;
+        Steinberg::Vst::ParamValue value;
+        int order;    // Arrival index, keeps same-offset points in queue order
+    };
+    
+    // Band parameters being assembled for one sub-block
+    struct PendingBand {
+        double gain;
+        double frequency;
+        double q;
+        bool dirty = false;
+    };
+    
+    void collectParameterChanges(Steinberg::Vst::IParameterChanges* paramChanges);
+    void applyParameterEvent(const ParamEvent& event);
+    void applyAllParameterEvents();
+    void commitBandChanges();
+    
+    // Audio path, instantiated for 32-bit and 64-bit host buffers
+    template <typename Sample>
+    void processAudio(Steinberg::Vst::ProcessData& data, Sample** in, Sample** out);
+    template <typename Sample>
+    void processSubBlock(Sample** in, Sample** out, Steinberg::int32 numChannels,
+                         Steinberg::int32 offset, Steinberg::int32 count);
+    template <typename Sample>
+    void queueForAnalysis(Sample** out, Steinberg::int32 numChannels, Steinberg::int32 numSamples);
+    void allocateAnalysisBuffers();
+    void analyzeQueuedSamples();
+    void buildDisplayBands();
+    void computeSpectrum();
+    void sendPublisherAddress(SpectrumPublisher* publisher);
     
     eq::EQProcessor eq_;
     
-    // Spectrum analysis
+    // Automation for the current block, sorted by sample offset
+    static constexpr int kMaxParamEvents = 1024;
+    std::array<ParamEvent, kMaxParamEvents> paramEvents_;
+    int numParamEvents_ = 0;
+    std::array<PendingBand, eq::NUM_BANDS> pendingBands_;
+    
+    // Spectrum analysis (buffers sized in setupProcessing, never in process)
     static constexpr size_t kFFTSize = 4096;
-    std::vector<float> inputBuffer_;
-    size_t inputBufferPos_ = 0;
-    std::vector<float> spectrum_;
-    std::mutex spectrumMutex_;
+    static constexpr size_t kDefaultHopSize = 1024;
+    static constexpr size_t kSampleQueueSize = kFFTSize * 8;
+    
+    // Audio thread -> analysis worker hand-off (stereo frames; mono input
+    // feeds both sides)
+    struct StereoSample {
+        float left;
+        float right;
+    };
+    rt::SpscRing<StereoSample> sampleQueue_;
+    std::vector<StereoSample> frameScratch_;
+    rt::AnalysisWorker worker_;
+    
+    // History and scheduling below are owned by the analysis worker:
+    // an FFT runs once the history has advanced by a hop
+    rt::HistoryRing<float> inputLeft_;
+    rt::HistoryRing<float> inputRight_;
+    std::vector<StereoSample> drainBuffer_;
+    std::vector<float> drainLeft_;
+    std::vector<float> drainRight_;
+    size_t samplesSinceAnalysis_ = 0;
+    
+    // Scheduling settings (set from notify, read by audio thread / worker)
+    std::atomic<size_t> hopSize_{kDefaultHopSize};
+    std::atomic<bool> editorOpen_{false};
+    std::atomic<bool> skipAnalysisWhenClosed_{true};
+    
+    // Display bands the editor draws (log-spaced, mapped to bins for the
+    // host sample rate when processing starts). Band b averages the power of
+    // bins [displayFirstBin_[b], displayEndBin_[b]); displayScale_ folds the
+    // 1/count and the slope compensation into one power factor.
+    static constexpr size_t kDisplayBands = 256;
+    static constexpr double kDisplayMinFreq = 20.0;
+    static constexpr double kDisplayMaxFreq = 20000.0;
+    static constexpr float kDisplayFloorDb = -120.0f;
+    std::vector<uint32_t> displayFirstBin_;
+    std::vector<uint32_t> displayEndBin_;
+    std::vector<float> displayScale_;
+    std::array<std::vector<float>, kNumSpectrumChannels> binPower_;
+    std::vector<float> spectrum_;       // Published band levels in dB, channel after channel
+    bool publishedSilence_ = false;     // Last published frame was all floor
+    
+    // Latest spectrum for this instance's editor (wait-free, no allocation)
+    SpectrumPublisher publisher_;
+    
+    // FFT plan and workspaces (per instance, allocated once)
+    fft::Plan fftPlan_{kFFTSize};
+    std::shared_ptr<const fft::WindowTable> window_;
+    fft::ComplexVector fftPacked_;      // Left + i * right, transformed in place
     
     double sampleRate_ = 44100.0;
 };
@@ -1,48 +1,79 @@
 #pragma once
 
 /**
- * Shared data between VST3 processor and editor
- * Uses a simple thread-safe buffer for spectrum data
+ * Spectrum hand-off between one VST3 processor instance and its editor
+ *
+ * Each processor owns a SpectrumPublisher. Its address reaches the
+ * controller through an IMessage when the two are connected, so instances
+ * never share data. The analysis worker writes, the editor reads; both
+ * sides are wait-free and allocation-free.
  */
 
-#include <vector>
-#include <mutex>
-#include <atomic>
+#include "triple_buffer.hpp"
+#include <array>
+#include <cstdint>
+#include <algorithm>
 
 namespace SpectrumEQ {
 
-class SharedSpectrumData {
-public:
-    static SharedSpectrumData& instance() {
-        static SharedSpectrumData instance;
-        return instance;
+/**
+ * Channels of a published spectrum (mid is the mono mix, side half the difference)
+ */
+enum class SpectrumChannel : uint32_t { Left, Right, Mid, Side };
+constexpr size_t kNumSpectrumChannels = 4;
+
+/**
+ * One published spectrum: display bands in dB per channel, ready to draw
+ * (fixed capacity). Channels are stored back to back in SpectrumChannel order.
+ */
+struct SpectrumFrame {
+    // Largest spectrum the processor publishes, per channel
+    static constexpr size_t kMaxBands = 1024;
+
+    std::array<float, kMaxBands * kNumSpectrumChannels> bandsDb{};
+    uint32_t numBands = 0;    // Bands per channel
+    double sampleRate = 0.0;  // Of the analyzed (and equalized) audio
+    uint64_t sequence = 0;    // Increments with every published frame
+
+    const float* channel(SpectrumChannel which) const {
+        return bandsDb.data() + static_cast<size_t>(which) * numBands;
     }
-    
-    void setSpectrum(const std::vector<float>& spectrum) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        spectrum_ = spectrum;
-        hasNewData_.store(true);
+};
+
+class SpectrumPublisher {
+public:
+    /**
+     * Publish a new spectrum (single producer)
+     * @param bandsDb Display band levels in dB, kNumSpectrumChannels runs of numBands
+     * @param numBands Number of bands per channel (at most kMaxBands)
+     * @param sampleRate Processor sample rate in Hz
+     */
+    void publish(const float* bandsDb, size_t numBands, double sampleRate) {
+        numBands = (std::min)(numBands, SpectrumFrame::kMaxBands);
+
+        SpectrumFrame& frame = frames_.writeBuffer();
+        std::copy(bandsDb, bandsDb + numBands * kNumSpectrumChannels, frame.bandsDb.begin());
+        frame.numBands = static_cast<uint32_t>(numBands);
+        frame.sampleRate = sampleRate;
+        frame.sequence = ++sequence_;
+        frames_.publish();
     }
-    
-    bool getSpectrum(std::vector<float>& outSpectrum) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        if (spectrum_.empty()) return false;
-        outSpectrum = spectrum_;
-        hasNewData_.store(false);
-        return true;
+
+    /**
+     * Fetch the newest frame if one arrived since the last call (single consumer)
+     * @return Newest frame, or nullptr when nothing new was published
+     */
+    const SpectrumFrame* acquire() {
+        return frames_.update() ? &frames_.readBuffer() : nullptr;
     }
-    
+
     bool hasNewData() const {
-        return hasNewData_.load();
+        return frames_.hasNewData();
     }
-    
+
 private:
-    SharedSpectrumData() = default;
-    
-    std::vector<float> spectrum_;
-    std::mutex mutex_;
-    std::atomic<bool> hasNewData_{false};
+    rt::TripleBuffer<SpectrumFrame> frames_;
+    uint64_t sequence_ = 0;
 };
 
 } // namespace SpectrumEQ
-